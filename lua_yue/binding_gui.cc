@@ -225,6 +225,7 @@ struct Type<nu::AttributedText> {
            "setfontfor", &nu::AttributedText::SetFontFor,
            "setcolor", &nu::AttributedText::SetColor,
            "setcolorfor", &nu::AttributedText::SetColorFor,
+           "setattributes", &nu::AttributedText::SetAttributes,
            "getsize", &nu::AttributedText::GetSize,
            "getboundsfor", &nu::AttributedText::GetBoundsFor,
            "getformat", &nu::AttributedText::GetFormat,
@@ -332,19 +333,31 @@ struct Type<nu::Font::Style> {
   }
 };
 
+template<>
+struct Type<nu::Font::Metrics> {
+  static constexpr const char* name = "yue.Font.Metrics";
+  static inline void Push(State* state, const nu::Font::Metrics& metrics) {
+    NewTable(state, 0, 4);
+    RawSet(state, -1, "ascent", metrics.ascent,
+                      "descent", metrics.descent,
+                      "lineheight", metrics.line_height,
+                      "averagecharwidth", metrics.average_char_width);
+  }
+};
+
 template<>
 struct Type<nu::Font> {
   static constexpr const char* name = "yue.Font";
   static void BuildMetaTable(State* state, int index) {
     RawSet(state, index,
-           "create", &CreateOnHeap<nu::Font, const std::string&, float,
-                                   nu::Font::Weight, nu::Font::Style>,
+           "create", &nu::Font::Get,
            "default", &GetDefault,
            "derive", &nu::Font::Derive,
            "getname", &nu::Font::GetName,
            "getsize", &nu::Font::GetSize,
            "getweight", &nu::Font::GetWeight,
-           "getstyle", &nu::Font::GetStyle);
+           "getstyle", &nu::Font::GetStyle,
+           "getmetrics", &nu::Font::GetMetrics);
   }
   static nu::Font* GetDefault() {
     return nu::System::GetDefaultFont();
@@ -707,6 +720,34 @@ struct Type<nu::TextAttributes> {
   }
 };
 
+template<>
+struct Type<nu::TextRangeAttributes> {
+  static constexpr const char* name = "yue.TextRangeAttributes";
+  static inline bool To(State* state, int index,
+                        nu::TextRangeAttributes* out) {
+    if (GetType(state, index) != LuaType::Table)
+      return false;
+    RawGetAndPop(state, index, "start", &out->start);
+    RawGetAndPop(state, index, "end", &out->end);
+    nu::Font* font;
+    if (RawGetAndPop(state, index, "font", &font))
+      out->font = font;
+    nu::Color color;
+    if (RawGetAndPop(state, index, "color", &color))
+      out->color = color;
+    return true;
+  }
+};
+
+template<>
+struct Type<nu::TextMeasurer> {
+  static constexpr const char* name = "yue.TextMeasurer";
+  static void BuildMetaTable(State* state, int index) {
+    RawSet(state, index,
+           "measurebatch", &nu::TextMeasurer::MeasureBatch);
+  }
+};
+
 template<>
 struct Type<nu::Painter> {
   static constexpr const char* name = "yue.Painter";
@@ -1527,6 +1568,18 @@ struct Type<nu::ProtocolStringJob> {
   }
 };
 
+template<>
+struct Type<nu::ProtocolStreamJob> {
+  using base = nu::ProtocolJob;
+  static constexpr const char* name = "yue.ProtocolStreamJob";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &CreateOnHeap<nu::ProtocolStreamJob, const std::string&>,
+           "write", &nu::ProtocolStreamJob::Write,
+           "finish", &nu::ProtocolStreamJob::Finish);
+  }
+};
+
 template<>
 struct Type<nu::ProtocolFileJob> {
   using base = nu::ProtocolJob;
@@ -1592,7 +1645,13 @@ struct Type<nu::Browser> {
            "setbindingname", &nu::Browser::SetBindingName,
            "addbinding", &AddBinding,
            "addrawbinding", &nu::Browser::AddRawBinding,
-           "removebinding", &nu::Browser::RemoveBinding);
+           "removebinding", &nu::Browser::RemoveBinding,
+           "beginupdatebindings", &nu::Browser::BeginUpdateBindings,
+           "endupdatebindings", &nu::Browser::EndUpdateBindings,
+           "postmessagetopage", &nu::Browser::PostMessageToPage,
+           "setmessagequeuelimit", &SetMessageQueueLimit,
+           "getmessagequeuelimit", &GetMessageQueueLimit,
+           "getpendingmessagecount", &GetPendingMessageCount);
     RawSetProperty(state, metatable,
                    "onclose", &nu::Browser::on_close,
                    "onupdatecommand", &nu::Browser::on_update_command,
@@ -1601,7 +1660,10 @@ struct Type<nu::Browser> {
                    "onstartnavigation", &nu::Browser::on_start_navigation,
                    "oncommitnavigation", &nu::Browser::on_commit_navigation,
                    "onfinishnavigation", &nu::Browser::on_finish_navigation,
-                   "onfailnavigation", &nu::Browser::on_fail_navigation);
+                   "onfailnavigation", &nu::Browser::on_fail_navigation,
+                   "ondrainmessages", &nu::Browser::on_drain_messages,
+                   "handlemessage", &nu::Browser::handle_message,
+                   "handlerequest", &nu::Browser::handle_request);
   }
   static void AddBinding(CallContext* context,
                          nu::Browser* browser,
@@ -1622,6 +1684,15 @@ struct Type<nu::Browser> {
       lua_pcall(state, static_cast<int>(value.GetList().size()), 0, 0);
     });
   }
+  static void SetMessageQueueLimit(nu::Browser* browser, uint32_t limit) {
+    browser->SetMessageQueueLimit(limit);
+  }
+  static uint32_t GetMessageQueueLimit(nu::Browser* browser) {
+    return static_cast<uint32_t>(browser->GetMessageQueueLimit());
+  }
+  static uint32_t GetPendingMessageCount(nu::Browser* browser) {
+    return static_cast<uint32_t>(browser->GetPendingMessageCount());
+  }
 };
 
 template<>
@@ -1902,7 +1973,11 @@ struct Type<nu::TableModel> {
            "getvalue", &GetValue,
            "notifyrowinsertion", &NotifyRowInsertion,
            "notifyrowdeletion", &NotifyRowDeletion,
-           "notifyvaluechange", &NotifyValueChange);
+           "notifyvaluechange", &NotifyValueChange,
+           "notifyrowsinserted", &NotifyRowsInserted,
+           "notifyrowsdeleted", &NotifyRowsDeleted,
+           "notifyrowschanged", &NotifyRowsChanged,
+           "notifyreset", &nu::TableModel::NotifyReset);
   }
   static void SetValue(nu::TableModel* model,
                        uint32_t column,
@@ -1924,6 +1999,18 @@ struct Type<nu::TableModel> {
                               uint32_t module, uint32_t row) {
     model->NotifyValueChange(module - 1, row - 1);
   }
+  static void NotifyRowsInserted(nu::TableModel* model,
+                                 uint32_t start, uint32_t count) {
+    model->NotifyRowsInserted(start - 1, count);
+  }
+  static void NotifyRowsDeleted(nu::TableModel* model,
+                                uint32_t start, uint32_t count) {
+    model->NotifyRowsDeleted(start - 1, count);
+  }
+  static void NotifyRowsChanged(nu::TableModel* model,
+                                uint32_t start, uint32_t count) {
+    model->NotifyRowsChanged(start - 1, count);
+  }
 };
 
 template<>
@@ -1931,11 +2018,14 @@ struct Type<nu::AbstractTableModel> {
   using base = nu::TableModel;
   static constexpr const char* name = "yue.AbstractTableModel";
   static void BuildMetaTable(State* state, int metatable) {
-    RawSet(state, metatable, "create", &Create);
+    RawSet(state, metatable,
+           "create", &Create,
+           "clearcache", &nu::AbstractTableModel::ClearCache);
     RawSetProperty(state, metatable,
                    "getrowcount", &nu::AbstractTableModel::get_row_count,
                    "setvalue", &nu::AbstractTableModel::set_value,
-                   "getvalue", &nu::AbstractTableModel::get_value);
+                   "getvalue", &nu::AbstractTableModel::get_value,
+                   "getrows", &nu::AbstractTableModel::get_rows);
   }
   static nu::AbstractTableModel* Create() {
     return new nu::AbstractTableModel(false /* index_starts_from_0 */);
@@ -1950,11 +2040,144 @@ struct Type<nu::SimpleTableModel> {
     RawSet(state, metatable,
            "create", &CreateOnHeap<nu::SimpleTableModel, uint32_t>,
            "addrow", &nu::SimpleTableModel::AddRow,
-           "removerowat", &RemoveRowAt);
+           "addrows", &nu::SimpleTableModel::AddRows,
+           "removerowat", &RemoveRowAt,
+           "removerows", &RemoveRows,
+           "clear", &nu::SimpleTableModel::Clear);
   }
   static void RemoveRowAt(nu::SimpleTableModel* model, uint32_t row) {
     model->RemoveRowAt(row - 1);
   }
+  static void RemoveRows(nu::SimpleTableModel* model,
+                         uint32_t start, uint32_t count) {
+    model->RemoveRows(start - 1, count);
+  }
+};
+
+template<>
+struct Type<nu::ColumnarTableModel::ValueType> {
+  static constexpr const char* name = "yue.ColumnarTableModel.ValueType";
+  static inline bool To(State* state, int index,
+                        nu::ColumnarTableModel::ValueType* out) {
+    std::string type;
+    if (!lua::To(state, index, &type))
+      return false;
+    if (type == "integer") {
+      *out = nu::ColumnarTableModel::ValueType::Integer;
+      return true;
+    } else if (type == "double") {
+      *out = nu::ColumnarTableModel::ValueType::Double;
+      return true;
+    } else if (type == "string") {
+      *out = nu::ColumnarTableModel::ValueType::String;
+      return true;
+    } else if (type == "boolean") {
+      *out = nu::ColumnarTableModel::ValueType::Boolean;
+      return true;
+    } else {
+      return false;
+    }
+  }
+};
+
+template<>
+struct Type<nu::ColumnarTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.ColumnarTableModel";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &Create,
+           "addrow", &nu::ColumnarTableModel::AddRow,
+           "addrows", &nu::ColumnarTableModel::AddRows,
+           "removerows", &RemoveRows,
+           "clear", &nu::ColumnarTableModel::Clear,
+           "getmemoryusage", &GetMemoryUsage);
+  }
+  static void RemoveRows(nu::ColumnarTableModel* model,
+                         uint32_t start, uint32_t count) {
+    model->RemoveRows(start - 1, count);
+  }
+  static nu::ColumnarTableModel* Create(
+      std::vector<nu::ColumnarTableModel::ValueType> types) {
+    return new nu::ColumnarTableModel(std::move(types));
+  }
+  static double GetMemoryUsage(nu::ColumnarTableModel* model) {
+    return static_cast<double>(model->GetMemoryUsage());
+  }
+};
+
+template<>
+struct Type<nu::FileTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.FileTableModel";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &Create,
+           "open", &nu::FileTableModel::Open,
+           "close", &nu::FileTableModel::Close,
+           "isindexing", &nu::FileTableModel::IsIndexing,
+           "getheader", &nu::FileTableModel::GetHeader,
+           "getindexmemoryusage", &GetIndexMemoryUsage);
+    RawSetProperty(state, metatable,
+                   "onindexprogress", &nu::FileTableModel::on_index_progress);
+  }
+  static nu::FileTableModel* Create(const std::string& delimiter,
+                                    bool has_header) {
+    return new nu::FileTableModel(delimiter.empty() ? ',' : delimiter[0],
+                                  has_header);
+  }
+  static double GetIndexMemoryUsage(nu::FileTableModel* model) {
+    return static_cast<double>(model->GetIndexMemoryUsage());
+  }
+};
+
+template<>
+struct Type<nu::SortFilterTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.SortFilterTableModel";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &CreateOnHeap<nu::SortFilterTableModel, nu::TableModel*>,
+           "getsource", &nu::SortFilterTableModel::GetSource,
+           "sortbycolumn", &SortByColumn,
+           "getsortcolumn", &GetSortColumn,
+           "issortascending", &nu::SortFilterTableModel::IsSortAscending,
+           "issorting", &nu::SortFilterTableModel::IsSorting,
+           "setfilter", &SetFilter,
+           "maptosource", &MapToSource,
+           "mapfromsource", &MapFromSource);
+  }
+  static void SortByColumn(nu::SortFilterTableModel* model,
+                           int column, bool ascending) {
+    model->SortByColumn(column > 0 ? column - 1 : -1, ascending);
+  }
+  static int GetSortColumn(nu::SortFilterTableModel* model) {
+    int column = model->GetSortColumn();
+    return column == -1 ? -1 : column + 1;
+  }
+  static void SetFilter(
+      nu::SortFilterTableModel* model,
+      const std::function<bool(nu::TableModel*, uint32_t)>& filter) {
+    if (!filter) {
+      model->SetFilter(nullptr);
+      return;
+    }
+    model->SetFilter([filter](nu::TableModel* source, uint32_t row) {
+      return filter(source, row + 1);
+    });
+  }
+  static int MapToSource(nu::SortFilterTableModel* model, uint32_t row) {
+    if (row == 0)
+      return -1;
+    int index = model->MapToSource(row - 1);
+    return index == -1 ? -1 : index + 1;
+  }
+  static int MapFromSource(nu::SortFilterTableModel* model, uint32_t row) {
+    if (row == 0)
+      return -1;
+    int index = model->MapFromSource(row - 1);
+    return index == -1 ? -1 : index + 1;
+  }
 };
 
 template<>
@@ -1988,6 +2211,7 @@ struct Type<nu::Table::ColumnOptions> {
       RawGetAndPop(state, index, "type", &out->type);
       RawGetAndPop(state, index, "ondraw", &out->on_draw);
       RawGetAndPop(state, index, "width", &out->width);
+      RawGetAndPop(state, index, "cachedrawing", &out->cache_drawing);
       int column;
       if (RawGetAndPop(state, index, "column", &column))
         out->column = column - 1;
@@ -2027,6 +2251,125 @@ struct Type<nu::Table> {
   }
 };
 
+template<>
+struct Type<nu::TreeModel::Item> {
+  static constexpr const char* name = "yue.TreeModel.Item";
+  static inline bool To(State* state, int index, nu::TreeModel::Item* out) {
+    if (GetType(state, index) != LuaType::Table)
+      return false;
+    RawGetAndPop(state, index, "values", &out->values);
+    RawGetAndPop(state, index, "expandable", &out->expandable);
+    return true;
+  }
+};
+
+template<>
+struct Type<nu::TreeModel> {
+  static constexpr const char* name = "yue.TreeModel";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &CreateOnHeap<nu::TreeModel, uint32_t>,
+           "addnodes", &nu::TreeModel::AddNodes,
+           "addnode", &nu::TreeModel::AddNode,
+           "removenode", &nu::TreeModel::RemoveNode,
+           "unloadchildren", &nu::TreeModel::UnloadChildren,
+           "clear", &nu::TreeModel::Clear,
+           "loadchildren", &nu::TreeModel::LoadChildren,
+           "isloaded", &nu::TreeModel::IsLoaded,
+           "isloading", &nu::TreeModel::IsLoading,
+           "isexpandable", &nu::TreeModel::IsExpandable,
+           "hasnode", &nu::TreeModel::HasNode,
+           "getparent", &nu::TreeModel::GetParent,
+           "getchildcount", &nu::TreeModel::GetChildCount,
+           "getchildat", &GetChildAt,
+           "getindex", &GetIndex,
+           "getnodecount", &GetNodeCount,
+           "getcolumncount", &nu::TreeModel::GetColumnCount,
+           "getvalue", &GetValue,
+           "setvalue", &SetValue);
+    RawSetProperty(state, metatable,
+                   "fetchchildren", &nu::TreeModel::fetch_children);
+  }
+  static uint32_t GetChildAt(nu::TreeModel* model, uint32_t node,
+                             uint32_t index) {
+    return model->GetChildAt(node, index - 1);
+  }
+  static uint32_t GetIndex(nu::TreeModel* model, uint32_t node) {
+    return model->GetIndex(node) + 1;
+  }
+  static double GetNodeCount(nu::TreeModel* model) {
+    return static_cast<double>(model->GetNodeCount());
+  }
+  static const base::Value* GetValue(nu::TreeModel* model, uint32_t node,
+                                     uint32_t column) {
+    return model->GetValue(node, column - 1);
+  }
+  static void SetValue(nu::TreeModel* model, uint32_t node, uint32_t column,
+                       ::base::Value value) {
+    model->SetValue(node, column - 1, std::move(value));
+  }
+};
+
+#if defined(OS_LINUX)
+template<>
+struct Type<nu::TreeView> {
+  using base = nu::View;
+  static constexpr const char* name = "yue.TreeView";
+  static void BuildMetaTable(State* state, int metatable) {
+    RawSet(state, metatable,
+           "create", &CreateOnHeap<nu::TreeView>,
+           "setmodel",
+           RefMethod(&nu::TreeView::SetModel, RefType::Reset, "model"),
+           "getmodel", &nu::TreeView::GetModel,
+           "addcolumn", &nu::TreeView::AddColumn,
+           "getcolumncount", &nu::TreeView::GetColumnCount,
+           "setcolumnsvisible", &nu::TreeView::SetColumnsVisible,
+           "iscolumnsvisible", &nu::TreeView::IsColumnsVisible,
+           "setloadingtext", &nu::TreeView::SetLoadingText,
+           "expandnode", &nu::TreeView::ExpandNode,
+           "collapsenode", &nu::TreeView::CollapseNode,
+           "isnodeexpanded", &nu::TreeView::IsNodeExpanded,
+           "selectnode", &nu::TreeView::SelectNode,
+           "getselectednode", &nu::TreeView::GetSelectedNode);
+  }
+};
+#endif
+
+#if defined(OS_LINUX)
+template<>
+struct Type<nu::TextEdit::TextChange> {
+  static constexpr const char* name = "yue.TextEdit.TextChange";
+  static inline void Push(State* state,
+                          const nu::TextEdit::TextChange& change) {
+    NewTable(state, 0, 3);
+    RawSet(state, -1, "offset", change.offset,
+                      "deletedlength", change.deleted_length,
+                      "insertedtext", change.inserted_text);
+  }
+};
+
+template<>
+struct Type<nu::TextEdit::StyledRange> {
+  static constexpr const char* name = "yue.TextEdit.StyledRange";
+  static inline bool To(State* state, int index,
+                        nu::TextEdit::StyledRange* out) {
+    if (GetType(state, index) != LuaType::Table)
+      return false;
+    RawGetAndPop(state, index, "start", &out->start);
+    RawGetAndPop(state, index, "end", &out->end);
+    nu::Font* font;
+    if (RawGetAndPop(state, index, "font", &font))
+      out->font = font;
+    nu::Color color;
+    if (RawGetAndPop(state, index, "color", &color))
+      out->color = color;
+    if (RawGetAndPop(state, index, "background", &color))
+      out->background = color;
+    return true;
+  }
+};
+#endif
+
 template<>
 struct Type<nu::TextEdit> {
   using base = nu::View;
@@ -2040,6 +2383,14 @@ struct Type<nu::TextEdit> {
            "canredo", &nu::TextEdit::CanRedo,
            "undo", &nu::TextEdit::Undo,
            "canundo", &nu::TextEdit::CanUndo,
+#if !defined(OS_WIN)
+           "beginundogroup", &nu::TextEdit::BeginUndoGroup,
+           "endundogroup", &nu::TextEdit::EndUndoGroup,
+#endif
+#if defined(OS_LINUX)
+           "setundomemorylimit", &nu::TextEdit::SetUndoMemoryLimit,
+           "getundomemoryusage", &nu::TextEdit::GetUndoMemoryUsage,
+#endif
            "cut", &nu::TextEdit::Cut,
            "copy", &nu::TextEdit::Copy,
            "paste", &nu::TextEdit::Paste,
@@ -2051,6 +2402,21 @@ struct Type<nu::TextEdit> {
            "inserttextat", &nu::TextEdit::InsertTextAt,
            "delete", &nu::TextEdit::Delete,
            "deleterange", &nu::TextEdit::DeleteRange,
+#if defined(OS_LINUX)
+           "gettextlength", &nu::TextEdit::GetTextLength,
+           "getlinecount", &nu::TextEdit::GetLineCount,
+           "getline", &nu::TextEdit::GetLine,
+           "getlineatoffset", &nu::TextEdit::GetLineAtOffset,
+           "getlinestartoffset", &nu::TextEdit::GetLineStartOffset,
+           "loadfromfile", &nu::TextEdit::LoadFromFile,
+           "appendchunks", &nu::TextEdit::AppendChunks,
+           "isloading", &nu::TextEdit::IsLoading,
+           "cancelloading", &nu::TextEdit::CancelLoading,
+           "getvisiblerange", &nu::TextEdit::GetVisibleRange,
+           "getrevision", &nu::TextEdit::GetRevision,
+           "setstyledranges", &nu::TextEdit::SetStyledRanges,
+           "setstyledrangesinrange", &nu::TextEdit::SetStyledRangesInRange,
+#endif
 #if !defined(OS_WIN)
            "setoverlayscrollbar", &nu::TextEdit::SetOverlayScrollbar,
 #endif
@@ -2060,6 +2426,11 @@ struct Type<nu::TextEdit> {
                    "ontextchange", &nu::TextEdit::on_text_change,
                    "shouldinsertnewline",
                    &nu::TextEdit::should_insert_new_line);
+#if defined(OS_LINUX)
+    RawSetProperty(state, metatable,
+                   "ontextedit", &nu::TextEdit::on_text_edit,
+                   "onloadprogress", &nu::TextEdit::on_load_progress);
+#endif
   }
 };
 
@@ -2185,6 +2556,7 @@ extern "C" int luaopen_yue_gui(lua::State* state) {
   BindType<nu::Container>(state, "Container");
   BindType<nu::Button>(state, "Button");
   BindType<nu::ProtocolStringJob>(state, "ProtocolStringJob");
+  BindType<nu::ProtocolStreamJob>(state, "ProtocolStreamJob");
   BindType<nu::ProtocolFileJob>(state, "ProtocolFileJob");
   BindType<nu::ProtocolAsarJob>(state, "ProtocolAsarJob");
   BindType<nu::Browser>(state, "Browser");
@@ -2201,9 +2573,17 @@ extern "C" int luaopen_yue_gui(lua::State* state) {
   BindType<nu::TableModel>(state, "TableModel");
   BindType<nu::AbstractTableModel>(state, "AbstractTableModel");
   BindType<nu::SimpleTableModel>(state, "SimpleTableModel");
+  BindType<nu::ColumnarTableModel>(state, "ColumnarTableModel");
+  BindType<nu::FileTableModel>(state, "FileTableModel");
+  BindType<nu::SortFilterTableModel>(state, "SortFilterTableModel");
   BindType<nu::Table>(state, "Table");
   BindType<nu::TextEdit>(state, "TextEdit");
+  BindType<nu::TextMeasurer>(state, "TextMeasurer");
   BindType<nu::Tray>(state, "Tray");
+  BindType<nu::TreeModel>(state, "TreeModel");
+#if defined(OS_LINUX)
+  BindType<nu::TreeView>(state, "TreeView");
+#endif
 #if defined(OS_MACOSX)
   BindType<nu::Toolbar>(state, "Toolbar");
   BindType<nu::Vibrant>(state, "Vibrant");
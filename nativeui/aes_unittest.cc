@@ -0,0 +1,93 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/util/aes.h"
+
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::string FromHex(const std::string& hex) {
+  std::string bytes;
+  EXPECT_TRUE(base::HexStringToString(hex, &bytes));
+  return bytes;
+}
+
+// Test vectors from NIST SP 800-38A, F.2 CBC Example Vectors.
+const char kIV[] = "000102030405060708090a0b0c0d0e0f";
+const char kPlainText[] =
+    "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+    "30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+
+struct TestVector {
+  const char* key;
+  const char* cipher_text;
+} kTestVectors[] = {
+  {"2b7e151628aed2a6abf7158809cf4f3c",
+   "7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+   "73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7"},
+  {"8e73b0f7da0e6452c810f32b809079e562f8ead2522c6b7b",
+   "4f021db243bc633d7178183a9fa071e8b4d9ada9ad7dedf4e5e738763f69145a"
+   "571b242012fb7ae07fa9baac3df102e008b0e27988598881d920a9e64f5615cd"},
+  {"603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4",
+   "f58c4c04d6e5f1ba779eabfb5f7bfbd69cfc4e967edb808d679f777bc6702c7d"
+   "39f23369a9d9bacfa530e26304231461b2eb05e2c39be9fcda6c19078c6a9d1b"},
+};
+
+}  // namespace
+
+TEST(AESTest, InvalidKey) {
+  nu::AES aes;
+  EXPECT_FALSE(aes.Init(std::string(15, 'k'), FromHex(kIV)));
+  EXPECT_FALSE(aes.Init(std::string(16, 'k'), std::string(8, 'i')));
+  EXPECT_FALSE(aes.IsValid());
+}
+
+TEST(AESTest, CBCEncrypt) {
+  for (const TestVector& vector : kTestVectors) {
+    nu::AES aes;
+    ASSERT_TRUE(aes.Init(FromHex(vector.key), FromHex(kIV)));
+    std::string data = FromHex(kPlainText);
+    aes.CBCEncryptBuffer(reinterpret_cast<uint8_t*>(&data[0]), data.size());
+    EXPECT_EQ(data, FromHex(vector.cipher_text));
+  }
+}
+
+TEST(AESTest, CBCDecrypt) {
+  for (const TestVector& vector : kTestVectors) {
+    for (bool accelerated : {true, false}) {
+      nu::AES aes;
+      ASSERT_TRUE(aes.Init(FromHex(vector.key), FromHex(kIV)));
+      if (!accelerated)
+        aes.DisableAcceleration();
+      // Decrypt in 2 calls to verify the state is kept.
+      std::string data = FromHex(vector.cipher_text);
+      uint8_t* buf = reinterpret_cast<uint8_t*>(&data[0]);
+      aes.CBCDecryptBuffer(buf, AES_BLOCKLEN);
+      aes.CBCDecryptBuffer(buf + AES_BLOCKLEN, data.size() - AES_BLOCKLEN);
+      EXPECT_EQ(data, FromHex(kPlainText));
+    }
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests to compare the throughput.
+TEST(AESTest, DISABLED_CBCDecryptThroughput) {
+  std::vector<uint8_t> buffer(64 * 1024 * 1024);
+  for (bool accelerated : {true, false}) {
+    nu::AES aes;
+    ASSERT_TRUE(aes.Init(std::string(32, 'k'), FromHex(kIV)));
+    if (!accelerated)
+      aes.DisableAcceleration();
+    base::TimeTicks start = base::TimeTicks::Now();
+    aes.CBCDecryptBuffer(buffer.data(), buffer.size());
+    base::TimeDelta elapsed = base::TimeTicks::Now() - start;
+    LOG(INFO) << (aes.IsAccelerated() ? "AES-NI" : "Portable") << ": "
+              << 64 / elapsed.InSecondsF() << " MB/s";
+  }
+}
@@ -4,15 +4,19 @@
 
 #include "nativeui/asar_archive.h"
 
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "base/json/json_reader.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
-#include "base/strings/utf_string_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
 
 namespace nu {
 
@@ -21,20 +25,121 @@ namespace {
 // The version of asar format we supports.
 const uint8_t kSupportedAsarVersion = 2;
 
+// Links pointing to links are followed at most this many times, which also
+// breaks cycles.
+const int kMaxLinkDepth = 16;
+
+// Convert |path| to the form used as keys of the index, e.g.
+// /path\to//image.jpg => path/to/image.jpg
+std::string NormalizePath(const std::string& path) {
+  // Most paths are already normalized.
+  if (!path.empty() && path.front() != '/' && path.back() != '/' &&
+      path.find('\\') == std::string::npos &&
+      path.find("//") == std::string::npos)
+    return path;
+  std::vector<base::StringPiece> components = base::SplitStringPiece(
+      path, "/\\", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  return base::JoinString(components, "/");
+}
+
+// Archives are keyed by path and format.
+using ArchiveKey = std::pair<base::FilePath, bool>;
+
+struct ArchiveCache {
+  base::Lock lock;
+  std::map<ArchiveKey, scoped_refptr<AsarArchive>> archives;
+};
+
+base::LazyInstance<ArchiveCache>::Leaky g_archive_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+ArchiveCache* GetArchiveCache() {
+  return g_archive_cache.Pointer();
+}
+
+// A slice of the mapped archive, which keeps the archive alive.
+class ArchiveSlice : public base::RefCountedMemory {
+ public:
+  ArchiveSlice(scoped_refptr<const AsarArchive> archive,
+               const unsigned char* data,
+               size_t size)
+      : archive_(std::move(archive)), data_(data), size_(size) {}
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override { return data_; }
+  size_t size() const override { return size_; }
+
+ private:
+  ~ArchiveSlice() override {}
+
+  scoped_refptr<const AsarArchive> archive_;
+  const unsigned char* data_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveSlice);
+};
+
 }  // namespace
 
-AsarArchive::AsarArchive(base::File file, bool extended_format)
-    : file_(std::move(file)) {
-  if (!file_.IsValid())
+// static
+scoped_refptr<AsarArchive> AsarArchive::Open(const base::FilePath& path,
+                                             bool extended_format) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  base::File::Info file_info;
+  if (!file.IsValid() || !file.GetInfo(&file_info))
+    return nullptr;
+
+  ArchiveCache* cache = GetArchiveCache();
+  ArchiveKey key(path, extended_format);
+  {
+    base::AutoLock auto_lock(cache->lock);
+    auto it = cache->archives.find(key);
+    if (it != cache->archives.end() &&
+        it->second->last_modified_ == file_info.last_modified)
+      return it->second;
+  }
+
+  // Parse without holding the lock, so lookups of other archives are not
+  // blocked. If two threads open the same archive at the same time, the last
+  // one wins and the other copy is freed once it is no longer used.
+  scoped_refptr<AsarArchive> archive =
+      new AsarArchive(std::move(file), extended_format);
+  if (!archive->IsValid())
+    return nullptr;
+  archive->last_modified_ = file_info.last_modified;
+  base::AutoLock auto_lock(cache->lock);
+  cache->archives[key] = archive;
+  return archive;
+}
+
+// static
+size_t AsarArchive::GetCachedMemoryUsage() {
+  ArchiveCache* cache = GetArchiveCache();
+  base::AutoLock auto_lock(cache->lock);
+  size_t usage = 0;
+  for (const auto& it : cache->archives)
+    usage += it.second->GetMemoryUsage();
+  return usage;
+}
+
+// static
+void AsarArchive::ClearCache() {
+  ArchiveCache* cache = GetArchiveCache();
+  base::AutoLock auto_lock(cache->lock);
+  cache->archives.clear();
+}
+
+AsarArchive::AsarArchive(base::File file, bool extended_format) {
+  if (!file.IsValid())
     return;
 
   // If it is an extended type of asar, search from the end of file.
-  if (extended_format && !ReadExtendedMeta())
+  if (extended_format && !ReadExtendedMeta(&file))
     return;
 
   // Read size.
   char size_buf[8];
-  if (file_.ReadAtCurrentPos(size_buf, 8) != 8)
+  if (file.ReadAtCurrentPos(size_buf, 8) != 8)
     return;
   uint32_t size;
   if (!base::PickleIterator(base::Pickle(size_buf, 8)).ReadUInt32(&size))
@@ -42,7 +147,7 @@ AsarArchive::AsarArchive(base::File file, bool extended_format)
 
   // Read header.
   std::vector<char> header_buf(size);
-  if (file_.ReadAtCurrentPos(header_buf.data(), size) != static_cast<int>(size))
+  if (file.ReadAtCurrentPos(header_buf.data(), size) != static_cast<int>(size))
     return;
   std::string header;
   if (!base::PickleIterator(
@@ -54,74 +159,159 @@ AsarArchive::AsarArchive(base::File file, bool extended_format)
   if (!value || !value->is_dict())
     return;
   content_offset_ += 8 + size;
-  header_ = std::move(*value.release());
+
+  // Flatten the header, the parsed JSON is freed after this.
+  std::unordered_map<std::string, std::string> links;
+  AddFiles(*value, std::string(), &links);
+  ResolveLinks(links);
+  valid_ = true;
+
+  // Failing to map is fine, the files can still be read.
+  if (!mapped_file_.Initialize(std::move(file)))
+    LOG(WARNING) << "Unable to map asar archive into memory";
 }
 
 AsarArchive::~AsarArchive() {
 }
 
 bool AsarArchive::IsValid() const {
-  return file_.IsValid() && header_.is_dict();
+  return valid_;
 }
 
-bool AsarArchive::GetFileInfo(const std::string& path, FileInfo* info) {
-  if (!header_.is_dict())
-    return false;
-
-  // Convert file path to value search path.
-  // path/to/image.jpg => { files, path, files, to, files, image.jpg }
-  std::vector<base::StringPiece> components = base::SplitStringPiece(
-      path, "/\\", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
-  std::vector<base::StringPiece> key;
-  key.reserve(components.size() * 2);
-  for (const base::StringPiece& c : components) {
-    key.push_back("files");
-    key.push_back(c);
-  }
-
-  // Search for the node representing path.
-  const base::Value* node = header_.FindPath(key);
-  if (!node)
+bool AsarArchive::GetFileInfo(const std::string& path, FileInfo* info) const {
+  auto it = files_.find(NormalizePath(path));
+  if (it == files_.end())
     return false;
+  *info = it->second;
+  return true;
+}
 
-  // Read file information.
-  const base::Value* link = node->FindKey("link");
-  if (link && link->is_string())
-    return GetFileInfo(link->GetString(), info);
-
-  const base::Value* size = node->FindKey("size");
-  if (!size || !size->is_int())
-    return false;
-  info->size = size->GetInt();
-
-  const base::Value* offset = node->FindKey("offset");
-  if (!offset || !offset->is_string() ||
-      !base::StringToUint64(offset->GetString(), &info->offset))
-    return false;
+scoped_refptr<base::RefCountedMemory> AsarArchive::GetFileContent(
+    const FileInfo& info) const {
+  if (!mapped_file_.IsValid() || (info.flags & kUnpacked) ||
+      info.IsCompressed() ||
+      info.offset > mapped_file_.length() ||
+      info.stored_size > mapped_file_.length() - info.offset)
+    return nullptr;
+  return new ArchiveSlice(this, mapped_file_.data() + info.offset,
+                          info.stored_size);
+}
 
-  info->offset += content_offset_;
-  return true;
+size_t AsarArchive::GetMemoryUsage() const {
+  // Each node of unordered_map stores the value and a next pointer, and the
+  // buckets are an array of pointers.
+  size_t usage = sizeof(*this) + files_.bucket_count() * sizeof(void*);
+  for (const auto& it : files_) {
+    usage += sizeof(void*) + sizeof(it);
+    // Short strings are stored inline.
+    if (it.first.capacity() >= sizeof(std::string))
+      usage += it.first.capacity() + 1;
+  }
+  return usage;
 }
 
-bool AsarArchive::ReadExtendedMeta() {
+bool AsarArchive::ReadExtendedMeta(base::File* file) {
   // Read last 13 bytes, which are | size(8) | version(1) | magic(4) |.
   char magic[5] = { 0 };
-  if (file_.Seek(base::File::FROM_END, -4) == -1 ||
-      file_.ReadAtCurrentPos(magic, 4) != 4 ||
+  if (file->Seek(base::File::FROM_END, -4) == -1 ||
+      file->ReadAtCurrentPos(magic, 4) != 4 ||
       base::StringPiece(magic) != "ASAR")
     return false;
   uint8_t version;
-  if (file_.Seek(base::File::FROM_END, -5) == -1 ||
-      file_.ReadAtCurrentPos(reinterpret_cast<char*>(&version), 1) != 1 ||
+  if (file->Seek(base::File::FROM_END, -5) == -1 ||
+      file->ReadAtCurrentPos(reinterpret_cast<char*>(&version), 1) != 1 ||
       version != kSupportedAsarVersion)
     return false;
   double size;
-  if (file_.Seek(base::File::FROM_END, -13) == -1 ||
-      file_.ReadAtCurrentPos(reinterpret_cast<char*>(&size), 8) != 8)
+  if (file->Seek(base::File::FROM_END, -13) == -1 ||
+      file->ReadAtCurrentPos(reinterpret_cast<char*>(&size), 8) != 8)
     return false;
-  content_offset_ = file_.GetLength() - static_cast<uint64_t>(size);
-  file_.Seek(base::File::FROM_BEGIN, content_offset_);
+  content_offset_ = file->GetLength() - static_cast<uint64_t>(size);
+  file->Seek(base::File::FROM_BEGIN, content_offset_);
   return true;
 }
 
+void AsarArchive::AddFiles(
+    const base::Value& dir,
+    const std::string& prefix,
+    std::unordered_map<std::string, std::string>* links) {
+  const base::Value* files = dir.FindKeyOfType("files",
+                                               base::Value::Type::DICTIONARY);
+  if (!files)
+    return;
+  for (const auto& it : files->DictItems()) {
+    const base::Value& node = it.second;
+    if (!node.is_dict())
+      continue;
+    std::string path = prefix.empty() ? it.first : prefix + "/" + it.first;
+
+    const base::Value* link = node.FindKey("link");
+    if (link && link->is_string()) {
+      (*links)[std::move(path)] = NormalizePath(link->GetString());
+      continue;
+    }
+    if (node.FindKey("files")) {
+      AddFiles(node, path, links);
+      continue;
+    }
+
+    const base::Value* size = node.FindKey("size");
+    if (!size || !size->is_int())
+      continue;
+    FileInfo info;
+    info.size = info.stored_size = size->GetInt();
+    // Compressed files store the size of compressed data separately.
+    const base::Value* compression = node.FindKey("compression");
+    if (compression && compression->is_string()) {
+      const std::string& method = compression->GetString();
+      if (method == "zlib" || method == "gzip") {
+        info.flags |= kZlib;
+      } else if (method == "deflate") {
+        info.flags |= kDeflate;
+      } else {
+        LOG(ERROR) << "Unsupported compression method " << method
+                   << " for file " << path;
+        continue;
+      }
+      const base::Value* stored_size = node.FindKey("compressedSize");
+      if (!stored_size || !stored_size->is_int())
+        continue;
+      info.stored_size = stored_size->GetInt();
+    }
+    const base::Value* executable = node.FindKey("executable");
+    if (executable && executable->is_bool() && executable->GetBool())
+      info.flags |= kExecutable;
+    const base::Value* unpacked = node.FindKey("unpacked");
+    if (unpacked && unpacked->is_bool() && unpacked->GetBool()) {
+      // Unpacked files are stored outside the archive.
+      info.flags |= kUnpacked;
+    } else {
+      const base::Value* offset = node.FindKey("offset");
+      if (!offset || !offset->is_string() ||
+          !base::StringToUint64(offset->GetString(), &info.offset))
+        continue;
+      info.offset += content_offset_;
+    }
+    files_.emplace(std::move(path), info);
+  }
+}
+
+void AsarArchive::ResolveLinks(
+    const std::unordered_map<std::string, std::string>& links) {
+  for (const auto& it : links) {
+    const std::string* target = &it.second;
+    for (int depth = 0; depth < kMaxLinkDepth; ++depth) {
+      auto file = files_.find(*target);
+      if (file != files_.end()) {
+        files_.emplace(it.first, file->second);
+        break;
+      }
+      auto link = links.find(*target);
+      if (link == links.end())
+        break;
+      target = &link->second;
+    }
+  }
+}
+
 }  // namespace nu
@@ -6,32 +6,90 @@
 #define NATIVEUI_ASAR_ARCHIVE_H_
 
 #include <string>
+#include <unordered_map>
 
 #include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "nativeui/nativeui_export.h"
 
 namespace nu {
 
-class NATIVEUI_EXPORT AsarArchive {
+// Parsed header of an asar archive.
+//
+// The header is flattened into a map from file paths to file information when
+// the archive is opened, after that the archive is immutable and can be
+// searched from multiple threads.
+class NATIVEUI_EXPORT AsarArchive
+    : public base::RefCountedThreadSafe<AsarArchive> {
  public:
+  enum Flags : uint32_t {
+    kUnpacked   = 1 << 0,
+    kExecutable = 1 << 1,
+    // The file is compressed with zlib or gzip format.
+    kZlib       = 1 << 2,
+    // The file is compressed with raw deflate format.
+    kDeflate    = 1 << 3,
+  };
+
   struct FileInfo {
+    // The size of file content, which is the size after decompression.
     uint32_t size = 0;
+    // The size of data stored in archive.
+    uint32_t stored_size = 0;
+    uint32_t flags = 0;
     uint64_t offset = 0;
+
+    bool IsCompressed() const { return flags & (kZlib | kDeflate); }
   };
 
+  // Return the archive at |path|, archives are cached and only parsed again
+  // when the file has been modified. Return nullptr if the archive is invalid.
+  static scoped_refptr<AsarArchive> Open(const base::FilePath& path,
+                                         bool extended_format);
+  // Return the estimated memory used by cached archives.
+  static size_t GetCachedMemoryUsage();
+  // Release cached archives, the archives still being used are not freed.
+  static void ClearCache();
+
   AsarArchive(base::File file, bool extended_format);
-  virtual ~AsarArchive();
 
   bool IsValid() const;
-  bool GetFileInfo(const std::string& path, FileInfo* info);
+  bool GetFileInfo(const std::string& path, FileInfo* info) const;
+  // Return the content of file from the mapped archive without copying,
+  // return nullptr if the archive could not be mapped or the file is
+  // compressed.
+  scoped_refptr<base::RefCountedMemory> GetFileContent(
+      const FileInfo& info) const;
+
+  // Return the estimated memory used by the index, the mapped archive is not
+  // counted.
+  size_t GetMemoryUsage() const;
+  size_t GetFileCount() const { return files_.size(); }
+
+ protected:
+  virtual ~AsarArchive();
 
  private:
-  bool ReadExtendedMeta();
+  friend class base::RefCountedThreadSafe<AsarArchive>;
+
+  bool ReadExtendedMeta(base::File* file);
+  // Add the files under |dir| to index, links are stored in |links|.
+  void AddFiles(const base::Value& dir, const std::string& prefix,
+                std::unordered_map<std::string, std::string>* links);
+  // Add the links that point to files to index.
+  void ResolveLinks(const std::unordered_map<std::string, std::string>& links);
 
-  base::File file_;
-  base::Value header_;
+  bool valid_ = false;
   uint64_t content_offset_ = 0;
+  base::Time last_modified_;
+  std::unordered_map<std::string, FileInfo> files_;
+  // The whole archive is mapped once and shared by all requests.
+  base::MemoryMappedFile mapped_file_;
 };
 
 }  // namespace nu
@@ -0,0 +1,119 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/asar_archive.h"
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/pickle.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class AsarArchiveTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+  }
+
+  void TearDown() override {
+    nu::AsarArchive::ClearCache();
+  }
+
+  // Write an archive with |header| followed by |content|.
+  base::FilePath WriteArchive(const std::string& header,
+                              const std::string& content) {
+    base::Pickle header_pickle;
+    header_pickle.WriteString(header);
+    base::Pickle size_pickle;
+    size_pickle.WriteUInt32(static_cast<uint32_t>(header_pickle.size()));
+    std::string data(static_cast<const char*>(size_pickle.data()),
+                     size_pickle.size());
+    data.append(static_cast<const char*>(header_pickle.data()),
+                header_pickle.size());
+    data.append(content);
+    base::FilePath path = dir_.GetPath().AppendASCII("app.asar");
+    EXPECT_TRUE(base::WriteFile(path, data.data(), data.size()));
+    return path;
+  }
+
+  base::ScopedTempDir dir_;
+};
+
+TEST_F(AsarArchiveTest, GetFileInfo) {
+  base::FilePath path = WriteArchive(
+      "{\"files\":{"
+      "  \"a.txt\":{\"size\":3,\"offset\":\"0\"},"
+      "  \"dir\":{\"files\":{"
+      "    \"b.txt\":{\"size\":2,\"offset\":\"3\",\"executable\":true},"
+      "    \"c.node\":{\"size\":5,\"unpacked\":true},"
+      "    \"link\":{\"link\":\"a.txt\"}"
+      "  }},"
+      "  \"link\":{\"link\":\"dir/link\"},"
+      "  \"z.js\":{\"size\":100,\"compressedSize\":3,\"offset\":\"0\","
+      "          \"compression\":\"deflate\"},"
+      "  \"cycle\":{\"link\":\"cycle\"}"
+      "}}",
+      "aaabb");
+  scoped_refptr<nu::AsarArchive> archive = nu::AsarArchive::Open(path, false);
+  ASSERT_TRUE(archive);
+  EXPECT_EQ(archive->GetFileCount(), 6u);
+
+  nu::AsarArchive::FileInfo a;
+  ASSERT_TRUE(archive->GetFileInfo("a.txt", &a));
+  EXPECT_EQ(a.size, 3u);
+  EXPECT_EQ(a.flags, 0u);
+  nu::AsarArchive::FileInfo b;
+  ASSERT_TRUE(archive->GetFileInfo("/dir\\b.txt", &b));
+  EXPECT_EQ(b.size, 2u);
+  EXPECT_EQ(b.offset, a.offset + 3);
+  EXPECT_EQ(b.flags, nu::AsarArchive::kExecutable);
+  nu::AsarArchive::FileInfo c;
+  ASSERT_TRUE(archive->GetFileInfo("dir/c.node", &c));
+  EXPECT_EQ(c.flags, nu::AsarArchive::kUnpacked);
+
+  nu::AsarArchive::FileInfo link;
+  ASSERT_TRUE(archive->GetFileInfo("link", &link));
+  EXPECT_EQ(link.offset, a.offset);
+  EXPECT_FALSE(archive->GetFileInfo("cycle", &link));
+  EXPECT_FALSE(archive->GetFileInfo("dir", &link));
+  EXPECT_FALSE(archive->GetFileInfo("missing", &link));
+  EXPECT_GT(archive->GetMemoryUsage(), 0u);
+
+  scoped_refptr<base::RefCountedMemory> content = archive->GetFileContent(b);
+  ASSERT_TRUE(content);
+  EXPECT_EQ(std::string(content->front_as<char>(), content->size()), "bb");
+  EXPECT_FALSE(archive->GetFileContent(c));
+
+  nu::AsarArchive::FileInfo z;
+  ASSERT_TRUE(archive->GetFileInfo("z.js", &z));
+  EXPECT_TRUE(z.IsCompressed());
+  EXPECT_EQ(z.flags, nu::AsarArchive::kDeflate);
+  EXPECT_EQ(z.size, 100u);
+  EXPECT_EQ(z.stored_size, 3u);
+  EXPECT_FALSE(archive->GetFileContent(z));
+}
+
+TEST_F(AsarArchiveTest, Cache) {
+  base::FilePath path = WriteArchive(
+      "{\"files\":{\"a.txt\":{\"size\":1,\"offset\":\"0\"}}}", "a");
+  scoped_refptr<nu::AsarArchive> archive = nu::AsarArchive::Open(path, false);
+  ASSERT_TRUE(archive);
+  EXPECT_EQ(nu::AsarArchive::Open(path, false), archive);
+  EXPECT_EQ(nu::AsarArchive::GetCachedMemoryUsage(),
+            archive->GetMemoryUsage());
+
+  // Modified archive is parsed again.
+  WriteArchive("{\"files\":{\"b.txt\":{\"size\":1,\"offset\":\"0\"}}}", "b");
+  base::Time tomorrow = base::Time::Now() + base::TimeDelta::FromDays(1);
+  ASSERT_TRUE(base::TouchFile(path, tomorrow, tomorrow));
+  scoped_refptr<nu::AsarArchive> modified =
+      nu::AsarArchive::Open(path, false);
+  ASSERT_TRUE(modified);
+  EXPECT_NE(modified, archive);
+  nu::AsarArchive::FileInfo info;
+  EXPECT_TRUE(modified->GetFileInfo("b.txt", &info));
+  EXPECT_FALSE(modified->GetFileInfo("a.txt", &info));
+
+  nu::AsarArchive::ClearCache();
+  EXPECT_EQ(nu::AsarArchive::GetCachedMemoryUsage(), 0u);
+}
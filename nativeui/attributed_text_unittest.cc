@@ -0,0 +1,56 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+#if defined(OS_LINUX)
+#include <pango/pango.h>
+#endif
+
+class AttributedTextTest : public testing::Test {
+ protected:
+  nu::Lifetime lifetime_;
+  nu::State state_;
+};
+
+TEST_F(AttributedTextTest, SetAttributes) {
+  // "a", "é", "😀" (2 UTF-16 code units), "b".
+  scoped_refptr<nu::AttributedText> text =
+      new nu::AttributedText("a\xC3\xA9\xF0\x9F\x98\x80" "b",
+                             nu::TextFormat());
+  std::vector<nu::TextRangeAttributes> attributes(3);
+  attributes[0].start = 1;
+  attributes[0].end = 2;
+  attributes[0].color = nu::Color(255, 0, 0);
+  attributes[1].start = 4;
+  attributes[1].end = 5;
+  attributes[1].font = new nu::Font("Arial", 20, nu::Font::Weight::Bold,
+                                    nu::Font::Style::Normal);
+  // Invalid range is ignored.
+  attributes[2].start = 3;
+  attributes[2].end = 2;
+  attributes[2].color = nu::Color(0, 255, 0);
+  text->SetAttributes(attributes);
+  EXPECT_EQ(text->GetText(), "a\xC3\xA9\xF0\x9F\x98\x80" "b");
+
+#if defined(OS_LINUX)
+  PangoAttrList* list = pango_layout_get_attributes(text->GetNative());
+  PangoAttrIterator* iter = pango_attr_list_get_iterator(list);
+  std::vector<std::pair<guint, guint>> ranges;
+  do {
+    GSList* attrs = pango_attr_iterator_get_attrs(iter);
+    for (GSList* i = attrs; i; i = i->next) {
+      auto* attr = static_cast<PangoAttribute*>(i->data);
+      ranges.emplace_back(attr->start_index, attr->end_index);
+      pango_attribute_destroy(attr);
+    }
+    g_slist_free(attrs);
+  } while (pango_attr_iterator_next(iter));
+  pango_attr_iterator_destroy(iter);
+  ASSERT_EQ(ranges.size(), 2u);
+  EXPECT_EQ(ranges[0], std::make_pair(1u, 3u));
+  EXPECT_EQ(ranges[1], std::make_pair(7u, 8u));
+#endif
+}
@@ -4,21 +4,152 @@
 
 #include "nativeui/browser.h"
 
+#include <cmath>
+#include <set>
 #include <utility>
 
 #include "base/base64.h"
 #include "base/json/string_escape.h"
 #include "base/rand_util.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/stringprintf.h"
 
+#include "nativeui/message_loop.h"
 #include "nativeui/protocol_file_job.h"
 
 namespace nu {
 
+namespace {
+
+// How many messages can be pending before PostMessageToPage returns false.
+const size_t kDefaultMessageQueueLimit = 1000;
+
+// The types of entries sent through the message port.
+enum PortEntryType {
+  PORT_MESSAGE = 0,
+  PORT_REQUEST = 1,
+  PORT_REPLY = 2,
+};
+
+// The object receiving messages from page.
+const char kExternalObject[] =
+#if defined(OS_WIN)
+    "window.external";
+#else
+    "window.webkit.messageHandlers.yue";
+#endif
+
+// Adds the bindings in |names| to |binding| and deletes those in |removed|,
+// so the same code is used for injecting all bindings and for updating the
+// bindings of a loaded page.
+const char kUpdateBindingsScript[] =
+    "function(key, external, binding, names, removed) {"
+    "  names.forEach(function(name) {"
+    "    binding[name] = function() {"
+    "      var args = Array.prototype.slice.call(arguments);"
+#if defined(OS_WIN)
+    // On WebKit we can only pass one argument.
+    "      external.postMessage(key, name, JSON.stringify(args));"
+#else
+    "      external.postMessage([key, name, args]);"
+#endif
+    "    };"
+    "  });"
+    "  removed.forEach(function(name) { delete binding[name]; });"
+    "}";
+
+// Decodes the base64 strings of binary values into Uint8Array.
+const char kDecodeBinaryScript[] =
+    "function(s) {"
+    "  var d = atob(s), a = new Uint8Array(d.length);"
+    "  for (var i = 0; i < d.length; ++i) a[i] = d.charCodeAt(i);"
+    "  return a;"
+    "}";
+
+// Write |value| as JavaScript expression, binary values are written as calls
+// to the function "b" which turns base64 strings into Uint8Array.
+void SerializeValue(const base::Value& value, std::string* out) {
+  switch (value.type()) {
+    case base::Value::Type::BOOLEAN:
+      out->append(value.GetBool() ? "true" : "false");
+      break;
+    case base::Value::Type::INTEGER:
+      out->append(base::IntToString(value.GetInt()));
+      break;
+    case base::Value::Type::DOUBLE:
+      if (std::isfinite(value.GetDouble()))
+        out->append(base::NumberToString(value.GetDouble()));
+      else
+        out->append("null");
+      break;
+    case base::Value::Type::STRING:
+      base::EscapeJSONString(value.GetString(), true, out);
+      break;
+    case base::Value::Type::BINARY: {
+      std::string encoded;
+      base::Base64Encode(base::StringPiece(value.GetBlob().data(),
+                                           value.GetBlob().size()),
+                         &encoded);
+      out->append("b(\"");
+      out->append(encoded);
+      out->append("\")");
+      break;
+    }
+    case base::Value::Type::DICTIONARY: {
+      out->push_back('{');
+      bool first = true;
+      for (const auto& it : value.DictItems()) {
+        if (!first)
+          out->push_back(',');
+        first = false;
+        base::EscapeJSONString(it.first, true, out);
+        out->push_back(':');
+        SerializeValue(it.second, out);
+      }
+      out->push_back('}');
+      break;
+    }
+    case base::Value::Type::LIST: {
+      out->push_back('[');
+      bool first = true;
+      for (const auto& it : value.GetList()) {
+        if (!first)
+          out->push_back(',');
+        first = false;
+        SerializeValue(it, out);
+      }
+      out->push_back(']');
+      break;
+    }
+    default:
+      out->append("null");
+      break;
+  }
+}
+
+// Append the escaped |name| as an element of JavaScript array.
+void AppendName(const std::string& name, std::string* out) {
+  if (!out->empty())
+    out->push_back(',');
+  out->push_back('"');
+  out->append(name);
+  out->push_back('"');
+}
+
+std::string JoinNames(const std::set<std::string>& names) {
+  std::string result;
+  for (const std::string& name : names)
+    AppendName(name, &result);
+  return result;
+}
+
+}  // namespace
+
 // static
 const char Browser::kClassName[] = "Browser";
 
-Browser::Browser(const Options& options) {
+Browser::Browser(const Options& options)
+    : message_queue_limit_(kDefaultMessageQueueLimit) {
   PlatformInit(options);
   // Generate a random number as security key.
   base::Base64Encode(base::RandBytesAsString(16), &security_key_);
@@ -34,8 +165,8 @@ const char* Browser::GetClassName() const {
 
 void Browser::SetBindingName(const std::string& name) {
   base::EscapeJSONString(name, false, &binding_name_);
-  if (!stop_serving_)
-    PlatformUpdateBindings();
+  binding_name_changed_ = true;
+  UpdateBindings();
 }
 
 void Browser::AddRawBinding(const std::string& name, const BindingFunc& func) {
@@ -43,9 +174,21 @@ void Browser::AddRawBinding(const std::string& name, const BindingFunc& func) {
     return;
   std::string escaped;
   base::EscapeJSONString(name, false, &escaped);
+  // Replacing the handler of an existing binding does not change the page.
+  bool is_new = bindings_.find(escaped) == bindings_.end();
   bindings_[escaped] = func;
-  if (!stop_serving_)
-    PlatformUpdateBindings();
+  if (!is_new)
+    return;
+  removed_bindings_.erase(escaped);
+  added_bindings_.insert(escaped);
+  UpdateBindings();
+}
+
+void Browser::AddRawBindings(const std::map<std::string, BindingFunc>& funcs) {
+  BeginUpdateBindings();
+  for (const auto& it : funcs)
+    AddRawBinding(it.first, it.second);
+  EndUpdateBindings();
 }
 
 void Browser::RemoveBinding(const std::string& name) {
@@ -53,21 +196,39 @@ void Browser::RemoveBinding(const std::string& name) {
     return;
   std::string escaped;
   base::EscapeJSONString(name, false, &escaped);
-  bindings_.erase(escaped);
-  if (!stop_serving_)
-    PlatformUpdateBindings();
+  if (bindings_.erase(escaped) == 0)
+    return;
+  added_bindings_.erase(escaped);
+  removed_bindings_.insert(escaped);
+  UpdateBindings();
+}
+
+void Browser::BeginUpdateBindings() {
+  ++update_bindings_depth_;
+}
+
+void Browser::EndUpdateBindings() {
+  DCHECK_GT(update_bindings_depth_, 0);
+  if (--update_bindings_depth_ == 0)
+    UpdateBindings();
+}
+
+bool Browser::PostMessageToPage(base::Value message) {
+  std::string entry = base::StringPrintf("[%d,", PORT_MESSAGE);
+  SerializeValue(message, &entry);
+  entry.push_back(']');
+  return QueuePortEntry(entry);
+}
+
+void Browser::SetMessageQueueLimit(size_t limit) {
+  message_queue_limit_ = limit;
 }
 
 bool Browser::InvokeBindings(const std::string& key,
                              const std::string& method,
                              base::Value args) {
-  if (stop_serving_)
+  if (!CheckSecurityKey(key))
     return false;
-  if (key != security_key_) {
-    stop_serving_ = true;
-    LOG(ERROR) << "Recevied invalid key, stop serving navite bindings";
-    return false;
-  }
   auto it = bindings_.find(method);
   if (it == bindings_.end()) {
     LOG(ERROR) << "Invoking invalid method: " << method;
@@ -77,39 +238,198 @@ bool Browser::InvokeBindings(const std::string& key,
   return true;
 }
 
+bool Browser::InvokeMessagePort(const std::string& key, base::Value batch) {
+  if (!CheckSecurityKey(key))
+    return false;
+  // Keep the browser alive when handlers close it.
+  scoped_refptr<Browser> self(this);
+  for (base::Value& entry : batch.GetList()) {
+    if (!entry.is_list() || entry.GetList().size() < 2 ||
+        !entry.GetList()[0].is_int()) {
+      LOG(ERROR) << "Received invalid port message";
+      continue;
+    }
+    base::Value& payload = entry.GetList()[1];
+    int type = entry.GetList()[0].GetInt();
+    if (type == PORT_MESSAGE) {
+      if (handle_message)
+        handle_message(this, std::move(payload));
+    } else if (type == PORT_REQUEST && entry.GetList().size() == 3 &&
+               entry.GetList()[2].is_string()) {
+      std::string id;
+      base::EscapeJSONString(entry.GetList()[2].GetString(), true, &id);
+      ReplyCallback reply = [self, id](bool success, base::Value result) {
+        std::string code = base::StringPrintf(
+            "[%d,%s,%s,", PORT_REPLY, id.c_str(), success ? "true" : "false");
+        SerializeValue(result, &code);
+        code.push_back(']');
+        self->QueuePortEntry(code);
+      };
+      if (handle_request)
+        handle_request(this, std::move(payload), reply);
+      else
+        reply(false, base::Value("No handler for requests"));
+    } else {
+      LOG(ERROR) << "Received invalid port message";
+    }
+  }
+  return true;
+}
+
 std::string Browser::GetBindingScript() {
+  if (!binding_script_.empty())
+    return binding_script_;
   std::string code = "(function(key, external, binding) {";
-  std::string name = binding_name_;
-  if (name.empty()) {
-    name = "window";
-  } else {
+  std::string name = GetBindingObject();
+  if (!binding_name_.empty()) {
     // window[name] = {};
-    name = base::StringPrintf("window[\"%s\"]", name.c_str());
     code = name + " = {};" + code;
   }
   // Insert bindings.
-  for (const auto& it : bindings_) {
-    code += base::StringPrintf(
-        "binding[\"%s\"] = function() {"
-        "  var args = Array.prototype.slice.call(arguments);"
+  std::string names;
+  for (const auto& it : bindings_)
+    AppendName(it.first, &names);
+  code += base::StringPrintf("(%s)(key, external, binding, [%s], []);",
+                             kUpdateBindingsScript, names.c_str());
+  // Insert message port, messages from page are sent in batch after current
+  // task, and requests are matched with replies by ids.
+  code += base::StringPrintf(
+      "var queue = [], pending = {}, nextId = 0;"
+      "var session = Math.random().toString(36).slice(2) + ':';"
+      "function send(entry) {"
+      "  if (queue.length == 0) setTimeout(function() {"
+      "    var batch = queue;"
+      "    queue = [];"
 #if defined(OS_WIN)
-        // On WebKit we can only pass one argument.
-        "  external.postMessage(key, \"%s\", JSON.stringify(args));"
+      "    external.postMessage(key, JSON.stringify(batch));"
 #else
-        "  external.postMessage([key, \"%s\", args]);"
+      "    external.postMessage([key, batch]);"
 #endif
-        "};",
-        it.first.c_str(), it.first.c_str());
-  }
+      "  }, 0);"
+      "  queue.push(entry);"
+      "}"
+      "binding.messagePort = {"
+      "  onmessage: null,"
+      "  postMessage: function(message) {"
+      "    send([%d, message]);"
+      "  },"
+      "  request: function(message) {"
+      "    var id = session + (++nextId);"
+      "    return new Promise(function(resolve, reject) {"
+      "      pending[id] = [resolve, reject];"
+      "      send([%d, message, id]);"
+      "    });"
+      "  },"
+      "  _receive: function(batch) {"
+      "    for (var i = 0; i < batch.length; ++i) {"
+      "      var e = batch[i];"
+      "      try {"
+      "        if (e[0] == %d) {"
+      "          if (this.onmessage) this.onmessage(e[1]);"
+      "        } else if (e[0] == %d && pending[e[1]]) {"
+      "          var p = pending[e[1]];"
+      "          delete pending[e[1]];"
+      "          p[e[2] ? 0 : 1](e[3]);"
+      "        }"
+      "      } catch (error) {"
+      "        setTimeout(function() { throw error; }, 0);"
+      "      }"
+      "    }"
+      "  }"
+      "};",
+      PORT_MESSAGE, PORT_REQUEST, PORT_MESSAGE, PORT_REPLY);
   code += base::StringPrintf("})(\"%s\", %s, %s);",
-                             security_key_.c_str(),
-#if defined(OS_WIN)
-                             "window.external",
-#else
-                             "window.webkit.messageHandlers.yue",
-#endif
+                             security_key_.c_str(), kExternalObject,
                              name.c_str());
-  return code;
+  binding_script_ = std::move(code);
+  return binding_script_;
+}
+
+bool Browser::CheckSecurityKey(const std::string& key) {
+  if (stop_serving_)
+    return false;
+  if (key != security_key_) {
+    stop_serving_ = true;
+    LOG(ERROR) << "Recevied invalid key, stop serving navite bindings";
+    return false;
+  }
+  return true;
+}
+
+std::string Browser::GetBindingObject() const {
+  if (binding_name_.empty())
+    return "window";
+  return base::StringPrintf("window[\"%s\"]", binding_name_.c_str());
+}
+
+void Browser::UpdateBindings() {
+  // The script is generated again when it is needed.
+  binding_script_.clear();
+  if (update_bindings_depth_ > 0)
+    return;
+  std::string code;
+  if (!stop_serving_) {
+    PlatformUpdateBindings();
+    // Apply the changes to current page without reloading it.
+    if (binding_name_changed_) {
+      code = GetBindingScript();
+    } else if (!added_bindings_.empty() || !removed_bindings_.empty()) {
+      code = base::StringPrintf(
+          "(%s)(\"%s\", %s, %s, [%s], [%s]);",
+          kUpdateBindingsScript, security_key_.c_str(), kExternalObject,
+          GetBindingObject().c_str(), JoinNames(added_bindings_).c_str(),
+          JoinNames(removed_bindings_).c_str());
+    }
+  }
+  binding_name_changed_ = false;
+  added_bindings_.clear();
+  removed_bindings_.clear();
+  if (!code.empty())
+    ExecuteJavaScript(code, nullptr);
+}
+
+bool Browser::QueuePortEntry(const std::string& entry) {
+  if (!message_queue_.empty())
+    message_queue_.push_back(',');
+  message_queue_.append(entry);
+  ++queued_messages_;
+  // Only one batch is sent at a time, the queued messages are sent after
+  // current batch has been received.
+  if (!send_scheduled_ && sending_messages_ == 0) {
+    send_scheduled_ = true;
+    scoped_refptr<Browser> self(this);
+    MessageLoop::PostTask([self]() { self->SendPortMessages(); });
+  }
+  if (GetPendingMessageCount() < message_queue_limit_)
+    return true;
+  need_drain_ = true;
+  return false;
+}
+
+void Browser::SendPortMessages() {
+  send_scheduled_ = false;
+  if (queued_messages_ == 0 || sending_messages_ > 0)
+    return;
+  std::string port = GetBindingObject() + ".messagePort";
+  std::string code = base::StringPrintf(
+      "(function(b) {"
+      "  var p = %s;"
+      "  if (p) p._receive([%s]);"
+      "})(%s)",
+      port.c_str(), message_queue_.c_str(), kDecodeBinaryScript);
+  message_queue_.clear();
+  sending_messages_ = queued_messages_;
+  queued_messages_ = 0;
+  scoped_refptr<Browser> self(this);
+  ExecuteJavaScript(code, [self](bool success, base::Value) {
+    self->sending_messages_ = 0;
+    if (self->queued_messages_ > 0) {
+      self->SendPortMessages();
+    } else if (self->need_drain_) {
+      self->need_drain_ = false;
+      self->on_drain_messages.Emit(self.get());
+    }
+  });
 }
 
 }  // namespace nu
@@ -6,6 +6,7 @@
 #define NATIVEUI_BROWSER_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -21,6 +22,7 @@ class NATIVEUI_EXPORT Browser : public View {
   using ProtocolHandler = std::function<ProtocolJob*(const std::string&)>;
   using ExecutionCallback = std::function<void(bool, base::Value)>;
   using BindingFunc = std::function<void(Browser*, base::Value)>;
+  using ReplyCallback = std::function<void(bool, base::Value)>;
 
   struct Options {
     bool devtools = false;
@@ -60,7 +62,12 @@ class NATIVEUI_EXPORT Browser : public View {
 
   void SetBindingName(const std::string& name);
   void AddRawBinding(const std::string& name, const BindingFunc& func);
+  void AddRawBindings(const std::map<std::string, BindingFunc>& funcs);
   void RemoveBinding(const std::string& name);
+  // Changes to bindings made between the calls are applied together when the
+  // outermost EndUpdateBindings is called.
+  void BeginUpdateBindings();
+  void EndUpdateBindings();
 
   // Automatically deduce argument types.
   template<typename Sig>
@@ -77,6 +84,20 @@ class NATIVEUI_EXPORT Browser : public View {
     AddBinding(name, std::function<RunType>(func));
   }
 
+  // Message port APIs.
+  //
+  // Messages posted in the same turn of the event loop are delivered to the
+  // page with one script execution, and the next batch is only sent after
+  // the page has received the previous one. Return false when the number of
+  // pending messages has reached the queue limit, the message is still
+  // queued and on_drain_messages is emitted when the queue is emptied.
+  bool PostMessageToPage(base::Value message);
+  void SetMessageQueueLimit(size_t limit);
+  size_t GetMessageQueueLimit() const { return message_queue_limit_; }
+  size_t GetPendingMessageCount() const {
+    return queued_messages_ + sending_messages_;
+  }
+
   // Events.
   Signal<void(Browser*)> on_close;
   Signal<void(Browser*)> on_update_command;
@@ -86,12 +107,21 @@ class NATIVEUI_EXPORT Browser : public View {
   Signal<void(Browser*, const std::string&)> on_commit_navigation;
   Signal<void(Browser*, const std::string&, int)> on_fail_navigation;
   Signal<void(Browser*, const std::string&)> on_finish_navigation;
+  Signal<void(Browser*)> on_drain_messages;
+
+  // Delegates.
+  std::function<void(Browser*, base::Value)> handle_message;
+  std::function<void(Browser*, base::Value, const ReplyCallback&)>
+      handle_request;
 
   // Internal: Called from web pages to invoke native bindings.
   bool InvokeBindings(const std::string& key,
                       const std::string& name,
                       base::Value args);
 
+  // Internal: Called from web pages to deliver a batch of port messages.
+  bool InvokeMessagePort(const std::string& key, base::Value batch);
+
   // Internal: Generate the user script to inject bindings.
   std::string GetBindingScript();
 
@@ -106,12 +136,39 @@ class NATIVEUI_EXPORT Browser : public View {
   void PlatformDestroy();
   void PlatformUpdateBindings();
 
+  // Apply the changes of bindings to the user script and current page.
+  void UpdateBindings();
+
+  bool CheckSecurityKey(const std::string& key);
+  // Return the JavaScript expression of the object holding bindings.
+  std::string GetBindingObject() const;
+
+  // Append a serialized entry to the message queue.
+  bool QueuePortEntry(const std::string& entry);
+  void SendPortMessages();
+
   // Prevent malicous calls to native bindings.
   std::string security_key_;
   bool stop_serving_ = false;
 
   std::string binding_name_;
   std::map<std::string, BindingFunc> bindings_;
+
+  // The changes of bindings not applied to current page yet.
+  int update_bindings_depth_ = 0;
+  bool binding_name_changed_ = false;
+  std::set<std::string> added_bindings_;
+  std::set<std::string> removed_bindings_;
+  // Cached result of GetBindingScript.
+  std::string binding_script_;
+
+  // The entries of the message port waiting to be sent, joined by commas.
+  std::string message_queue_;
+  size_t queued_messages_ = 0;
+  size_t sending_messages_ = 0;
+  size_t message_queue_limit_;
+  bool send_scheduled_ = false;
+  bool need_drain_ = false;
 };
 
 }  // namespace nu
@@ -235,6 +235,41 @@ TEST_F(BrowserTest, ExecuteJavaScriptComplexResult) {
   nu::MessageLoop::Run();
 }
 
+#if defined(OS_LINUX)
+TEST_F(BrowserTest, ExecuteJavaScriptBinaryResult) {
+  browser_->on_finish_navigation.Connect([](nu::Browser* browser,
+                                            const std::string& url) {
+    browser->ExecuteJavaScript(
+        "r = {u: new Uint8Array([1, 2, 3]).subarray(1),"
+        "     b: new Uint16Array([0x0201]).buffer,"
+        "     n: [1.5, NaN, undefined], f: function() {}}; r.s = r; r",
+        [](bool success, base::Value result) {
+      nu::MessageLoop::Quit();
+      ASSERT_EQ(success, true);
+      ASSERT_TRUE(result.is_dict());
+      const base::Value* u = result.FindKey("u");
+      ASSERT_TRUE(u && u->is_blob());
+      EXPECT_EQ(u->GetBlob(), base::Value::BlobStorage({2, 3}));
+      const base::Value* b = result.FindKey("b");
+      ASSERT_TRUE(b && b->is_blob());
+      EXPECT_EQ(b->GetBlob(), base::Value::BlobStorage({1, 2}));
+      std::string json;
+      ASSERT_TRUE(base::JSONWriter::Write(*result.FindKey("n"), &json));
+      EXPECT_EQ(json, "[1.5,null,null]");
+      EXPECT_FALSE(result.FindKey("f"));
+      // Cycles are converted to null.
+      const base::Value* s = result.FindKey("s");
+      ASSERT_TRUE(s);
+      EXPECT_TRUE(s->is_none());
+    });
+  });
+  nu::MessageLoop::PostTask([&]() {
+    browser_->LoadURL("about:blank");
+  });
+  nu::MessageLoop::Run();
+}
+#endif
+
 TEST_F(BrowserTest, AddBinding) {
   bool bo = false;
   std::string st;
@@ -295,6 +330,105 @@ TEST_F(BrowserTest, SetBindingName) {
   nu::MessageLoop::Run();
 }
 
+#if !defined(OS_WIN)
+TEST_F(BrowserTest, MessagePort) {
+  browser_->handle_message = [](nu::Browser*, base::Value message) {
+    nu::MessageLoop::Quit();
+    EXPECT_EQ(message, base::Value(8));
+  };
+  browser_->handle_request = [](nu::Browser*, base::Value message,
+                                const nu::Browser::ReplyCallback& reply) {
+    ASSERT_TRUE(message.is_int());
+    reply(true, base::Value(message.GetInt() * 2));
+  };
+  browser_->on_finish_navigation.Connect([](nu::Browser* browser,
+                                            const std::string& url) {
+    browser->ExecuteJavaScript(
+        "var got = [];"
+        "window.messagePort.onmessage = function(m) {"
+        "  got.push(m);"
+        "  if (got.length != 3) return;"
+        "  window.messagePort.request(got[0] + got[2].length).then("
+        "      function(r) { window.messagePort.postMessage(r); });"
+        "}",
+        [browser](bool success, base::Value result) {
+      EXPECT_EQ(success, true);
+      // All three messages are sent in one batch.
+      EXPECT_TRUE(browser->PostMessageToPage(base::Value(1)));
+      EXPECT_TRUE(browser->PostMessageToPage(base::Value("s")));
+      EXPECT_TRUE(browser->PostMessageToPage(
+          base::Value(base::Value::BlobStorage({1, 2, 3}))));
+      EXPECT_EQ(browser->GetPendingMessageCount(), 3u);
+    });
+  });
+  nu::MessageLoop::PostTask([&]() {
+    browser_->LoadHTML("<body><script></script></body>", "about:blank");
+  });
+  nu::MessageLoop::Run();
+}
+#endif
+
+TEST_F(BrowserTest, MessageQueueLimit) {
+  browser_->SetMessageQueueLimit(2);
+  browser_->on_drain_messages.Connect([](nu::Browser* browser) {
+    nu::MessageLoop::Quit();
+    EXPECT_EQ(browser->GetPendingMessageCount(), 0u);
+  });
+  browser_->on_finish_navigation.Connect([](nu::Browser* browser,
+                                            const std::string& url) {
+    EXPECT_TRUE(browser->PostMessageToPage(base::Value(1)));
+    EXPECT_FALSE(browser->PostMessageToPage(base::Value(2)));
+    EXPECT_EQ(browser->GetPendingMessageCount(), 2u);
+  });
+  nu::MessageLoop::PostTask([&]() {
+    browser_->LoadHTML("<body><script></script></body>", "about:blank");
+  });
+  nu::MessageLoop::Run();
+}
+
+TEST_F(BrowserTest, AddBindingToLoadedPage) {
+  browser_->on_finish_navigation.Connect([](nu::Browser* browser,
+                                            const std::string& url) {
+    browser->AddRawBinding("method", [](nu::Browser*, base::Value args) {
+      nu::MessageLoop::Quit();
+      EXPECT_EQ(args.GetList().size(), 1u);
+    });
+    browser->ExecuteJavaScript("window.method(1)",
+                               [](bool success, base::Value result) {
+      EXPECT_EQ(success, true);
+    });
+  });
+  nu::MessageLoop::PostTask([&]() {
+    browser_->LoadHTML("<body><script></script></body>", "about:blank");
+  });
+  nu::MessageLoop::Run();
+}
+
+TEST_F(BrowserTest, UpdateBindings) {
+  browser_->AddRawBinding("removed", [](nu::Browser*, base::Value) {});
+  browser_->on_finish_navigation.Connect([](nu::Browser* browser,
+                                            const std::string& url) {
+    browser->BeginUpdateBindings();
+    std::map<std::string, nu::Browser::BindingFunc> funcs;
+    funcs["a"] = [](nu::Browser*, base::Value) {};
+    funcs["b"] = [](nu::Browser*, base::Value) {};
+    browser->AddRawBindings(funcs);
+    browser->RemoveBinding("removed");
+    browser->EndUpdateBindings();
+    browser->ExecuteJavaScript(
+        "[typeof window.a, typeof window.b, typeof window.removed].join()",
+        [](bool success, base::Value result) {
+      nu::MessageLoop::Quit();
+      EXPECT_EQ(success, true);
+      EXPECT_EQ(result, base::Value("function,function,undefined"));
+    });
+  });
+  nu::MessageLoop::PostTask([&]() {
+    browser_->LoadHTML("<body><script></script></body>", "about:blank");
+  });
+  nu::MessageLoop::Run();
+}
+
 TEST_F(BrowserTest, MalicousCall) {
   bool called = false;
   browser_->AddRawBinding("method", [&called](nu::Browser*, base::Value) {
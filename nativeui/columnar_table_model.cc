@@ -0,0 +1,338 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/columnar_table_model.h"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace nu {
+
+namespace {
+
+// Approximate overhead of a node in std::unordered_map.
+const size_t kHashNodeSize = sizeof(void*) * 2 + sizeof(size_t);
+
+// Numbers from script are usually doubles, so integral doubles are accepted
+// as long as they fit in int.
+bool ToInteger(const base::Value& value, int* out) {
+  if (value.is_int()) {
+    *out = value.GetInt();
+    return true;
+  }
+  if (!value.is_double())
+    return false;
+  double number = value.GetDouble();
+  if (std::trunc(number) != number ||
+      number < std::numeric_limits<int>::min() ||
+      number > std::numeric_limits<int>::max())
+    return false;
+  *out = static_cast<int>(number);
+  return true;
+}
+
+}  // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// ColumnarTableModel::StringPool implementation.
+
+ColumnarTableModel::StringPool::StringPool() {}
+
+ColumnarTableModel::StringPool::~StringPool() {}
+
+uint32_t ColumnarTableModel::StringPool::Intern(const std::string& str) {
+  auto it = indexes_.find(str);
+  if (it != indexes_.end()) {
+    ++entries_[it->second].refs;
+    return it->second;
+  }
+  uint32_t index;
+  if (free_.empty()) {
+    index = static_cast<uint32_t>(entries_.size());
+    entries_.emplace_back();
+  } else {
+    index = free_.back();
+    free_.pop_back();
+  }
+  Entry& entry = entries_[index];
+  entry.str = str;
+  entry.refs = 1;
+  indexes_[entry.str] = index;
+  return index;
+}
+
+void ColumnarTableModel::StringPool::Release(uint32_t index) {
+  Entry& entry = entries_[index];
+  DCHECK_GT(entry.refs, 0u);
+  if (--entry.refs > 0)
+    return;
+  indexes_.erase(entry.str);
+  // Use swap to actually free the memory, the slot is reused by next string.
+  std::string().swap(entry.str);
+  free_.push_back(index);
+}
+
+void ColumnarTableModel::StringPool::Clear() {
+  indexes_.clear();
+  entries_.clear();
+  std::vector<uint32_t>().swap(free_);
+}
+
+size_t ColumnarTableModel::StringPool::GetMemoryUsage() const {
+  size_t size = entries_.size() * sizeof(Entry) +
+                free_.capacity() * sizeof(uint32_t);
+  for (const Entry& entry : entries_) {
+    if (entry.refs > 0)
+      size += entry.str.capacity();
+  }
+  size += indexes_.size() *
+          (sizeof(base::StringPiece) + sizeof(uint32_t) + kHashNodeSize);
+  size += indexes_.bucket_count() * sizeof(void*);
+  return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ColumnarTableModel::Column implementation.
+
+ColumnarTableModel::Column::Column(ValueType type) : type(type) {}
+
+ColumnarTableModel::Column::~Column() {}
+
+bool ColumnarTableModel::Column::Accepts(const base::Value& value) const {
+  int integer;
+  return type != ValueType::Integer || ToInteger(value, &integer);
+}
+
+void ColumnarTableModel::Column::Append(const base::Value& value) {
+  DCHECK(Accepts(value));
+  int integer = 0;
+  switch (type) {
+    case ValueType::Integer:
+      ToInteger(value, &integer);
+      integers.push_back(integer);
+      break;
+    case ValueType::Double:
+      doubles.push_back(value.is_int() || value.is_double() ?
+                        value.GetDouble() : 0.);
+      break;
+    case ValueType::String:
+      strings.push_back(pool.Intern(value.is_string() ? value.GetString()
+                                                      : std::string()));
+      break;
+    case ValueType::Boolean:
+      booleans.push_back(value.is_bool() ? value.GetBool() : false);
+      break;
+  }
+}
+
+void ColumnarTableModel::Column::Set(uint32_t row, const base::Value& value) {
+  DCHECK(Accepts(value));
+  switch (type) {
+    case ValueType::Integer:
+      ToInteger(value, &integers[row]);
+      break;
+    case ValueType::Double:
+      doubles[row] = value.is_int() || value.is_double() ?
+                     value.GetDouble() : 0.;
+      break;
+    case ValueType::String: {
+      // Intern before releasing so setting the same string keeps its entry.
+      uint32_t old_index = strings[row];
+      strings[row] = pool.Intern(value.is_string() ? value.GetString()
+                                                   : std::string());
+      pool.Release(old_index);
+      break;
+    }
+    case ValueType::Boolean:
+      booleans[row] = value.is_bool() ? value.GetBool() : false;
+      break;
+  }
+}
+
+void ColumnarTableModel::Column::Erase(uint32_t start, uint32_t count) {
+  switch (type) {
+    case ValueType::Integer:
+      integers.erase(integers.begin() + start,
+                     integers.begin() + start + count);
+      break;
+    case ValueType::Double:
+      doubles.erase(doubles.begin() + start, doubles.begin() + start + count);
+      break;
+    case ValueType::String:
+      for (uint32_t i = start; i < start + count; ++i)
+        pool.Release(strings[i]);
+      strings.erase(strings.begin() + start, strings.begin() + start + count);
+      break;
+    case ValueType::Boolean:
+      booleans.erase(booleans.begin() + start,
+                     booleans.begin() + start + count);
+      break;
+  }
+}
+
+void ColumnarTableModel::Column::Clear() {
+  // Use swap to actually free the memory.
+  std::vector<int>().swap(integers);
+  std::vector<double>().swap(doubles);
+  std::vector<uint32_t>().swap(strings);
+  std::vector<bool>().swap(booleans);
+  pool.Clear();
+}
+
+size_t ColumnarTableModel::Column::GetMemoryUsage() const {
+  return integers.capacity() * sizeof(int) +
+         doubles.capacity() * sizeof(double) +
+         strings.capacity() * sizeof(uint32_t) +
+         booleans.capacity() / 8 +
+         pool.GetMemoryUsage();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ColumnarTableModel implementation.
+
+ColumnarTableModel::ColumnarTableModel(std::vector<ValueType> types)
+    : copies_(types.size()) {
+  for (ValueType type : types)
+    columns_.push_back(std::make_unique<Column>(type));
+}
+
+ColumnarTableModel::~ColumnarTableModel() {}
+
+void ColumnarTableModel::AddRow(const Row& row) {
+  AddRows({row});
+}
+
+void ColumnarTableModel::AddRows(const std::vector<Row>& rows) {
+  uint32_t start = row_count_;
+  for (const Row& row : rows) {
+    if (row.size() < columns_.size()) {
+      LOG(ERROR) << "AddRows skipped a row because row length is less than "
+                    "column size.";
+      continue;
+    }
+    if (!AcceptsRow(row)) {
+      LOG(ERROR) << "AddRows skipped a row because it has a value that does "
+                    "not fit in integer column.";
+      continue;
+    }
+    for (size_t i = 0; i < columns_.size(); ++i)
+      columns_[i]->Append(row[i]);
+    ++row_count_;
+  }
+  NotifyRowsInserted(start, row_count_ - start);
+}
+
+void ColumnarTableModel::RemoveRows(uint32_t start, uint32_t count) {
+  if (start >= row_count_ || count > row_count_ - start) {
+    LOG(ERROR) << "RemoveRows failed because range is not in model.";
+    return;
+  }
+  for (const auto& column : columns_)
+    column->Erase(start, count);
+  row_count_ -= count;
+  NotifyRowsDeleted(start, count);
+}
+
+void ColumnarTableModel::Clear() {
+  uint32_t count = row_count_;
+  for (const auto& column : columns_)
+    column->Clear();
+  row_count_ = 0;
+  NotifyRowsDeleted(0, count);
+}
+
+ColumnarTableModel::ValueType ColumnarTableModel::GetColumnType(
+    uint32_t column) const {
+  return columns_[column]->type;
+}
+
+int ColumnarTableModel::GetInteger(uint32_t column, uint32_t row) const {
+  DCHECK(IsValidCell(column, row));
+  DCHECK(columns_[column]->type == ValueType::Integer);
+  return columns_[column]->integers[row];
+}
+
+double ColumnarTableModel::GetDouble(uint32_t column, uint32_t row) const {
+  DCHECK(IsValidCell(column, row));
+  DCHECK(columns_[column]->type == ValueType::Double);
+  return columns_[column]->doubles[row];
+}
+
+const std::string& ColumnarTableModel::GetString(uint32_t column,
+                                                 uint32_t row) const {
+  DCHECK(IsValidCell(column, row));
+  DCHECK(columns_[column]->type == ValueType::String);
+  const Column& col = *columns_[column];
+  return col.pool.Get(col.strings[row]);
+}
+
+bool ColumnarTableModel::GetBoolean(uint32_t column, uint32_t row) const {
+  DCHECK(IsValidCell(column, row));
+  DCHECK(columns_[column]->type == ValueType::Boolean);
+  return columns_[column]->booleans[row];
+}
+
+size_t ColumnarTableModel::GetMemoryUsage() const {
+  size_t size = 0;
+  for (const auto& column : columns_)
+    size += sizeof(Column) + column->GetMemoryUsage();
+  return size;
+}
+
+uint32_t ColumnarTableModel::GetRowCount() const {
+  return row_count_;
+}
+
+const base::Value* ColumnarTableModel::GetValue(uint32_t column,
+                                                uint32_t row) const {
+  if (!IsValidCell(column, row))
+    return nullptr;
+  base::Value& copy = copies_[column];
+  switch (columns_[column]->type) {
+    case ValueType::Integer:
+      copy = base::Value(GetInteger(column, row));
+      break;
+    case ValueType::Double:
+      copy = base::Value(GetDouble(column, row));
+      break;
+    case ValueType::String:
+      copy = base::Value(GetString(column, row));
+      break;
+    case ValueType::Boolean:
+      copy = base::Value(GetBoolean(column, row));
+      break;
+  }
+  return &copy;
+}
+
+void ColumnarTableModel::SetValue(uint32_t column, uint32_t row,
+                                  base::Value value) {
+  if (!IsValidCell(column, row))
+    return;
+  if (!columns_[column]->Accepts(value)) {
+    LOG(ERROR) << "SetValue failed because value does not fit in integer "
+                  "column.";
+    return;
+  }
+  columns_[column]->Set(row, value);
+  NotifyValueChange(column, row);
+}
+
+bool ColumnarTableModel::AcceptsRow(const Row& row) const {
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    if (!columns_[i]->Accepts(row[i]))
+      return false;
+  }
+  return true;
+}
+
+bool ColumnarTableModel::IsValidCell(uint32_t column, uint32_t row) const {
+  return column < columns_.size() && row < row_count_;
+}
+
+}  // namespace nu
@@ -0,0 +1,130 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_COLUMNAR_TABLE_MODEL_H_
+#define NATIVEUI_COLUMNAR_TABLE_MODEL_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "nativeui/table_model.h"
+
+namespace nu {
+
+// A TableModel that stores each column in a typed array, which uses much
+// less memory than SimpleTableModel for large data sets.
+//
+// Repeated strings in a column are stored only once.
+class NATIVEUI_EXPORT ColumnarTableModel : public TableModel {
+ public:
+  enum class ValueType {
+    Integer,
+    Double,
+    String,
+    Boolean,
+  };
+
+  using Row = std::vector<base::Value>;
+
+  explicit ColumnarTableModel(std::vector<ValueType> types);
+
+  // Batch operations, which only notify the table once.
+  void AddRow(const Row& row);
+  void AddRows(const std::vector<Row>& rows);
+  void RemoveRows(uint32_t start, uint32_t count);
+  void Clear();
+
+  // Read values without converting to base::Value.
+  ValueType GetColumnType(uint32_t column) const;
+  int GetInteger(uint32_t column, uint32_t row) const;
+  double GetDouble(uint32_t column, uint32_t row) const;
+  const std::string& GetString(uint32_t column, uint32_t row) const;
+  bool GetBoolean(uint32_t column, uint32_t row) const;
+
+  // Return the approximate memory used by the stored data.
+  size_t GetMemoryUsage() const;
+
+  // TableModel:
+  uint32_t GetRowCount() const override;
+  const base::Value* GetValue(uint32_t column, uint32_t row) const override;
+  void SetValue(uint32_t column, uint32_t row, base::Value value) override;
+
+ protected:
+  ~ColumnarTableModel() override;
+
+ private:
+  // Interned strings of a column.
+  //
+  // Each call to Intern adds a reference to the string, and the string is
+  // freed when all references are released.
+  class StringPool {
+   public:
+    StringPool();
+    ~StringPool();
+
+    uint32_t Intern(const std::string& str);
+    void Release(uint32_t index);
+    const std::string& Get(uint32_t index) const {
+      return entries_[index].str;
+    }
+    void Clear();
+    size_t GetMemoryUsage() const;
+
+   private:
+    struct Entry {
+      std::string str;
+      uint32_t refs = 0;
+    };
+
+    // Deque does not move elements, so the keys of |indexes_| stay valid.
+    std::deque<Entry> entries_;
+    // Indexes of released entries that can be reused.
+    std::vector<uint32_t> free_;
+    std::unordered_map<base::StringPiece, uint32_t, base::StringPieceHash>
+        indexes_;
+
+    DISALLOW_COPY_AND_ASSIGN(StringPool);
+  };
+
+  struct Column {
+    explicit Column(ValueType type);
+    ~Column();
+
+    // Integer columns only accept integers and integral doubles in the range
+    // of int, other columns store values of wrong type as default values.
+    bool Accepts(const base::Value& value) const;
+    void Append(const base::Value& value);
+    void Set(uint32_t row, const base::Value& value);
+    void Erase(uint32_t start, uint32_t count);
+    void Clear();
+    size_t GetMemoryUsage() const;
+
+    ValueType type;
+    // Only the array of |type| is used.
+    std::vector<int> integers;
+    std::vector<double> doubles;
+    std::vector<uint32_t> strings;
+    std::vector<bool> booleans;
+    StringPool pool;
+
+    DISALLOW_COPY_AND_ASSIGN(Column);
+  };
+
+  bool AcceptsRow(const Row& row) const;
+  bool IsValidCell(uint32_t column, uint32_t row) const;
+
+  std::vector<std::unique_ptr<Column>> columns_;
+  uint32_t row_count_ = 0;
+
+  // GetValue returns a reference to the copy of each column.
+  mutable std::vector<base::Value> copies_;
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_COLUMNAR_TABLE_MODEL_H_
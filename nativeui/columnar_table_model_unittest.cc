@@ -0,0 +1,161 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "base/strings/stringprintf.h"
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using ValueType = nu::ColumnarTableModel::ValueType;
+
+class ColumnarTableModelTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = new nu::ColumnarTableModel({ValueType::Integer,
+                                         ValueType::Double,
+                                         ValueType::String,
+                                         ValueType::Boolean});
+  }
+
+  nu::ColumnarTableModel::Row CreateRow(int i, const std::string& str) {
+    nu::ColumnarTableModel::Row row;
+    row.emplace_back(i);
+    row.emplace_back(i / 2.);
+    row.emplace_back(str);
+    row.emplace_back(i % 2 == 0);
+    return row;
+  }
+
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  scoped_refptr<nu::ColumnarTableModel> model_;
+};
+
+TEST_F(ColumnarTableModelTest, TypedValues) {
+  model_->AddRow(CreateRow(3, "abc"));
+  ASSERT_EQ(model_->GetRowCount(), 1u);
+  EXPECT_EQ(model_->GetInteger(0, 0), 3);
+  EXPECT_EQ(model_->GetDouble(1, 0), 1.5);
+  EXPECT_EQ(model_->GetString(2, 0), "abc");
+  EXPECT_EQ(model_->GetBoolean(3, 0), false);
+  EXPECT_EQ(*model_->GetValue(0, 0), base::Value(3));
+  EXPECT_EQ(*model_->GetValue(2, 0), base::Value("abc"));
+  EXPECT_EQ(model_->GetValue(4, 0), nullptr);
+  EXPECT_EQ(model_->GetValue(0, 1), nullptr);
+}
+
+TEST_F(ColumnarTableModelTest, ValuesOfRowStayValid) {
+  model_->AddRow(CreateRow(3, "abc"));
+  const base::Value* integer = model_->GetValue(0, 0);
+  const base::Value* str = model_->GetValue(2, 0);
+  EXPECT_EQ(*integer, base::Value(3));
+  EXPECT_EQ(*str, base::Value("abc"));
+}
+
+TEST_F(ColumnarTableModelTest, SetValue) {
+  model_->AddRow(CreateRow(0, "a"));
+  model_->SetValue(0, 0, base::Value(42));
+  model_->SetValue(2, 0, base::Value("b"));
+  // Values of wrong type become default values.
+  model_->SetValue(3, 0, base::Value("true"));
+  EXPECT_EQ(model_->GetInteger(0, 0), 42);
+  EXPECT_EQ(model_->GetString(2, 0), "b");
+  EXPECT_EQ(model_->GetBoolean(3, 0), false);
+}
+
+TEST_F(ColumnarTableModelTest, IntegerColumnFromDouble) {
+  nu::ColumnarTableModel::Row row = CreateRow(0, "a");
+  row[0] = base::Value(3.);
+  model_->AddRow(row);
+  ASSERT_EQ(model_->GetRowCount(), 1u);
+  EXPECT_EQ(model_->GetInteger(0, 0), 3);
+  // Values that do not fit in integer are rejected.
+  row[0] = base::Value(3.5);
+  model_->AddRow(row);
+  row[0] = base::Value(1e10);
+  model_->AddRow(row);
+  EXPECT_EQ(model_->GetRowCount(), 1u);
+  model_->SetValue(0, 0, base::Value(-7.));
+  EXPECT_EQ(model_->GetInteger(0, 0), -7);
+  model_->SetValue(0, 0, base::Value(0.5));
+  model_->SetValue(0, 0, base::Value("1"));
+  EXPECT_EQ(model_->GetInteger(0, 0), -7);
+}
+
+TEST_F(ColumnarTableModelTest, InternStrings) {
+  std::vector<nu::ColumnarTableModel::Row> rows;
+  for (int i = 0; i < 1000; ++i)
+    rows.push_back(CreateRow(i, "a long string that repeats in every row"));
+  model_->AddRows(rows);
+  size_t usage = model_->GetMemoryUsage();
+  rows.clear();
+  for (int i = 0; i < 1000; ++i)
+    rows.push_back(CreateRow(i, base::StringPrintf("unique string %d", i)));
+  model_->AddRows(rows);
+  EXPECT_EQ(model_->GetRowCount(), 2000u);
+  EXPECT_EQ(model_->GetString(2, 0), model_->GetString(2, 999));
+  EXPECT_EQ(model_->GetString(2, 1999), "unique string 999");
+  // Unique strings take more memory than repeated ones.
+  EXPECT_GT(model_->GetMemoryUsage() - usage, usage);
+}
+
+TEST_F(ColumnarTableModelTest, ReleaseStrings) {
+  model_->AddRow(CreateRow(0, "a"));
+  model_->SetValue(2, 0, base::Value("string 0"));
+  size_t usage = model_->GetMemoryUsage();
+  // Replaced strings are freed.
+  for (int i = 1; i < 1000; ++i)
+    model_->SetValue(2, 0, base::Value(base::StringPrintf("string %d", i)));
+  EXPECT_EQ(model_->GetString(2, 0), "string 999");
+  EXPECT_EQ(model_->GetMemoryUsage(), usage);
+  // Removed strings are freed, and their slots are reused.
+  std::vector<nu::ColumnarTableModel::Row> rows;
+  for (int i = 0; i < 1000; ++i)
+    rows.push_back(CreateRow(i, base::StringPrintf("removed string %d", i)));
+  model_->AddRows(rows);
+  size_t full_usage = model_->GetMemoryUsage();
+  model_->RemoveRows(1, 1000);
+  EXPECT_LT(model_->GetMemoryUsage(), full_usage - 1000 * 16);
+  model_->AddRow(CreateRow(1, "b"));
+  model_->AddRow(CreateRow(2, "string 999"));
+  EXPECT_EQ(model_->GetString(2, 1), "b");
+  EXPECT_EQ(model_->GetString(2, 2), "string 999");
+  model_->SetValue(2, 0, base::Value("c"));
+  EXPECT_EQ(model_->GetString(2, 2), "string 999");
+}
+
+TEST_F(ColumnarTableModelTest, BulkOperations) {
+  std::vector<nu::ColumnarTableModel::Row> rows;
+  for (int i = 0; i < 10; ++i)
+    rows.push_back(CreateRow(i, "s"));
+  // Short rows are skipped.
+  rows.push_back(nu::ColumnarTableModel::Row());
+  model_->AddRows(rows);
+  EXPECT_EQ(model_->GetRowCount(), 10u);
+  model_->RemoveRows(2, 5);
+  EXPECT_EQ(model_->GetRowCount(), 5u);
+  EXPECT_EQ(model_->GetInteger(0, 1), 1);
+  EXPECT_EQ(model_->GetInteger(0, 2), 7);
+  // Out of range.
+  model_->RemoveRows(3, 10);
+  EXPECT_EQ(model_->GetRowCount(), 5u);
+  model_->Clear();
+  EXPECT_EQ(model_->GetRowCount(), 0u);
+}
+
+TEST_F(ColumnarTableModelTest, WithTable) {
+  scoped_refptr<nu::Table> table = new nu::Table;
+  table->AddColumn("A");
+  table->SetModel(model_.get());
+  std::vector<nu::ColumnarTableModel::Row> rows;
+  for (int i = 0; i < 100; ++i)
+    rows.push_back(CreateRow(i, "s"));
+  model_->AddRows(rows);
+  table->SelectRow(99);
+  EXPECT_EQ(table->GetSelectedRow(), 99);
+  model_->RemoveRows(50, 50);
+  table->SelectRow(10);
+  EXPECT_EQ(table->GetSelectedRow(), 10);
+  model_->Clear();
+  EXPECT_EQ(table->GetSelectedRow(), -1);
+}
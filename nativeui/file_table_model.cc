@@ -0,0 +1,251 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/file_table_model.h"
+
+#if defined(OS_POSIX)
+#include <sys/mman.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/logging.h"
+#include "nativeui/message_loop.h"
+
+namespace nu {
+
+namespace {
+
+// How many rows share one 64bit offset in the index.
+const uint32_t kRowsPerBlock = 64;
+
+// How many parsed rows are kept.
+const size_t kMaxCachedRows = 256;
+
+// How often the indexing thread sends rows to the model.
+const int kIndexBatchIntervalMs = 100;
+
+// Parse the cells of the row starting at |begin|, and return where the next
+// row starts.
+const char* ParseRow(const char* begin, const char* end, char delimiter,
+                     std::vector<std::string>* cells) {
+  std::string cell;
+  bool in_quotes = false;
+  const char* p = begin;
+  for (; p < end; ++p) {
+    char c = *p;
+    if (in_quotes) {
+      if (c != '"') {
+        cell.push_back(c);
+      } else if (p + 1 < end && p[1] == '"') {
+        // Escaped quote.
+        cell.push_back('"');
+        ++p;
+      } else {
+        in_quotes = false;
+      }
+    } else if (c == '"') {
+      in_quotes = true;
+    } else if (c == delimiter) {
+      cells->push_back(std::move(cell));
+      cell.clear();
+    } else if (c == '\n') {
+      ++p;
+      break;
+    } else if (c != '\r') {
+      cell.push_back(c);
+    }
+  }
+  cells->push_back(std::move(cell));
+  return p;
+}
+
+}  // namespace
+
+// State shared with the indexing thread.
+struct FileTableModel::IndexJob {
+  // Only read after indexing starts.
+  base::MemoryMappedFile file;
+  std::atomic<bool> cancelled{false};
+  // Only accessed on main thread, reset when the model stops indexing.
+  FileTableModel* model = nullptr;
+};
+
+// static
+void FileTableModel::IndexRows(std::shared_ptr<IndexJob> job, size_t start) {
+  const char* data = reinterpret_cast<const char*>(job->file.data());
+  size_t size = job->file.length();
+  auto post = [job, size](std::vector<uint64_t>* offsets, size_t pos,
+                          bool done) {
+    auto rows = std::make_shared<std::vector<uint64_t>>();
+    rows->swap(*offsets);
+    float progress = size > 0 ? static_cast<float>(pos) / size : 1.f;
+    MessageLoop::PostTask([job, rows, progress, done]() {
+      if (job->model)
+        job->model->OnRowsIndexed(*rows, progress, done);
+    });
+  };
+
+  std::vector<uint64_t> offsets;
+  auto last_post = std::chrono::steady_clock::now();
+  bool in_quotes = false;
+  size_t row_start = start;
+  for (size_t i = start; i < size; ++i) {
+    char c = data[i];
+    if (c == '"') {
+      in_quotes = !in_quotes;
+    } else if (c == '\n' && !in_quotes) {
+      // Skip empty lines.
+      if (i > row_start && !(i == row_start + 1 && data[row_start] == '\r'))
+        offsets.push_back(row_start);
+      row_start = i + 1;
+      if (offsets.size() % 4096 == 0 && !offsets.empty()) {
+        if (job->cancelled)
+          return;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_post >=
+            std::chrono::milliseconds(kIndexBatchIntervalMs)) {
+          post(&offsets, i, false);
+          last_post = now;
+        }
+      }
+    }
+  }
+  if (row_start < size)
+    offsets.push_back(row_start);
+  post(&offsets, size, true);
+}
+
+FileTableModel::FileTableModel(char delimiter, bool has_header)
+    : delimiter_(delimiter), has_header_(has_header) {}
+
+FileTableModel::~FileTableModel() {
+  if (job_) {
+    job_->cancelled = true;
+    job_->model = nullptr;
+  }
+}
+
+bool FileTableModel::Open(const base::FilePath& path) {
+  Close();
+  auto job = std::make_shared<IndexJob>();
+  if (!job->file.Initialize(path))
+    return false;
+#if defined(OS_POSIX)
+  // Indexing reads the file from start to end.
+  if (job->file.length() > 0)
+    madvise(const_cast<uint8_t*>(job->file.data()), job->file.length(),
+            MADV_SEQUENTIAL);
+#endif
+
+  size_t start = 0;
+  if (has_header_ && job->file.length() > 0) {
+    const char* data = reinterpret_cast<const char*>(job->file.data());
+    const char* end = ParseRow(data, data + job->file.length(), delimiter_,
+                               &header_);
+    start = end - data;
+  }
+
+  job->model = this;
+  job_ = job;
+  indexing_ = true;
+  std::thread(&IndexRows, job, start).detach();
+  return true;
+}
+
+void FileTableModel::Close() {
+  if (!job_)
+    return;
+  job_->cancelled = true;
+  job_->model = nullptr;
+  job_.reset();
+  indexing_ = false;
+  header_.clear();
+  rows_.clear();
+  rows_map_.clear();
+  uint32_t count = GetRowCount();
+  std::vector<uint64_t>().swap(block_offsets_);
+  std::vector<uint32_t>().swap(row_offsets_);
+  NotifyRowsDeleted(0, count);
+}
+
+size_t FileTableModel::GetIndexMemoryUsage() const {
+  return block_offsets_.capacity() * sizeof(uint64_t) +
+         row_offsets_.capacity() * sizeof(uint32_t);
+}
+
+uint32_t FileTableModel::GetRowCount() const {
+  return static_cast<uint32_t>(row_offsets_.size());
+}
+
+const base::Value* FileTableModel::GetValue(uint32_t column,
+                                            uint32_t row) const {
+  if (row >= row_offsets_.size())
+    return nullptr;
+
+  auto it = rows_map_.find(row);
+  if (it != rows_map_.end()) {
+    // Move to front.
+    rows_.splice(rows_.begin(), rows_, it->second);
+  } else {
+    const char* data = reinterpret_cast<const char*>(job_->file.data());
+    std::vector<std::string> cells;
+    ParseRow(data + GetRowOffset(row), data + job_->file.length(), delimiter_,
+             &cells);
+    Row values;
+    values.reserve(cells.size());
+    for (std::string& cell : cells)
+      values.emplace_back(std::move(cell));
+    rows_.emplace_front(row, std::move(values));
+    rows_map_[row] = rows_.begin();
+    if (rows_.size() > kMaxCachedRows) {
+      rows_map_.erase(rows_.back().first);
+      rows_.pop_back();
+    }
+  }
+
+  const Row& values = rows_.front().second;
+  if (column >= values.size())
+    return nullptr;
+  return &values[column];
+}
+
+void FileTableModel::SetValue(uint32_t column, uint32_t row,
+                              base::Value value) {
+  LOG(ERROR) << "FileTableModel is read-only.";
+}
+
+void FileTableModel::OnRowsIndexed(const std::vector<uint64_t>& offsets,
+                                   float progress,
+                                   bool done) {
+  uint32_t start = GetRowCount();
+  for (uint64_t offset : offsets)
+    AppendRowOffset(offset);
+  if (done) {
+    indexing_ = false;
+    job_->model = nullptr;
+    row_offsets_.shrink_to_fit();
+    block_offsets_.shrink_to_fit();
+  }
+  NotifyRowsInserted(start, GetRowCount() - start);
+  on_index_progress.Emit(this, progress);
+}
+
+void FileTableModel::AppendRowOffset(uint64_t offset) {
+  if (row_offsets_.size() % kRowsPerBlock == 0)
+    block_offsets_.push_back(offset);
+  uint64_t relative = offset - block_offsets_.back();
+  DCHECK_LE(relative, std::numeric_limits<uint32_t>::max());
+  row_offsets_.push_back(static_cast<uint32_t>(relative));
+}
+
+uint64_t FileTableModel::GetRowOffset(uint32_t row) const {
+  return block_offsets_[row / kRowsPerBlock] + row_offsets_[row];
+}
+
+}  // namespace nu
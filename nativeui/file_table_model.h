@@ -0,0 +1,92 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_FILE_TABLE_MODEL_H_
+#define NATIVEUI_FILE_TABLE_MODEL_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nativeui/signal.h"
+#include "nativeui/table_model.h"
+
+namespace base {
+class FilePath;
+}
+
+namespace nu {
+
+// A read-only TableModel showing the rows of a CSV or TSV file.
+//
+// The file is mapped into memory and only the offsets of rows are indexed,
+// which happens on a worker thread. Cells are parsed when they are read, and
+// only a few recently read rows are kept.
+class NATIVEUI_EXPORT FileTableModel : public TableModel {
+ public:
+  FileTableModel(char delimiter, bool has_header);
+
+  // Map the file at |path| and start indexing its rows, rows are added to the
+  // model while indexing.
+  bool Open(const base::FilePath& path);
+  void Close();
+
+  bool IsIndexing() const { return indexing_; }
+  // Return the cells of header row, empty if there is no header.
+  const std::vector<std::string>& GetHeader() const { return header_; }
+  // Return the approximate memory used by the row index.
+  size_t GetIndexMemoryUsage() const;
+
+  // TableModel:
+  uint32_t GetRowCount() const override;
+  const base::Value* GetValue(uint32_t column, uint32_t row) const override;
+  void SetValue(uint32_t column, uint32_t row, base::Value value) override;
+
+  // Events.
+  Signal<void(FileTableModel*, float)> on_index_progress;
+
+ protected:
+  ~FileTableModel() override;
+
+ private:
+  struct IndexJob;
+
+  using Row = std::vector<base::Value>;
+
+  // Runs on worker thread, and sends the offsets of rows to main thread.
+  static void IndexRows(std::shared_ptr<IndexJob> job, size_t start);
+
+  // Called on main thread with the offsets of newly indexed rows.
+  void OnRowsIndexed(const std::vector<uint64_t>& offsets,
+                     float progress,
+                     bool done);
+
+  void AppendRowOffset(uint64_t offset);
+  uint64_t GetRowOffset(uint32_t row) const;
+
+  const char delimiter_;
+  const bool has_header_;
+
+  std::shared_ptr<IndexJob> job_;
+  bool indexing_ = false;
+  std::vector<std::string> header_;
+
+  // The offset of each row is stored as 32bit offset relative to a 64bit
+  // offset shared by a block of rows.
+  std::vector<uint64_t> block_offsets_;
+  std::vector<uint32_t> row_offsets_;
+
+  // Recently parsed rows, the most recent one is at front.
+  mutable std::list<std::pair<uint32_t, Row>> rows_;
+  mutable std::unordered_map<uint32_t,
+                             std::list<std::pair<uint32_t, Row>>::iterator>
+      rows_map_;
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_FILE_TABLE_MODEL_H_
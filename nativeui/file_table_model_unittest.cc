@@ -0,0 +1,93 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/strings/stringprintf.h"
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class FileTableModelTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(dir_.CreateUniqueTempDir());
+  }
+
+  base::FilePath WriteFile(const std::string& content) {
+    base::FilePath path = dir_.GetPath().AppendASCII("data.csv");
+    EXPECT_TRUE(base::WriteFile(path, content.data(), content.size()));
+    return path;
+  }
+
+  void WaitForIndexing(nu::FileTableModel* model) {
+    if (!model->IsIndexing())
+      return;
+    model->on_index_progress.Connect([](nu::FileTableModel* model, float) {
+      if (!model->IsIndexing())
+        nu::MessageLoop::Quit();
+    });
+    nu::MessageLoop::Run();
+  }
+
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  base::ScopedTempDir dir_;
+};
+
+TEST_F(FileTableModelTest, ParseCells) {
+  scoped_refptr<nu::FileTableModel> model = new nu::FileTableModel(',', true);
+  ASSERT_TRUE(model->Open(WriteFile(
+      "name,note\r\n"
+      "a,plain\r\n"
+      "\r\n"
+      "\"b,c\",\"quoted \"\"text\"\"\"\n"
+      "d,\"multiple\nlines\"\n"
+      "e")));
+  WaitForIndexing(model.get());
+  EXPECT_EQ(model->GetHeader(), std::vector<std::string>({"name", "note"}));
+  ASSERT_EQ(model->GetRowCount(), 4u);
+  EXPECT_EQ(*model->GetValue(1, 0), base::Value("plain"));
+  EXPECT_EQ(*model->GetValue(0, 1), base::Value("b,c"));
+  EXPECT_EQ(*model->GetValue(1, 1), base::Value("quoted \"text\""));
+  EXPECT_EQ(*model->GetValue(1, 2), base::Value("multiple\nlines"));
+  EXPECT_EQ(*model->GetValue(0, 3), base::Value("e"));
+  EXPECT_EQ(model->GetValue(1, 3), nullptr);
+  EXPECT_EQ(model->GetValue(0, 4), nullptr);
+}
+
+TEST_F(FileTableModelTest, LargeFile) {
+  std::string content;
+  for (int i = 0; i < 100000; ++i)
+    content += base::StringPrintf("%d\trow %d\n", i, i);
+  scoped_refptr<nu::FileTableModel> model = new nu::FileTableModel('\t', false);
+  ASSERT_TRUE(model->Open(WriteFile(content)));
+  EXPECT_TRUE(model->IsIndexing());
+  float last_progress = 0;
+  model->on_index_progress.Connect([&](nu::FileTableModel*, float progress) {
+    EXPECT_GE(progress, last_progress);
+    last_progress = progress;
+  });
+  WaitForIndexing(model.get());
+  EXPECT_EQ(last_progress, 1.f);
+  ASSERT_EQ(model->GetRowCount(), 100000u);
+  EXPECT_EQ(*model->GetValue(1, 99999), base::Value("row 99999"));
+  EXPECT_EQ(*model->GetValue(0, 0), base::Value("0"));
+  // The index is much smaller than the file.
+  EXPECT_LT(model->GetIndexMemoryUsage(), content.size() / 2);
+  model->Close();
+  EXPECT_EQ(model->GetRowCount(), 0u);
+}
+
+TEST_F(FileTableModelTest, WithTable) {
+  scoped_refptr<nu::Table> table = new nu::Table;
+  table->AddColumn("A");
+  scoped_refptr<nu::FileTableModel> model = new nu::FileTableModel(',', false);
+  table->SetModel(model.get());
+  ASSERT_TRUE(model->Open(WriteFile("1\n2\n3\n")));
+  WaitForIndexing(model.get());
+  table->SelectRow(2);
+  EXPECT_EQ(table->GetSelectedRow(), 2);
+  model->Close();
+  EXPECT_EQ(table->GetSelectedRow(), -1);
+}
@@ -0,0 +1,43 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/font_registry.h"
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class FontTest : public testing::Test {
+ protected:
+  nu::Lifetime lifetime_;
+  nu::State state_;
+};
+
+TEST_F(FontTest, Interning) {
+  nu::FontRegistry* registry = state_.GetFontRegistry();
+  scoped_refptr<nu::Font> font1 = nu::Font::Get(
+      "Arial", 14, nu::Font::Weight::Normal, nu::Font::Style::Normal);
+  scoped_refptr<nu::Font> font2 = nu::Font::Get(
+      "Arial", 14, nu::Font::Weight::Normal, nu::Font::Style::Normal);
+  scoped_refptr<nu::Font> font3 = nu::Font::Get(
+      "Arial", 15, nu::Font::Weight::Normal, nu::Font::Style::Normal);
+  EXPECT_EQ(font1, font2);
+  EXPECT_NE(font1, font3);
+  EXPECT_EQ(registry->size(), 2u);
+  font1 = nullptr;
+  font2 = nullptr;
+  EXPECT_EQ(registry->size(), 1u);
+  font3 = nullptr;
+  EXPECT_EQ(registry->size(), 0u);
+}
+
+TEST_F(FontTest, Metrics) {
+  scoped_refptr<nu::Font> font = nu::Font::Get(
+      "Arial", 14, nu::Font::Weight::Normal, nu::Font::Style::Normal);
+  const nu::Font::Metrics& metrics = font->GetMetrics();
+  EXPECT_GT(metrics.ascent, 0);
+  EXPECT_GE(metrics.descent, 0);
+  EXPECT_GE(metrics.line_height, metrics.ascent + metrics.descent - 1);
+  EXPECT_GT(metrics.average_char_width, 0);
+  // Cached.
+  EXPECT_EQ(&metrics, &font->GetMetrics());
+}
@@ -16,6 +16,13 @@ inline bool RangeInvalid(int start, int end) {
 
 }  // namespace
 
+TextRangeAttributes::TextRangeAttributes() {}
+
+TextRangeAttributes::TextRangeAttributes(const TextRangeAttributes& other)
+    = default;
+
+TextRangeAttributes::~TextRangeAttributes() {}
+
 void AttributedText::SetFont(Font* font) {
   SetFontFor(font, 0, -1);
 }
@@ -36,4 +43,16 @@ void AttributedText::SetColorFor(Color color, int start, int end) {
   PlatformSetColorFor(color, start, end);
 }
 
+void AttributedText::SetAttributes(
+    const std::vector<TextRangeAttributes>& attributes) {
+  for (const TextRangeAttributes& attr : attributes) {
+    if (RangeInvalid(attr.start, attr.end))
+      continue;
+    if (attr.font)
+      PlatformSetFontFor(attr.font.get(), attr.start, attr.end);
+    if (attr.color)
+      PlatformSetColorFor(*attr.color, attr.start, attr.end);
+  }
+}
+
 }  // namespace nu
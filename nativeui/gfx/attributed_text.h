@@ -6,8 +6,10 @@
 #define NATIVEUI_GFX_ATTRIBUTED_TEXT_H_
 
 #include <string>
+#include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/optional.h"
 #include "nativeui/gfx/color.h"
 #include "nativeui/gfx/text.h"
 #include "nativeui/types.h"
@@ -18,6 +20,19 @@ class Font;
 class RectF;
 class SizeF;
 
+// Font and color applied to a range of text.
+struct NATIVEUI_EXPORT TextRangeAttributes {
+  TextRangeAttributes();
+  TextRangeAttributes(const TextRangeAttributes& other);
+  ~TextRangeAttributes();
+
+  int start = 0;
+  int end = -1;
+  // Attributes that are not set are left unchanged.
+  scoped_refptr<Font> font;
+  base::Optional<Color> color;
+};
+
 class NATIVEUI_EXPORT AttributedText : public base::RefCounted<AttributedText> {
  public:
   AttributedText(const std::string& text, const TextFormat& format);
@@ -30,6 +45,10 @@ class NATIVEUI_EXPORT AttributedText : public base::RefCounted<AttributedText> {
   void SetColor(Color font);
   void SetColorFor(Color font, int start, int end);
 
+  // Apply attributes to multiple ranges at once, which is much faster than
+  // calling SetFontFor and SetColorFor for each range.
+  void SetAttributes(const std::vector<TextRangeAttributes>& attributes);
+
   SizeF GetSize() const;
   RectF GetBoundsFor(const SizeF& size) const;
   std::string GetText() const;
@@ -45,6 +64,10 @@ class NATIVEUI_EXPORT AttributedText : public base::RefCounted<AttributedText> {
 
   void PlatformSetFontFor(Font* font, int start, int end);
   void PlatformSetColorFor(Color color, int start, int end);
+#if defined(OS_LINUX)
+  // Convert the character |index| to byte index in the text.
+  unsigned CharIndexToByteIndex(int index);
+#endif
 
   NativeAttributedText text_;
   TextFormat format_;
@@ -52,6 +75,10 @@ class NATIVEUI_EXPORT AttributedText : public base::RefCounted<AttributedText> {
 #if defined(OS_WIN)
   // IDWriteTextLayout does not provide a way to get text.
   base::string16 original_text_;
+#elif defined(OS_LINUX)
+  // Maps UTF-16 character indexes to byte indexes of the UTF-8 text, built on
+  // first use.
+  std::vector<unsigned> byte_indexes_;
 #endif
 };
 
@@ -5,11 +5,26 @@
 #include "nativeui/gfx/font.h"
 
 #include "nativeui/app.h"
+#include "nativeui/gfx/font_registry.h"
+#include "nativeui/state.h"
 
 namespace nu {
 
+// static
+Font* Font::Get(const std::string& name, float size, Weight weight,
+                Style style) {
+  return State::GetCurrent()->GetFontRegistry()->Get(name, size, weight,
+                                                     style);
+}
+
 Font* Font::Derive(float size_delta, Weight weight, Style style) const {
   return new Font(GetName(), GetSize() + size_delta, weight, style);
 }
 
+const Font::Metrics& Font::GetMetrics() const {
+  if (!metrics_)
+    metrics_ = PlatformGetMetrics();
+  return *metrics_;
+}
+
 }  // namespace nu
@@ -8,11 +8,14 @@
 #include <string>
 
 #include "base/memory/ref_counted.h"
+#include "base/optional.h"
 #include "nativeui/nativeui_export.h"
 #include "nativeui/types.h"
 
 namespace nu {
 
+class FontRegistry;
+
 class NATIVEUI_EXPORT Font : public base::RefCounted<Font> {
  public:
   // Standard font weights as used in Pango and Windows. The values must match
@@ -35,12 +38,25 @@ class NATIVEUI_EXPORT Font : public base::RefCounted<Font> {
     Italic = 1,
   };
 
+  // Metrics of the font in DIP.
+  struct Metrics {
+    float ascent = 0;
+    float descent = 0;
+    float line_height = 0;
+    float average_char_width = 0;
+  };
+
   // Create default system UI font.
   Font();
   // Create a Font implementation with the specified |name|
   // (encoded in UTF-8), DIP |size|, |weight| and |style|.
   Font(const std::string& name, float size, Weight weight, Style style);
 
+  // Return a shared font with the specified attributes, identical fonts are
+  // only created once per thread.
+  static Font* Get(const std::string& name, float size, Weight weight,
+                   Style style);
+
   // Returns a new Font derived from the existing font.
   // It is caller's responsibility to manage the lifetime of returned font.
   Font* Derive(float size_delta, Weight weight, Style style) const;
@@ -57,6 +73,9 @@ class NATIVEUI_EXPORT Font : public base::RefCounted<Font> {
   // Return the font style.
   Style GetStyle() const;
 
+  // Return the font metrics, which are computed once and cached.
+  const Metrics& GetMetrics() const;
+
   // Return the native font handle.
   NativeFont GetNative() const;
 
@@ -73,9 +92,24 @@ class NATIVEUI_EXPORT Font : public base::RefCounted<Font> {
 
  private:
   friend class base::RefCounted<Font>;
+  friend class FontRegistry;
+
+  Metrics PlatformGetMetrics() const;
 
   NativeFont font_;
 
+  // Cached metrics.
+  mutable base::Optional<Metrics> metrics_;
+
+  // The registry this font is interned in, and the key.
+  FontRegistry* registry_ = nullptr;
+  std::string registry_key_;
+
+#if defined(OS_LINUX)
+  // The resolved font, loaded on first use.
+  mutable PangoFont* pango_font_ = nullptr;
+#endif
+
 #if defined(OS_WIN)
   // Cached font family, which is requested by DirectWrite a lot.
   mutable std::wstring font_family_;
@@ -0,0 +1,40 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/font_registry.h"
+
+#include "base/strings/stringprintf.h"
+
+namespace nu {
+
+FontRegistry::FontRegistry() {}
+
+FontRegistry::~FontRegistry() {
+  // Fonts may outlive the registry.
+  for (const auto& it : fonts_)
+    it.second->registry_ = nullptr;
+}
+
+Font* FontRegistry::Get(const std::string& name, float size,
+                        Font::Weight weight, Font::Style style) {
+  std::string key = base::StringPrintf("%s:%a:%d:%d", name.c_str(), size,
+                                       static_cast<int>(weight),
+                                       static_cast<int>(style));
+  auto it = fonts_.find(key);
+  if (it != fonts_.end())
+    return it->second;
+  Font* font = new Font(name, size, weight, style);
+  font->registry_ = this;
+  font->registry_key_ = key;
+  fonts_[std::move(key)] = font;
+  return font;
+}
+
+void FontRegistry::Remove(Font* font) {
+  auto it = fonts_.find(font->registry_key_);
+  if (it != fonts_.end() && it->second == font)
+    fonts_.erase(it);
+}
+
+}  // namespace nu
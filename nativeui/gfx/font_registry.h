@@ -0,0 +1,46 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_FONT_REGISTRY_H_
+#define NATIVEUI_GFX_FONT_REGISTRY_H_
+
+#include <string>
+#include <unordered_map>
+
+#include "nativeui/gfx/font.h"
+
+namespace nu {
+
+// Interns fonts so identical descriptions share one native font, together
+// with its resolved font and cached metrics.
+//
+// The registry does not keep fonts alive, a font removes itself from the
+// registry when it is destroyed.
+class NATIVEUI_EXPORT FontRegistry {
+ public:
+  FontRegistry();
+  ~FontRegistry();
+
+  // Return the font with specified attributes, a new one is created if there
+  // is no identical font alive.
+  Font* Get(const std::string& name, float size, Font::Weight weight,
+            Font::Style style);
+
+  // Return the number of interned fonts.
+  size_t size() const { return fonts_.size(); }
+
+ private:
+  friend class Font;
+
+  // Called by the font when it is destroyed.
+  void Remove(Font* font);
+
+  std::unordered_map<std::string, Font*> fonts_;
+
+  DISALLOW_COPY_AND_ASSIGN(FontRegistry);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_FONT_REGISTRY_H_
@@ -7,30 +7,19 @@
 #include <gtk/gtk.h>
 #include <pango/pango.h>
 
-#include "base/strings/utf_string_conversions.h"
 #include "nativeui/gfx/font.h"
 #include "nativeui/gfx/geometry/rect_f.h"
 #include "nativeui/gfx/geometry/size_f.h"
+#include "nativeui/gfx/gtk/pango_util.h"
 #include "nativeui/gfx/text.h"
 
 namespace nu {
 
 namespace {
 
-// Convert the character index to byte index.
-guint CharIndexToByteIndex(const base::string16& text, int index) {
-  if (index < 0)
-    return G_MAXUINT;
-  return base::UTF16ToUTF8(text.substr(0, index)).size();
-}
-
-void FillPangoAttributeIndex(PangoAttribute* attr, PangoLayout* layout,
-                             int start, int end) {
-  if (start == 0 && end == -1)  // this is the most common case
-    return;
-  base::string16 text = base::UTF8ToUTF16(pango_layout_get_text(layout));
-  attr->start_index = CharIndexToByteIndex(text, start);
-  attr->end_index = CharIndexToByteIndex(text, end);
+// Whether the range covers the whole text.
+inline bool IsWholeRange(int start, int end) {
+  return start == 0 && end == -1;
 }
 
 }  // namespace
@@ -38,12 +27,7 @@ void FillPangoAttributeIndex(PangoAttribute* attr, PangoLayout* layout,
 AttributedText::AttributedText(const std::string& text,
                                const TextFormat& format)
     : format_(format) {
-  static PangoContext* context = nullptr;
-  if (!context) {
-    context = gdk_pango_context_get_for_screen(gdk_screen_get_default());
-    pango_context_set_language(context, pango_language_get_default());
-  }
-  text_ = pango_layout_new(context);
+  text_ = pango_layout_new(GetSharedPangoContext());
 
   // Set text.
   pango_layout_set_text(text_, text.c_str(), text.size());
@@ -75,9 +59,34 @@ AttributedText::~AttributedText() {
   g_object_unref(text_);
 }
 
+unsigned AttributedText::CharIndexToByteIndex(int index) {
+  if (index < 0)
+    return G_MAXUINT;
+  // Build the index on first use, so the text is only scanned once no matter
+  // how many ranges are styled.
+  if (byte_indexes_.empty()) {
+    const char* text = pango_layout_get_text(text_);
+    const char* p = text;
+    for (; *p; p = g_utf8_next_char(p)) {
+      unsigned byte_index = p - text;
+      byte_indexes_.push_back(byte_index);
+      // Characters out of BMP take 2 UTF-16 code units.
+      if (g_utf8_get_char(p) > 0xFFFF)
+        byte_indexes_.push_back(byte_index);
+    }
+    byte_indexes_.push_back(p - text);
+  }
+  if (static_cast<size_t>(index) >= byte_indexes_.size())
+    return byte_indexes_.back();
+  return byte_indexes_[index];
+}
+
 void AttributedText::PlatformSetFontFor(Font* font, int start, int end) {
   PangoAttribute* font_attr = pango_attr_font_desc_new(font->GetNative());
-  FillPangoAttributeIndex(font_attr, text_, start, end);
+  if (!IsWholeRange(start, end)) {
+    font_attr->start_index = CharIndexToByteIndex(start);
+    font_attr->end_index = CharIndexToByteIndex(end);
+  }
 
   PangoAttrList* attrs = pango_layout_get_attributes(text_);
   pango_attr_list_insert(attrs, font_attr);  // ownership taken
@@ -88,7 +97,10 @@ void AttributedText::PlatformSetColorFor(Color color, int start, int end) {
       color.r() / 255. * 65535,
       color.g() / 255. * 65535,
       color.b() / 255. * 65535);
-  FillPangoAttributeIndex(fg_attr, text_, start, end);
+  if (!IsWholeRange(start, end)) {
+    fg_attr->start_index = CharIndexToByteIndex(start);
+    fg_attr->end_index = CharIndexToByteIndex(end);
+  }
 
   PangoAttrList* attrs = pango_layout_get_attributes(text_);
   pango_attr_list_insert(attrs, fg_attr);  // ownership taken
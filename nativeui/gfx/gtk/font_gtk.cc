@@ -6,6 +6,9 @@
 
 #include <gtk/gtk.h>
 
+#include "nativeui/gfx/font_registry.h"
+#include "nativeui/gfx/gtk/pango_util.h"
+
 namespace nu {
 
 namespace {
@@ -36,6 +39,10 @@ Font::Font(const std::string& name, float size, Weight weight, Style style)
 }
 
 Font::~Font() {
+  if (registry_)
+    registry_->Remove(this);
+  if (pango_font_)
+    g_object_unref(pango_font_);
   pango_font_description_free(font_);
 }
 
@@ -67,4 +74,23 @@ NativeFont Font::GetNative() const {
   return font_;
 }
 
+Font::Metrics Font::PlatformGetMetrics() const {
+  PangoContext* context = GetSharedPangoContext();
+  if (!pango_font_)
+    pango_font_ = pango_context_load_font(context, font_);
+  Metrics metrics;
+  if (!pango_font_)
+    return metrics;
+  PangoFontMetrics* fm = pango_font_get_metrics(
+      pango_font_, pango_context_get_language(context));
+  const float scale = PANGO_SCALE;
+  metrics.ascent = pango_font_metrics_get_ascent(fm) / scale;
+  metrics.descent = pango_font_metrics_get_descent(fm) / scale;
+  metrics.line_height = metrics.ascent + metrics.descent;
+  metrics.average_char_width =
+      pango_font_metrics_get_approximate_char_width(fm) / scale;
+  pango_font_metrics_unref(fm);
+  return metrics;
+}
+
 }  // namespace nu
@@ -14,6 +14,7 @@
 #include "nativeui/gfx/attributed_text.h"
 #include "nativeui/gfx/canvas.h"
 #include "nativeui/gfx/font.h"
+#include "nativeui/gfx/gtk/pixbuf_util.h"
 #include "nativeui/gfx/image.h"
 
 namespace nu {
@@ -161,7 +162,8 @@ void PainterGtk::DrawImageFromRect(Image* image, const RectF& src,
     cairo_scale(context_, x_scale, y_scale);
   // Draw.
   GdkPixbuf* pixbuf = gdk_pixbuf_animation_get_static_image(image->GetNative());
-  gdk_cairo_set_source_pixbuf(context_, pixbuf, -ps.x(), -ps.y());
+  cairo_set_source_surface(context_, GetCachedSurfaceForPixbuf(pixbuf),
+                           -ps.x(), -ps.y());
   cairo_paint(context_);
   cairo_restore(context_);
 }
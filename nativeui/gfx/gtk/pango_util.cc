@@ -0,0 +1,20 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/gtk/pango_util.h"
+
+#include <gdk/gdk.h>
+
+namespace nu {
+
+PangoContext* GetSharedPangoContext() {
+  static PangoContext* context = nullptr;
+  if (!context) {
+    context = gdk_pango_context_get_for_screen(gdk_screen_get_default());
+    pango_context_set_language(context, pango_language_get_default());
+  }
+  return context;
+}
+
+}  // namespace nu
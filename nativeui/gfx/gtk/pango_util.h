@@ -0,0 +1,18 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_GTK_PANGO_UTIL_H_
+#define NATIVEUI_GFX_GTK_PANGO_UTIL_H_
+
+#include <pango/pango.h>
+
+namespace nu {
+
+// Return the PangoContext of default screen shared by layouts and fonts, it
+// must only be used on the GUI thread.
+PangoContext* GetSharedPangoContext();
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_GTK_PANGO_UTIL_H_
@@ -0,0 +1,63 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/gtk/pixbuf_util.h"
+
+#include "nativeui/gfx/pixel_convert.h"
+
+namespace nu {
+
+namespace {
+
+// Key of the cached surface.
+const char kCachedSurfaceKey[] = "nu-cached-surface";
+
+}  // namespace
+
+cairo_surface_t* CreateSurfaceFromPixbuf(GdkPixbuf* pixbuf) {
+  int width = gdk_pixbuf_get_width(pixbuf);
+  int height = gdk_pixbuf_get_height(pixbuf);
+  int channels = gdk_pixbuf_get_n_channels(pixbuf);
+  cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+                                                        width, height);
+  if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+    return surface;
+
+  // Let GDK handle the pixel formats we do not know.
+  if (gdk_pixbuf_get_colorspace(pixbuf) != GDK_COLORSPACE_RGB ||
+      gdk_pixbuf_get_bits_per_sample(pixbuf) != 8 ||
+      (channels != 3 && channels != 4)) {
+    cairo_t* cr = cairo_create(surface);
+    gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
+    cairo_paint(cr);
+    cairo_destroy(cr);
+    return surface;
+  }
+
+  cairo_surface_flush(surface);
+  const uint8_t* src = gdk_pixbuf_read_pixels(pixbuf);
+  int src_stride = gdk_pixbuf_get_rowstride(pixbuf);
+  uint8_t* dst = cairo_image_surface_get_data(surface);
+  int dst_stride = cairo_image_surface_get_stride(surface);
+  if (channels == 4)
+    ConvertRGBAToPremulBGRA(src, src_stride, dst, dst_stride, width, height);
+  else
+    ConvertRGBToBGRA(src, src_stride, dst, dst_stride, width, height);
+  cairo_surface_mark_dirty(surface);
+  return surface;
+}
+
+cairo_surface_t* GetCachedSurfaceForPixbuf(GdkPixbuf* pixbuf) {
+  auto* surface = static_cast<cairo_surface_t*>(
+      g_object_get_data(G_OBJECT(pixbuf), kCachedSurfaceKey));
+  if (!surface) {
+    surface = CreateSurfaceFromPixbuf(pixbuf);
+    g_object_set_data_full(G_OBJECT(pixbuf), kCachedSurfaceKey, surface,
+                           reinterpret_cast<GDestroyNotify>(
+                               cairo_surface_destroy));
+  }
+  return surface;
+}
+
+}  // namespace nu
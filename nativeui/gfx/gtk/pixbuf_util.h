@@ -0,0 +1,24 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_GTK_PIXBUF_UTIL_H_
+#define NATIVEUI_GFX_GTK_PIXBUF_UTIL_H_
+
+#include <gdk/gdk.h>
+
+namespace nu {
+
+// Create a cairo image surface with the pixels of |pixbuf|.
+cairo_surface_t* CreateSurfaceFromPixbuf(GdkPixbuf* pixbuf);
+
+// Return a cairo image surface with the pixels of |pixbuf|.
+//
+// The surface is cached on the |pixbuf| and released together with it, so
+// drawing the same image again does not convert the pixels again. The caller
+// does not own the returned surface.
+cairo_surface_t* GetCachedSurfaceForPixbuf(GdkPixbuf* pixbuf);
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_GTK_PIXBUF_UTIL_H_
@@ -0,0 +1,111 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/text_measurer.h"
+
+#include <pango/pangocairo.h>
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include "nativeui/gfx/font.h"
+#include "nativeui/gfx/gtk/pango_util.h"
+
+namespace nu {
+
+namespace {
+
+// Batches smaller than this are measured on the calling thread.
+const size_t kMinStringsPerThread = 256;
+
+// Upper limit of worker threads.
+const unsigned kMaxThreads = 8;
+
+// Everything a worker needs, copied from GUI objects before starting threads
+// since neither Font nor the shared PangoContext is thread-safe.
+struct MeasureParams {
+  const std::vector<std::string>* strings;
+  std::vector<SizeF>* results;
+  PangoFontDescription* font;
+  const cairo_font_options_t* font_options;
+  double resolution;
+  PangoLanguage* language;
+  TextFormat format;
+  float max_width;
+};
+
+void MeasureWithLayout(PangoLayout* layout, const MeasureParams& params,
+                       size_t begin, size_t end) {
+  pango_layout_set_font_description(layout, params.font);
+  if (params.format.wrap && params.max_width > 0) {
+    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+    pango_layout_set_width(layout, params.max_width * PANGO_SCALE);
+  } else {
+    pango_layout_set_width(layout, -1);
+  }
+  if (params.format.ellipsis)
+    pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
+  for (size_t i = begin; i < end; ++i) {
+    const std::string& str = (*params.strings)[i];
+    pango_layout_set_text(layout, str.c_str(), str.size());
+    int width, height;
+    pango_layout_get_pixel_size(layout, &width, &height);
+    (*params.results)[i] = SizeF(width, height);
+  }
+}
+
+// Runs on worker thread.
+void MeasureOnWorker(const MeasureParams& params, size_t begin, size_t end) {
+  PangoFontMap* font_map = pango_cairo_font_map_new();
+  PangoContext* context = pango_font_map_create_context(font_map);
+  pango_cairo_context_set_resolution(context, params.resolution);
+  pango_cairo_context_set_font_options(context, params.font_options);
+  pango_context_set_language(context, params.language);
+  PangoLayout* layout = pango_layout_new(context);
+  MeasureWithLayout(layout, params, begin, end);
+  g_object_unref(layout);
+  g_object_unref(context);
+  g_object_unref(font_map);
+}
+
+}  // namespace
+
+// static
+std::vector<SizeF> TextMeasurer::PlatformMeasureBatch(
+    const std::vector<std::string>& strings,
+    const TextAttributes& attributes,
+    float max_width) {
+  std::vector<SizeF> results(strings.size());
+  PangoContext* shared_context = GetSharedPangoContext();
+  MeasureParams params = {&strings, &results,
+                          attributes.font->GetNative(),
+                          pango_cairo_context_get_font_options(shared_context),
+                          pango_cairo_context_get_resolution(shared_context),
+                          pango_context_get_language(shared_context),
+                          attributes, max_width};
+
+  unsigned threads = std::min<size_t>(
+      std::min(std::max(std::thread::hardware_concurrency(), 1u), kMaxThreads),
+      strings.size() / kMinStringsPerThread);
+  if (threads <= 1) {
+    PangoLayout* layout = pango_layout_new(shared_context);
+    MeasureWithLayout(layout, params, 0, strings.size());
+    g_object_unref(layout);
+    return results;
+  }
+
+  // Workers only read from |params| and write to their own part of results.
+  std::vector<std::thread> workers;
+  size_t chunk = (strings.size() + threads - 1) / threads;
+  for (size_t begin = 0; begin < strings.size(); begin += chunk) {
+    size_t end = std::min(begin + chunk, strings.size());
+    workers.emplace_back(&MeasureOnWorker, std::cref(params), begin, end);
+  }
+  for (std::thread& worker : workers)
+    worker.join();
+  return results;
+}
+
+}  // namespace nu
@@ -7,6 +7,7 @@
 #include <Cocoa/Cocoa.h>
 
 #include "base/strings/sys_string_conversions.h"
+#include "nativeui/gfx/font_registry.h"
 
 namespace nu {
 
@@ -106,6 +107,8 @@ Font::Font(const std::string& name, float size, Weight weight, Style style)
     : font_([NSFontWithSpec(name, size, weight, style) retain]) {}
 
 Font::~Font() {
+  if (registry_)
+    registry_->Remove(this);
   [font_ release];
 }
 
@@ -134,4 +137,17 @@ NativeFont Font::GetNative() const {
   return font_;
 }
 
+Font::Metrics Font::PlatformGetMetrics() const {
+  Metrics metrics;
+  metrics.ascent = [font_ ascender];
+  metrics.descent = -[font_ descender];
+  metrics.line_height = metrics.ascent + metrics.descent + [font_ leading];
+  // NSFont does not provide average width, measure the alphabet instead.
+  NSString* alphabet =
+      @"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  NSSize size = [alphabet sizeWithAttributes:@{NSFontAttributeName: font_}];
+  metrics.average_char_width = size.width / [alphabet length];
+  return metrics;
+}
+
 }  // namespace nu
@@ -5,6 +5,8 @@
 #include "nativeui/gfx/painter.h"
 
 #include "nativeui/gfx/attributed_text.h"
+#include "nativeui/gfx/text_layout_cache.h"
+#include "nativeui/state.h"
 
 namespace nu {
 
@@ -14,9 +16,9 @@ Painter::~Painter() {}
 
 void Painter::DrawText(const std::string& str, const RectF& rect,
                        const TextAttributes& attributes) {
-  scoped_refptr<AttributedText> text(new AttributedText(str, attributes));
-  text->SetFont(attributes.font.get());
-  text->SetColor(attributes.color);
+  scoped_refptr<AttributedText> text =
+      State::GetCurrent()->GetTextLayoutCache()->Get(str, attributes,
+                                                     rect.size());
   DrawAttributedText(text.get(), rect);
 }
 
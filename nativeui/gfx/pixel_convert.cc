@@ -0,0 +1,335 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/pixel_convert.h"
+
+#include <string.h>
+
+#include <atomic>
+
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <immintrin.h>
+
+#include "base/cpu.h"
+#endif
+
+#if defined(ARCH_CPU_X86_FAMILY) && defined(COMPILER_GCC)
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_AVX2
+#endif
+
+namespace nu {
+
+namespace {
+
+// Convert one row of |width| pixels.
+using RowConverter = void(*)(const uint8_t* src, uint8_t* dst, int width);
+
+struct Kernels {
+  PixelConvertISA isa;
+  RowConverter rgba_to_premul_bgra;
+  RowConverter premul_bgra_to_rgba;
+  RowConverter rgb_to_bgra;
+};
+
+// Exact rounded division by 255 for x in [0, 255 * 255].
+inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+// Reverse the premultiplication of |c|, |scale| is 255 / alpha.
+//
+// The SIMD kernels do the same float operations in the same order so results
+// are bit-identical.
+inline uint32_t Unpremultiply(uint32_t c, float scale) {
+  float v = static_cast<float>(c) * scale + 0.5f;
+  return v >= 255.f ? 255 : static_cast<uint32_t>(v);
+}
+
+inline void StorePixel(uint8_t* dst, uint32_t pixel) {
+  memcpy(dst, &pixel, 4);
+}
+
+inline uint32_t LoadPixel(const uint8_t* src) {
+  uint32_t pixel;
+  memcpy(&pixel, src, 4);
+  return pixel;
+}
+
+void RGBAToPremulBGRAScalar(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; ++x, src += 4, dst += 4) {
+    uint32_t a = src[3];
+    StorePixel(dst, (a << 24) |
+                    (Div255(src[0] * a) << 16) |
+                    (Div255(src[1] * a) << 8) |
+                    Div255(src[2] * a));
+  }
+}
+
+void PremulBGRAToRGBAScalar(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; ++x, src += 4, dst += 4) {
+    uint32_t pixel = LoadPixel(src);
+    uint32_t a = pixel >> 24;
+    float scale = a == 0 ? 0.f : 255.f / static_cast<float>(a);
+    dst[0] = Unpremultiply((pixel >> 16) & 0xFF, scale);
+    dst[1] = Unpremultiply((pixel >> 8) & 0xFF, scale);
+    dst[2] = Unpremultiply(pixel & 0xFF, scale);
+    dst[3] = a;
+  }
+}
+
+void RGBToBGRAScalar(const uint8_t* src, uint8_t* dst, int width) {
+  for (int x = 0; x < width; ++x, src += 3, dst += 4) {
+    StorePixel(dst, 0xFF000000 |
+                    (static_cast<uint32_t>(src[0]) << 16) |
+                    (static_cast<uint32_t>(src[1]) << 8) |
+                    src[2]);
+  }
+}
+
+#if defined(ARCH_CPU_X86_FAMILY)
+
+// Premultiply and swizzle 2 RGBA pixels stored as 16bit lanes.
+inline __m128i PremulSwizzle16(__m128i v) {
+  const __m128i kColorMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+  const __m128i kAlpha255 = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+  const __m128i kRound = _mm_set1_epi16(128);
+  // [A, A, A, 255] for each pixel.
+  __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xFF), 0xFF);
+  a = _mm_or_si128(_mm_and_si128(a, kColorMask), kAlpha255);
+  // Div255(c * a).
+  v = _mm_add_epi16(_mm_mullo_epi16(v, a), kRound);
+  v = _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+  // RGBA => BGRA.
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 0, 1, 2)),
+                             _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+// Unpremultiply and swizzle 1 BGRA pixel stored as 32bit lanes.
+inline __m128i UnpremulSwizzle32(__m128i v) {
+  const __m128i kAlphaMask = _mm_set_epi32(-1, 0, 0, 0);
+  __m128 a = _mm_cvtepi32_ps(_mm_shuffle_epi32(v, 0xFF));
+  __m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(255.f), a),
+                            _mm_cmpneq_ps(a, _mm_setzero_ps()));
+  __m128 c = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), scale),
+                        _mm_set1_ps(0.5f));
+  __m128i r = _mm_cvttps_epi32(c);
+  r = _mm_or_si128(_mm_andnot_si128(kAlphaMask, r),
+                   _mm_and_si128(kAlphaMask, v));
+  // BGRA => RGBA.
+  return _mm_shuffle_epi32(r, _MM_SHUFFLE(3, 0, 1, 2));
+}
+
+// Swap the R and B channels of 4 opaque pixels.
+inline __m128i SwapRB(__m128i v) {
+  const __m128i kRBMask = _mm_set1_epi32(0x00FF00FF);
+  __m128i rb = _mm_and_si128(v, kRBMask);
+  __m128i ag = _mm_andnot_si128(kRBMask, v);
+  return _mm_or_si128(ag, _mm_or_si128(_mm_slli_epi32(rb, 16),
+                                       _mm_srli_epi32(rb, 16)));
+}
+
+// Unpremultiply 4 BGRA pixels.
+inline __m128i PremulBGRAToRGBA4(__m128i px) {
+  const __m128i kOpaque = _mm_set1_epi32(0xFF000000);
+  const __m128i zero = _mm_setzero_si128();
+  // Fast path for opaque pixels, which are the most common.
+  __m128i opaque = _mm_cmpeq_epi32(_mm_and_si128(px, kOpaque), kOpaque);
+  if (_mm_movemask_epi8(opaque) == 0xFFFF)
+    return SwapRB(px);
+  __m128i lo = _mm_unpacklo_epi8(px, zero);
+  __m128i hi = _mm_unpackhi_epi8(px, zero);
+  __m128i p0 = UnpremulSwizzle32(_mm_unpacklo_epi16(lo, zero));
+  __m128i p1 = UnpremulSwizzle32(_mm_unpackhi_epi16(lo, zero));
+  __m128i p2 = UnpremulSwizzle32(_mm_unpacklo_epi16(hi, zero));
+  __m128i p3 = UnpremulSwizzle32(_mm_unpackhi_epi16(hi, zero));
+  return _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+}
+
+void RGBAToPremulBGRASSE2(const uint8_t* src, uint8_t* dst, int width) {
+  const __m128i zero = _mm_setzero_si128();
+  int x = 0;
+  for (; x + 4 <= width; x += 4, src += 16, dst += 16) {
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i lo = PremulSwizzle16(_mm_unpacklo_epi8(px, zero));
+    __m128i hi = PremulSwizzle16(_mm_unpackhi_epi8(px, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(lo, hi));
+  }
+  RGBAToPremulBGRAScalar(src, dst, width - x);
+}
+
+void PremulBGRAToRGBASSE2(const uint8_t* src, uint8_t* dst, int width) {
+  int x = 0;
+  for (; x + 4 <= width; x += 4, src += 16, dst += 16) {
+    __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), PremulBGRAToRGBA4(px));
+  }
+  PremulBGRAToRGBAScalar(src, dst, width - x);
+}
+
+TARGET_AVX2
+void RGBAToPremulBGRAAVX2(const uint8_t* src, uint8_t* dst, int width) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i kColorMask = _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1,
+                                              0, -1, -1, -1, 0, -1, -1, -1);
+  const __m256i kAlpha255 = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0,
+                                             255, 0, 0, 0, 255, 0, 0, 0);
+  const __m256i kRound = _mm256_set1_epi16(128);
+  const int kSwizzle = _MM_SHUFFLE(3, 0, 1, 2);
+  int x = 0;
+  for (; x + 8 <= width; x += 8, src += 32, dst += 32) {
+    __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    // The unpack and pack instructions work on each 128bit lane separately,
+    // so the order of pixels is preserved after the round trip.
+    __m256i v[2] = { _mm256_unpacklo_epi8(px, zero),
+                     _mm256_unpackhi_epi8(px, zero) };
+    for (__m256i& c : v) {
+      __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, 0xFF),
+                                         0xFF);
+      a = _mm256_or_si256(_mm256_and_si256(a, kColorMask), kAlpha255);
+      c = _mm256_add_epi16(_mm256_mullo_epi16(c, a), kRound);
+      c = _mm256_srli_epi16(_mm256_add_epi16(c, _mm256_srli_epi16(c, 8)), 8);
+      c = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, kSwizzle),
+                                 kSwizzle);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_packus_epi16(v[0], v[1]));
+  }
+  RGBAToPremulBGRASSE2(src, dst, width - x);
+}
+
+TARGET_AVX2
+void PremulBGRAToRGBAAVX2(const uint8_t* src, uint8_t* dst, int width) {
+  const __m256i kOpaque = _mm256_set1_epi32(0xFF000000);
+  const __m256i kSwapRB = _mm256_setr_epi8(
+      2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+      2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+  int x = 0;
+  for (; x + 8 <= width; x += 8, src += 32, dst += 32) {
+    __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    __m256i opaque = _mm256_cmpeq_epi32(_mm256_and_si256(px, kOpaque),
+                                        kOpaque);
+    if (_mm256_movemask_epi8(opaque) == -1) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                          _mm256_shuffle_epi8(px, kSwapRB));
+      continue;
+    }
+    // Division does not gain much from wider registers, use the 128bit path
+    // for translucent pixels.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     PremulBGRAToRGBA4(_mm256_castsi256_si128(px)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16),
+                     PremulBGRAToRGBA4(_mm256_extracti128_si256(px, 1)));
+  }
+  PremulBGRAToRGBASSE2(src, dst, width - x);
+}
+
+TARGET_AVX2
+void RGBToBGRAAVX2(const uint8_t* src, uint8_t* dst, int width) {
+  const __m128i kShuffle = _mm_setr_epi8(2, 1, 0, -128, 5, 4, 3, -128,
+                                         8, 7, 6, -128, 11, 10, 9, -128);
+  const __m128i kAlpha = _mm_set1_epi32(0xFF000000);
+  int x = 0;
+  // Each load reads 16 bytes for 4 pixels (12 bytes), make sure the extra
+  // bytes are still inside the row.
+  for (; x + 10 <= width; x += 8, src += 24, dst += 32) {
+    __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    p0 = _mm_or_si128(_mm_shuffle_epi8(p0, kShuffle), kAlpha);
+    p1 = _mm_or_si128(_mm_shuffle_epi8(p1, kShuffle), kAlpha);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst),
+        _mm256_inserti128_si256(_mm256_castsi128_si256(p0), p1, 1));
+  }
+  RGBToBGRAScalar(src, dst, width - x);
+}
+
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+const Kernels kKernels[] = {
+  { PixelConvertISA::Scalar,
+    &RGBAToPremulBGRAScalar, &PremulBGRAToRGBAScalar, &RGBToBGRAScalar },
+#if defined(ARCH_CPU_X86_FAMILY)
+  // SSE2 does not have byte shuffles, RGB conversion is left to scalar code.
+  { PixelConvertISA::SSE2,
+    &RGBAToPremulBGRASSE2, &PremulBGRAToRGBASSE2, &RGBToBGRAScalar },
+  { PixelConvertISA::AVX2,
+    &RGBAToPremulBGRAAVX2, &PremulBGRAToRGBAAVX2, &RGBToBGRAAVX2 },
+#endif
+};
+
+PixelConvertISA GetSupportedISA() {
+#if defined(ARCH_CPU_X86_FAMILY)
+  static const PixelConvertISA isa = []() {
+    base::CPU cpu;
+    if (cpu.has_avx2())
+      return PixelConvertISA::AVX2;
+    if (cpu.has_sse2())
+      return PixelConvertISA::SSE2;
+    return PixelConvertISA::Scalar;
+  }();
+  return isa;
+#else
+  return PixelConvertISA::Scalar;
+#endif
+}
+
+std::atomic<const Kernels*> g_kernels(nullptr);
+
+const Kernels& GetKernels() {
+  const Kernels* kernels = g_kernels.load(std::memory_order_acquire);
+  if (!kernels) {
+    kernels = &kKernels[static_cast<int>(GetSupportedISA())];
+    g_kernels.store(kernels, std::memory_order_release);
+  }
+  return *kernels;
+}
+
+inline void ConvertRows(RowConverter converter,
+                        const uint8_t* src, int src_stride,
+                        uint8_t* dst, int dst_stride,
+                        int width, int height) {
+  for (int y = 0; y < height; ++y, src += src_stride, dst += dst_stride)
+    converter(src, dst, width);
+}
+
+}  // namespace
+
+PixelConvertISA GetPixelConvertISA() {
+  return GetKernels().isa;
+}
+
+void SetPixelConvertISAForTesting(PixelConvertISA isa) {
+  if (static_cast<int>(isa) > static_cast<int>(GetSupportedISA()))
+    isa = GetSupportedISA();
+  g_kernels.store(&kKernels[static_cast<int>(isa)], std::memory_order_release);
+}
+
+void ConvertRGBAToPremulBGRA(const uint8_t* src, int src_stride,
+                             uint8_t* dst, int dst_stride,
+                             int width, int height) {
+  ConvertRows(GetKernels().rgba_to_premul_bgra,
+              src, src_stride, dst, dst_stride, width, height);
+}
+
+void ConvertPremulBGRAToRGBA(const uint8_t* src, int src_stride,
+                             uint8_t* dst, int dst_stride,
+                             int width, int height) {
+  ConvertRows(GetKernels().premul_bgra_to_rgba,
+              src, src_stride, dst, dst_stride, width, height);
+}
+
+void ConvertRGBToBGRA(const uint8_t* src, int src_stride,
+                      uint8_t* dst, int dst_stride,
+                      int width, int height) {
+  ConvertRows(GetKernels().rgb_to_bgra,
+              src, src_stride, dst, dst_stride, width, height);
+}
+
+}  // namespace nu
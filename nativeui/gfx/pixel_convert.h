@@ -0,0 +1,65 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_PIXEL_CONVERT_H_
+#define NATIVEUI_GFX_PIXEL_CONVERT_H_
+
+#include <stdint.h>
+
+#include "nativeui/nativeui_export.h"
+
+namespace nu {
+
+// Conversions between the pixel formats used by image libraries (straight
+// RGBA/RGB byte order, like GdkPixbuf) and the native 32bit premultiplied
+// format used by rasterizers (like CAIRO_FORMAT_ARGB32, which is BGRA in
+// memory on little-endian machines).
+//
+// The "BGRA" buffers are arrays of native-endian uint32 values in the form of
+// 0xAARRGGBB, which is the layout cairo and Direct2D use.
+//
+// The kernels are selected at runtime according to the instruction sets the
+// CPU supports, and all kernels produce bit-identical results.
+
+// The instruction sets the kernels can be dispatched to.
+enum class PixelConvertISA {
+  Scalar,
+  SSE2,
+  AVX2,
+};
+
+// Return the instruction set currently used by the kernels.
+NATIVEUI_EXPORT PixelConvertISA GetPixelConvertISA();
+
+// Force the kernels to use |isa|, the request is clamped to what the CPU
+// supports. Used by tests and benchmarks.
+NATIVEUI_EXPORT void SetPixelConvertISAForTesting(PixelConvertISA isa);
+
+// Convert straight RGBA pixels to premultiplied BGRA pixels.
+NATIVEUI_EXPORT void ConvertRGBAToPremulBGRA(const uint8_t* src,
+                                             int src_stride,
+                                             uint8_t* dst,
+                                             int dst_stride,
+                                             int width,
+                                             int height);
+
+// Convert premultiplied BGRA pixels to straight RGBA pixels.
+NATIVEUI_EXPORT void ConvertPremulBGRAToRGBA(const uint8_t* src,
+                                             int src_stride,
+                                             uint8_t* dst,
+                                             int dst_stride,
+                                             int width,
+                                             int height);
+
+// Convert RGB pixels to opaque BGRA pixels.
+NATIVEUI_EXPORT void ConvertRGBToBGRA(const uint8_t* src,
+                                      int src_stride,
+                                      uint8_t* dst,
+                                      int dst_stride,
+                                      int width,
+                                      int height);
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_PIXEL_CONVERT_H_
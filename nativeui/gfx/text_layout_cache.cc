@@ -0,0 +1,113 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/text_layout_cache.h"
+
+#include <string.h>
+
+#include "nativeui/gfx/font.h"
+#include "nativeui/gfx/geometry/size_f.h"
+#include "nativeui/gfx/text.h"
+
+namespace nu {
+
+namespace {
+
+// The non-text part of the key, stored as raw bytes after the text.
+struct KeySuffix {
+  float font_size;
+  int32_t font_weight;
+  int32_t font_style;
+  uint32_t color;
+  uint8_t align;
+  uint8_t valign;
+  uint8_t wrap;
+  uint8_t ellipsis;
+  float width;
+  float height;
+};
+
+std::string GetKey(const std::string& text,
+                   const TextAttributes& attributes,
+                   const SizeF& size) {
+  KeySuffix suffix;
+  memset(&suffix, 0, sizeof(suffix));
+  suffix.font_size = attributes.font->GetSize();
+  suffix.font_weight = static_cast<int32_t>(attributes.font->GetWeight());
+  suffix.font_style = static_cast<int32_t>(attributes.font->GetStyle());
+  suffix.color = attributes.color.value();
+  suffix.align = static_cast<uint8_t>(attributes.align);
+  suffix.valign = static_cast<uint8_t>(attributes.valign);
+  suffix.wrap = attributes.wrap;
+  suffix.ellipsis = attributes.ellipsis;
+  // The size only affects layout when wrapping.
+  if (attributes.wrap) {
+    suffix.width = size.width();
+    suffix.height = size.height();
+  }
+
+  std::string font_name = attributes.font->GetName();
+  std::string key;
+  key.reserve(text.size() + font_name.size() + sizeof(suffix) + 2);
+  key.append(text);
+  key.push_back('\0');
+  key.append(font_name);
+  key.push_back('\0');
+  key.append(reinterpret_cast<const char*>(&suffix), sizeof(suffix));
+  return key;
+}
+
+scoped_refptr<AttributedText> CreateLayout(const std::string& str,
+                                           const TextAttributes& attributes) {
+  scoped_refptr<AttributedText> text(new AttributedText(str, attributes));
+  text->SetFont(attributes.font.get());
+  text->SetColor(attributes.color);
+  return text;
+}
+
+}  // namespace
+
+TextLayoutCache::TextLayoutCache(size_t capacity)
+    : cache_(Cache::NO_AUTO_EVICT), capacity_(capacity) {}
+
+TextLayoutCache::~TextLayoutCache() {}
+
+scoped_refptr<AttributedText> TextLayoutCache::Get(
+    const std::string& text,
+    const TextAttributes& attributes,
+    const SizeF& size) {
+  if (capacity_ == 0) {
+    ++misses_;
+    return CreateLayout(text, attributes);
+  }
+
+  std::string key = GetKey(text, attributes, size);
+  auto it = cache_.Get(key);
+  if (it != cache_.end()) {
+    ++hits_;
+    return it->second;
+  }
+
+  ++misses_;
+  scoped_refptr<AttributedText> layout = CreateLayout(text, attributes);
+  cache_.Put(std::move(key), layout);
+  cache_.ShrinkToSize(capacity_);
+  return layout;
+}
+
+void TextLayoutCache::SetCapacity(size_t capacity) {
+  capacity_ = capacity;
+  cache_.ShrinkToSize(capacity_);
+}
+
+void TextLayoutCache::Clear() {
+  cache_.Clear();
+}
+
+void TextLayoutCache::ResetStats() {
+  hits_ = 0;
+  misses_ = 0;
+}
+
+}  // namespace nu
@@ -0,0 +1,64 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_TEXT_LAYOUT_CACHE_H_
+#define NATIVEUI_GFX_TEXT_LAYOUT_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "nativeui/gfx/attributed_text.h"
+
+namespace nu {
+
+class SizeF;
+struct TextAttributes;
+
+// LRU cache of shaped text layouts, used by Painter::DrawText to avoid
+// creating and measuring a new layout for strings that are drawn every frame.
+//
+// Layouts are keyed by the text, the font and color, the format and the size
+// the text is laid out in.
+class NATIVEUI_EXPORT TextLayoutCache {
+ public:
+  static const size_t kDefaultCapacity = 512;
+
+  explicit TextLayoutCache(size_t capacity = kDefaultCapacity);
+  ~TextLayoutCache();
+
+  // Return a layout of |text| for drawing in |size|, the layout is created
+  // when there is no cached one.
+  scoped_refptr<AttributedText> Get(const std::string& text,
+                                    const TextAttributes& attributes,
+                                    const SizeF& size);
+
+  // Change the max number of cached layouts, passing 0 disables the cache.
+  void SetCapacity(size_t capacity);
+  size_t GetCapacity() const { return capacity_; }
+
+  // Remove all cached layouts, called when fonts or screen resolution change.
+  void Clear();
+
+  // Statistics.
+  size_t size() const { return cache_.size(); }
+  size_t hits() const { return hits_; }
+  size_t misses() const { return misses_; }
+  void ResetStats();
+
+ private:
+  using Cache = base::HashingMRUCache<std::string,
+                                      scoped_refptr<AttributedText>>;
+
+  Cache cache_;
+  size_t capacity_;
+  size_t hits_ = 0;
+  size_t misses_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TextLayoutCache);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_TEXT_LAYOUT_CACHE_H_
@@ -0,0 +1,36 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gfx/text_measurer.h"
+
+#include <limits>
+
+#include "nativeui/gfx/attributed_text.h"
+#include "nativeui/gfx/geometry/rect_f.h"
+
+namespace nu {
+
+// static
+std::vector<SizeF> TextMeasurer::MeasureBatch(
+    const std::vector<std::string>& strings,
+    const TextAttributes& attributes,
+    float max_width) {
+#if defined(OS_LINUX)
+  return PlatformMeasureBatch(strings, attributes, max_width);
+#else
+  std::vector<SizeF> results;
+  results.reserve(strings.size());
+  bool wrap = attributes.wrap && max_width > 0;
+  SizeF bounds(max_width, std::numeric_limits<float>::max());
+  for (const std::string& str : strings) {
+    scoped_refptr<AttributedText> text(new AttributedText(str, attributes));
+    text->SetFont(attributes.font.get());
+    results.push_back(wrap ? text->GetBoundsFor(bounds).size()
+                           : text->GetSize());
+  }
+  return results;
+#endif
+}
+
+}  // namespace nu
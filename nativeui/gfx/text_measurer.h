@@ -0,0 +1,45 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GFX_TEXT_MEASURER_H_
+#define NATIVEUI_GFX_TEXT_MEASURER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "nativeui/gfx/geometry/size_f.h"
+#include "nativeui/gfx/text.h"
+
+namespace nu {
+
+// Measure many strings at once, used for things like auto-sizing table
+// columns and estimating row heights.
+class NATIVEUI_EXPORT TextMeasurer {
+ public:
+  // Return the sizes needed to draw each of the |strings| with |attributes|,
+  // lines are wrapped at |max_width| when it is positive and wrapping is
+  // enabled.
+  //
+  // On Linux large batches are split between worker threads, each of which
+  // has its own font map.
+  static std::vector<SizeF> MeasureBatch(
+      const std::vector<std::string>& strings,
+      const TextAttributes& attributes,
+      float max_width);
+
+ private:
+#if defined(OS_LINUX)
+  static std::vector<SizeF> PlatformMeasureBatch(
+      const std::vector<std::string>& strings,
+      const TextAttributes& attributes,
+      float max_width);
+#endif
+
+  DISALLOW_IMPLICIT_CONSTRUCTORS(TextMeasurer);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GFX_TEXT_MEASURER_H_
@@ -11,6 +11,7 @@
 #include "base/win/scoped_gdi_object.h"
 #include "base/win/scoped_hdc.h"
 #include "base/win/scoped_select_object.h"
+#include "nativeui/gfx/font_registry.h"
 #include "nativeui/gfx/win/gdiplus.h"
 #include "nativeui/gfx/win/scoped_set_map_mode.h"
 
@@ -53,6 +54,8 @@ Font::Font(const std::string& name, float size, Weight weight, Style style) {
 }
 
 Font::~Font() {
+  if (registry_)
+    registry_->Remove(this);
   delete font_;
   if (hfont_)
     ::DeleteObject(hfont_);
@@ -94,6 +97,22 @@ const std::wstring& Font::GetName16() const {
   return font_family_;
 }
 
+Font::Metrics Font::PlatformGetMetrics() const {
+  base::win::ScopedGetDC screen_dc(NULL);
+  ScopedSetMapMode mode(screen_dc, MM_TEXT);
+  base::win::ScopedSelectObject scoped_font(screen_dc, GetHFONT(NULL));
+  TEXTMETRIC fm;
+  ::GetTextMetrics(screen_dc, &fm);
+  // Convert pixels to DIP.
+  float scale = ::GetDeviceCaps(screen_dc, LOGPIXELSY) / 96.f;
+  Metrics metrics;
+  metrics.ascent = fm.tmAscent / scale;
+  metrics.descent = fm.tmDescent / scale;
+  metrics.line_height = (fm.tmHeight + fm.tmExternalLeading) / scale;
+  metrics.average_char_width = fm.tmAveCharWidth / scale;
+  return metrics;
+}
+
 HFONT Font::GetHFONT(HWND hwnd) const {
   if (!hfont_) {
     base::win::ScopedGetDC dc(hwnd);
@@ -7,6 +7,13 @@
 #include <JavaScriptCore/JavaScript.h>
 #include <webkit2/webkit2.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "base/json/json_reader.h"
 #include "nativeui/gtk/nu_protocol_stream.h"
 #include "nativeui/gtk/widget_util.h"
@@ -26,20 +33,179 @@ std::string JSStringToString(JSStringRef js) {
   return str;
 }
 
+// Converting values nested deeper than this is likely a bug.
+const size_t kMaxDepth = 100;
+
+// Convert JavaScript values to base::Value by walking them directly, which
+// avoids the round trip of JSON serialization. The results follow the rules
+// of JSON.stringify, except that ArrayBuffers and typed arrays are converted
+// to binary values.
+class JSValueConverter {
+ public:
+  explicit JSValueConverter(JSContextRef context) : context_(context) {}
+
+  base::Value Convert(JSValueRef value) {
+    switch (JSValueGetType(context_, value)) {
+      case kJSTypeUndefined:
+      case kJSTypeNull:
+        return base::Value();
+      case kJSTypeBoolean:
+        return base::Value(JSValueToBoolean(context_, value));
+      case kJSTypeNumber:
+        return ConvertNumber(JSValueToNumber(context_, value, nullptr));
+      case kJSTypeString:
+        return ConvertString(value);
+      default:
+        return ConvertObject(value);
+    }
+  }
+
+ private:
+  // Keep the objects being converted to detect cycles and limit depth.
+  class ScopedPath {
+   public:
+    ScopedPath(JSValueConverter* converter, JSObjectRef object)
+        : converter_(converter) {
+      converter_->path_.push_back(object);
+    }
+    ~ScopedPath() { converter_->path_.pop_back(); }
+
+   private:
+    JSValueConverter* converter_;
+  };
+
+  base::Value ConvertNumber(double number) {
+    if (std::isnan(number) || std::isinf(number))
+      return base::Value();
+    // Integers are stored as int, which is what JSONReader does.
+    if (number == std::floor(number) &&
+        number >= std::numeric_limits<int>::min() &&
+        number <= std::numeric_limits<int>::max())
+      return base::Value(static_cast<int>(number));
+    return base::Value(number);
+  }
+
+  base::Value ConvertString(JSValueRef value) {
+    JSStringRef str = JSValueToStringCopy(context_, value, nullptr);
+    if (!str)
+      return base::Value();
+    base::Value result(JSStringToString(str));
+    JSStringRelease(str);
+    return result;
+  }
+
+  base::Value ConvertObject(JSValueRef value) {
+    JSObjectRef object = JSValueToObject(context_, value, nullptr);
+    if (!object || JSObjectIsFunction(context_, object))
+      return base::Value();
+    if (path_.size() >= kMaxDepth ||
+        std::find(path_.begin(), path_.end(), object) != path_.end()) {
+      LOG(ERROR) << "Converting JavaScript value with cycles or too deep";
+      return base::Value();
+    }
+    ScopedPath scoped_path(this, object);
+
+    // Binary data are copied directly.
+    JSTypedArrayType array_type =
+        JSValueGetTypedArrayType(context_, object, nullptr);
+    if (array_type == kJSTypedArrayTypeArrayBuffer) {
+      return ConvertBinary(
+          JSObjectGetArrayBufferBytesPtr(context_, object, nullptr),
+          JSObjectGetArrayBufferByteLength(context_, object, nullptr));
+    } else if (array_type != kJSTypedArrayTypeNone) {
+      return ConvertBinary(
+          static_cast<const char*>(
+              JSObjectGetTypedArrayBytesPtr(context_, object, nullptr)) +
+              JSObjectGetTypedArrayByteOffset(context_, object, nullptr),
+          JSObjectGetTypedArrayByteLength(context_, object, nullptr));
+    }
+
+    // Objects with custom serialization like Date are left to JSON.
+    JSValueRef to_json = GetProperty(object, "toJSON");
+    if (to_json && JSValueIsObject(context_, to_json) &&
+        JSObjectIsFunction(context_, JSValueToObject(context_, to_json,
+                                                     nullptr)))
+      return ConvertWithJSON(object);
+
+    if (JSValueIsArray(context_, object))
+      return ConvertArray(object);
+    return ConvertDictionary(object);
+  }
+
+  base::Value ConvertBinary(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    if (!bytes)
+      return base::Value(base::Value::Type::BINARY);
+    return base::Value(base::Value::BlobStorage(bytes, bytes + size));
+  }
+
+  base::Value ConvertArray(JSObjectRef array) {
+    JSValueRef length = GetProperty(array, "length");
+    size_t size = length ? JSValueToNumber(context_, length, nullptr) : 0;
+    base::Value::ListStorage list;
+    list.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      JSValueRef exception = nullptr;
+      JSValueRef item = JSObjectGetPropertyAtIndex(
+          context_, array, static_cast<unsigned>(i), &exception);
+      // Invalid items in array are converted to null, like JSON.
+      list.push_back(exception ? base::Value() : Convert(item));
+    }
+    return base::Value(std::move(list));
+  }
+
+  base::Value ConvertDictionary(JSObjectRef object) {
+    base::Value dict(base::Value::Type::DICTIONARY);
+    JSPropertyNameArrayRef names = JSObjectCopyPropertyNames(context_, object);
+    size_t count = JSPropertyNameArrayGetCount(names);
+    for (size_t i = 0; i < count; ++i) {
+      JSStringRef name = JSPropertyNameArrayGetNameAtIndex(names, i);
+      JSValueRef exception = nullptr;
+      JSValueRef value = JSObjectGetProperty(context_, object, name,
+                                             &exception);
+      // Undefined values and functions are skipped, like JSON.
+      if (exception || JSValueIsUndefined(context_, value))
+        continue;
+      if (JSValueIsObject(context_, value) &&
+          JSObjectIsFunction(context_,
+                             JSValueToObject(context_, value, nullptr)))
+        continue;
+      dict.SetKey(JSStringToString(name), Convert(value));
+    }
+    JSPropertyNameArrayRelease(names);
+    return dict;
+  }
+
+  base::Value ConvertWithJSON(JSObjectRef object) {
+    JSStringRef json = JSValueCreateJSONString(context_, object, 0, nullptr);
+    if (!json)
+      return base::Value();
+    std::string json_str = JSStringToString(json);
+    JSStringRelease(json);
+    std::unique_ptr<base::Value> result = base::JSONReader::Read(json_str);
+    if (!result)
+      return base::Value();
+    return std::move(*result.release());
+  }
+
+  JSValueRef GetProperty(JSObjectRef object, const char* name) {
+    JSStringRef str = JSStringCreateWithUTF8CString(name);
+    JSValueRef exception = nullptr;
+    JSValueRef value = JSObjectGetProperty(context_, object, str, &exception);
+    JSStringRelease(str);
+    return exception ? nullptr : value;
+  }
+
+  JSContextRef context_;
+  std::vector<JSObjectRef> path_;
+
+  DISALLOW_COPY_AND_ASSIGN(JSValueConverter);
+};
+
 base::Value JSResultToBaseValue(WebKitJavascriptResult* js_result) {
   auto* context = webkit_javascript_result_get_global_context(js_result);
   auto* value = webkit_javascript_result_get_value(js_result);
-  // While manually iterating the value should be more efficient, their API is
-  // such a pain to use.
-  JSStringRef json = JSValueCreateJSONString(context, value, 0, nullptr);
-  if (!json)
-    return base::Value();
-  std::string json_str = JSStringToString(json);
-  JSStringRelease(json);
-  std::unique_ptr<base::Value> result = base::JSONReader::Read(json_str);
-  if (!result)
-    return base::Value();
-  return std::move(*result.release());
+  return JSValueConverter(context).Convert(value);
 }
 
 gboolean OnContextMenu(WebKitWebView* widget,
@@ -122,6 +288,13 @@ void OnScriptMessage(WebKitUserContentManager* manager,
   if (browser->stop_serving() || !js_result)
     return;
   base::Value args = JSResultToBaseValue(js_result);
+  // Messages of the message port.
+  if (args.is_list() && args.GetList().size() == 2 &&
+      args.GetList()[0].is_string() && args.GetList()[1].is_list()) {
+    browser->InvokeMessagePort(args.GetList()[0].GetString(),
+                               std::move(args.GetList()[1]));
+    return;
+  }
   if (!args.is_list() || args.GetList().size() != 3 ||
       !args.GetList()[0].is_string() ||
       !args.GetList()[1].is_string() ||
@@ -160,12 +333,32 @@ void OnProtocolRequest(WebKitURISchemeRequest* request,
   GInputStream* protocol_stream = nu_protocol_stream_new(protocol_job);
   std::string mime_type;
   protocol_job->GetMimeType(&mime_type);
+  // Serve content already in memory without copying.
+  scoped_refptr<base::RefCountedMemory> content =
+      protocol_job->GetMappedContent();
   // Start.
   g_object_ref(request);
-  protocol_job->Plug([protocol_stream, request, mime_type](int size) {
-    webkit_uri_scheme_request_finish(
-        request, protocol_stream, size,
-        mime_type.empty() ? nullptr : mime_type.c_str());
+  protocol_job->Plug([protocol_stream, request, mime_type,
+                      content](int64_t size) {
+    if (content) {
+      content->AddRef();
+      GBytes* bytes = g_bytes_new_with_free_func(
+          content->front(), content->size(),
+          [](gpointer memory) {
+            static_cast<base::RefCountedMemory*>(memory)->Release();
+          },
+          content.get());
+      GInputStream* stream = g_memory_input_stream_new_from_bytes(bytes);
+      webkit_uri_scheme_request_finish(
+          request, stream, g_bytes_get_size(bytes),
+          mime_type.empty() ? nullptr : mime_type.c_str());
+      g_object_unref(stream);
+      g_bytes_unref(bytes);
+    } else {
+      webkit_uri_scheme_request_finish(
+          request, protocol_stream, size,
+          mime_type.empty() ? nullptr : mime_type.c_str());
+    }
     g_object_unref(protocol_stream);
     g_object_unref(request);
   });
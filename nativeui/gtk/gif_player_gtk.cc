@@ -6,6 +6,7 @@
 
 #include <gtk/gtk.h>
 
+#include "nativeui/gfx/gtk/pixbuf_util.h"
 #include "nativeui/gfx/image.h"
 
 namespace nu {
@@ -37,8 +38,15 @@ gboolean OnDraw(GtkWidget* widget, cairo_t* cr, GifPlayer* view) {
   if (scale != 1.f)
     cairo_scale(cr, scale, scale);
 
-  // Paint.
-  gdk_cairo_set_source_pixbuf(cr, pixbuf, 0, 0);
+  // Paint, animation frames may be updated in place so only the static image
+  // can use the cached surface.
+  if (view->CanAnimate()) {
+    cairo_surface_t* surface = CreateSurfaceFromPixbuf(pixbuf);
+    cairo_set_source_surface(cr, surface, 0, 0);
+    cairo_surface_destroy(surface);
+  } else {
+    cairo_set_source_surface(cr, GetCachedSurfaceForPixbuf(pixbuf), 0, 0);
+  }
   cairo_paint(cr);
   return FALSE;
 }
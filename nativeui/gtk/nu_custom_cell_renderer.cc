@@ -4,16 +4,38 @@
 
 #include "nativeui/gtk/nu_custom_cell_renderer.h"
 
+#include <map>
+
 #include "base/values.h"
 #include "nativeui/gfx/gtk/painter_gtk.h"
 
 namespace nu {
 
+namespace {
+
+// Only keep cached drawings of rows around the drawn row.
+const int kRowsToKeep = 128;
+
+// Rendered drawing of a cell.
+struct CachedSurface {
+  int width;
+  int height;
+  int scale;
+  cairo_surface_t* surface;
+};
+
+}  // namespace
+
 enum { PROP_VALUE = 1 };
 
 struct _NUCustomCellRendererPrivate {
   Table::ColumnOptions options;
-  base::Value value;
+  // Reference to the value in model, only valid during rendering.
+  const base::Value* value;
+  // The row being rendered, -1 if unknown.
+  int row;
+  // Maps rows to their drawings.
+  std::map<int, CachedSurface> cache;
 };
 
 static void nu_custom_cell_renderer_class_init(
@@ -61,8 +83,9 @@ static void nu_custom_cell_renderer_class_init(NUCustomCellRendererClass* cl) {
 static void nu_custom_cell_renderer_finalize(GObject* object) {
   // Call in-place destructor since we don't manage its memory.
   NUCustomCellRendererPrivate* priv = NU_CUSTOM_CELL_RENDERER(object)->priv;
+  nu_custom_cell_renderer_invalidate(GTK_CELL_RENDERER(object), 0, G_MAXINT);
   priv->options.Table::ColumnOptions::~ColumnOptions();
-  priv->value.base::Value::~Value();
+  priv->cache.std::map<int, CachedSurface>::~map();
 
   G_OBJECT_CLASS(nu_custom_cell_renderer_parent_class)->finalize(object);
 }
@@ -76,11 +99,8 @@ static void nu_custom_cell_renderer_set_property(GObject* object,
     return;
   }
   NUCustomCellRendererPrivate* priv = NU_CUSTOM_CELL_RENDERER(object)->priv;
-  auto* value = static_cast<const base::Value*>(g_value_get_pointer(gval));
-  if (value)
-    priv->value = base::Value(value->Clone());
-  else
-    priv->value = base::Value();
+  priv->value = static_cast<const base::Value*>(g_value_get_pointer(gval));
+  priv->row = -1;
 }
 
 static void nu_custom_cell_renderer_get_size(GtkCellRenderer* renderer,
@@ -114,17 +134,57 @@ static void nu_custom_cell_renderer_render(GtkCellRenderer* cell,
   cairo_rectangle(cr, 0, 0, cell_area->width, cell_area->height);
   cairo_clip(cr);
 
-  PainterGtk painter(cr);
-  priv->options.on_draw(&painter,
-                        nu::RectF(0, 0, cell_area->width, cell_area->height),
-                        priv->value);
+  base::Value null_value;
+  const base::Value& value = priv->value ? *priv->value : null_value;
+  RectF bounds(0, 0, cell_area->width, cell_area->height);
+  if (!priv->options.cache_drawing || priv->row < 0) {
+    PainterGtk painter(cr);
+    priv->options.on_draw(&painter, bounds, value);
+    return;
+  }
+
+  // Reuse the drawing of the cell if it has not been changed.
+  int scale = gtk_widget_get_scale_factor(widget);
+  auto it = priv->cache.find(priv->row);
+  if (it == priv->cache.end() ||
+      it->second.width != cell_area->width ||
+      it->second.height != cell_area->height ||
+      it->second.scale != scale) {
+    if (it != priv->cache.end()) {
+      cairo_surface_destroy(it->second.surface);
+      priv->cache.erase(it);
+    }
+    // Drop drawings of rows that have been scrolled away.
+    if (priv->cache.size() > 2 * kRowsToKeep) {
+      nu_custom_cell_renderer_invalidate(cell, G_MININT,
+                                         priv->row - kRowsToKeep);
+      nu_custom_cell_renderer_invalidate(cell, priv->row + kRowsToKeep + 1,
+                                         G_MAXINT);
+    }
+    cairo_surface_t* surface = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32,
+        cell_area->width * scale,
+        cell_area->height * scale);
+    cairo_surface_set_device_scale(surface, scale, scale);
+    {
+      PainterGtk painter(surface, scale);
+      priv->options.on_draw(&painter, bounds, value);
+    }
+    CachedSurface cached = {cell_area->width, cell_area->height, scale,
+                            surface};
+    it = priv->cache.emplace(priv->row, cached).first;
+  }
+  cairo_set_source_surface(cr, it->second.surface, 0, 0);
+  cairo_paint(cr);
 }
 
 static void nu_custom_cell_renderer_init(NUCustomCellRenderer* cell) {
   g_object_set(G_OBJECT(cell), "mode", GTK_CELL_RENDERER_MODE_INERT, nullptr);
   cell->priv = static_cast<NUCustomCellRendererPrivate*>(
       nu_custom_cell_renderer_get_instance_private(cell));
-  new(&cell->priv->value) base::Value();
+  cell->priv->value = nullptr;
+  cell->priv->row = -1;
+  new(&cell->priv->cache) std::map<int, CachedSurface>();
 }
 
 GtkCellRenderer* nu_custom_cell_renderer_new(
@@ -136,4 +196,23 @@ GtkCellRenderer* nu_custom_cell_renderer_new(
   return GTK_CELL_RENDERER(object);
 }
 
+void nu_custom_cell_renderer_set_cell(GtkCellRenderer* renderer,
+                                      int row,
+                                      const base::Value* value) {
+  NUCustomCellRendererPrivate* priv = NU_CUSTOM_CELL_RENDERER(renderer)->priv;
+  priv->value = value;
+  priv->row = row;
+}
+
+void nu_custom_cell_renderer_invalidate(GtkCellRenderer* renderer,
+                                        int start,
+                                        int end) {
+  NUCustomCellRendererPrivate* priv = NU_CUSTOM_CELL_RENDERER(renderer)->priv;
+  auto first = priv->cache.lower_bound(start);
+  auto last = priv->cache.lower_bound(end);
+  for (auto it = first; it != last; ++it)
+    cairo_surface_destroy(it->second.surface);
+  priv->cache.erase(first, last);
+}
+
 }  // namespace nu
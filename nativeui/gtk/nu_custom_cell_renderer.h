@@ -37,6 +37,17 @@ GType nu_custom_cell_renderer_get_type();
 GtkCellRenderer* nu_custom_cell_renderer_new(
     const Table::ColumnOptions& options);
 
+// Pass the |value| of |row| to renderer without copying, the |value| must
+// stay alive until the cell is rendered.
+void nu_custom_cell_renderer_set_cell(GtkCellRenderer* renderer,
+                                      int row,
+                                      const base::Value* value);
+
+// Drop the cached drawings of rows in [start, end).
+void nu_custom_cell_renderer_invalidate(GtkCellRenderer* renderer,
+                                        int start,
+                                        int end);
+
 }  // namespace nu
 
 #endif  // NATIVEUI_GTK_NU_CUSTOM_CELL_RENDERER_H_
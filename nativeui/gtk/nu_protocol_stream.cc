@@ -10,11 +10,19 @@ namespace nu {
 
 struct _NUProtocolStreamPrivate {
   scoped_refptr<ProtocolJob> protocol_job;
+  // The position of next read.
+  goffset position;
 };
 
-G_DEFINE_TYPE_WITH_PRIVATE(NUProtocolStream,
-                           nu_protocol_stream,
-                           G_TYPE_INPUT_STREAM)
+static void nu_protocol_stream_seekable_iface_init(GSeekableIface* iface);
+
+G_DEFINE_TYPE_WITH_CODE(NUProtocolStream,
+                        nu_protocol_stream,
+                        G_TYPE_INPUT_STREAM,
+                        G_ADD_PRIVATE(NUProtocolStream)
+                        G_IMPLEMENT_INTERFACE(
+                            G_TYPE_SEEKABLE,
+                            nu_protocol_stream_seekable_iface_init))
 
 static void nu_protocol_stream_finialize(GObject* stream) {
   // Call in-place destructor since we don't manage its memory.
@@ -28,7 +36,33 @@ static gssize nu_protocol_stream_read(GInputStream* stream,
                                       void* buffer, gsize count,
                                       GCancellable*, GError**) {
   NUProtocolStreamPrivate* priv = NU_PROTOCOL_STREAM(stream)->priv;
-  return priv->protocol_job->Read(buffer, count);
+  size_t nread = priv->protocol_job->Read(buffer, count);
+  priv->position += nread;
+  return nread;
+}
+
+static void nu_protocol_stream_read_async(GInputStream* stream,
+                                         void* buffer, gsize count,
+                                         int io_priority,
+                                         GCancellable* cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data) {
+  NUProtocolStreamPrivate* priv = NU_PROTOCOL_STREAM(stream)->priv;
+  GTask* task = g_task_new(stream, cancellable, callback, user_data);
+  g_task_set_priority(task, io_priority);
+  // The task keeps the stream, and thus the job and buffer, alive until read
+  // is finished.
+  priv->protocol_job->ReadAsync(buffer, count, [task, priv](size_t nread) {
+    priv->position += nread;
+    g_task_return_int(task, nread);
+    g_object_unref(task);
+  });
+}
+
+static gssize nu_protocol_stream_read_finish(GInputStream* stream,
+                                             GAsyncResult* result,
+                                             GError** error) {
+  return g_task_propagate_int(G_TASK(result), error);
 }
 
 static gboolean nu_protocol_stream_close(GInputStream* stream,
@@ -36,12 +70,69 @@ static gboolean nu_protocol_stream_close(GInputStream* stream,
   return true;
 }
 
+static goffset nu_protocol_stream_tell(GSeekable* seekable) {
+  return NU_PROTOCOL_STREAM(seekable)->priv->position;
+}
+
+static gboolean nu_protocol_stream_can_seek(GSeekable* seekable) {
+  return NU_PROTOCOL_STREAM(seekable)->priv->protocol_job->CanSeek();
+}
+
+static gboolean nu_protocol_stream_seek(GSeekable* seekable,
+                                        goffset offset,
+                                        GSeekType type,
+                                        GCancellable*,
+                                        GError** error) {
+  NUProtocolStreamPrivate* priv = NU_PROTOCOL_STREAM(seekable)->priv;
+  // The size of content is not known to the stream.
+  if (type == G_SEEK_END) {
+    g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                        "Seeking from the end is not supported");
+    return false;
+  }
+  goffset position = type == G_SEEK_CUR ? priv->position + offset : offset;
+  if (!g_input_stream_set_pending(G_INPUT_STREAM(seekable), error))
+    return false;
+  bool success = priv->protocol_job->Seek(position);
+  g_input_stream_clear_pending(G_INPUT_STREAM(seekable));
+  if (!success) {
+    g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT,
+                        "Unable to seek the protocol job");
+    return false;
+  }
+  priv->position = position;
+  return true;
+}
+
+static gboolean nu_protocol_stream_can_truncate(GSeekable* seekable) {
+  return false;
+}
+
+static gboolean nu_protocol_stream_truncate(GSeekable* seekable,
+                                            goffset offset,
+                                            GCancellable*,
+                                            GError** error) {
+  g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                      "Cannot truncate protocol stream");
+  return false;
+}
+
+static void nu_protocol_stream_seekable_iface_init(GSeekableIface* iface) {
+  iface->tell = nu_protocol_stream_tell;
+  iface->can_seek = nu_protocol_stream_can_seek;
+  iface->seek = nu_protocol_stream_seek;
+  iface->can_truncate = nu_protocol_stream_can_truncate;
+  iface->truncate_fn = nu_protocol_stream_truncate;
+}
+
 static void nu_protocol_stream_class_init(NUProtocolStreamClass* klass) {
   GObjectClass* gobject_class = G_OBJECT_CLASS(klass);
   gobject_class->finalize = nu_protocol_stream_finialize;
 
   GInputStreamClass* istream_class = G_INPUT_STREAM_CLASS(klass);
   istream_class->read_fn = nu_protocol_stream_read;
+  istream_class->read_async = nu_protocol_stream_read_async;
+  istream_class->read_finish = nu_protocol_stream_read_finish;
   istream_class->close_fn = nu_protocol_stream_close;
 }
 
@@ -0,0 +1,296 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gtk/nu_tree_view_model.h"
+
+#include <vector>
+
+namespace nu {
+
+namespace {
+
+// Iters are never invalidated, so the stamp never changes.
+const gint kStamp = 0x7eee;
+
+}  // namespace
+
+struct _NUTreeViewModelPrivate {
+  TreeModel* model;
+};
+
+static void nu_tree_view_model_tree_model_init(GtkTreeModelIface* iface);
+static GtkTreeModelFlags nu_tree_view_model_get_flags(
+    GtkTreeModel* tree_model);
+static gint nu_tree_view_model_get_n_columns(GtkTreeModel* tree_model);
+static GType nu_tree_view_model_get_column_type(GtkTreeModel* tree_model,
+                                                gint index);
+static gboolean nu_tree_view_model_get_iter(GtkTreeModel* tree_model,
+                                            GtkTreeIter* iter,
+                                            GtkTreePath* path);
+static GtkTreePath* nu_tree_view_model_get_path(GtkTreeModel* tree_model,
+                                                GtkTreeIter* iter);
+static void nu_tree_view_model_get_value(GtkTreeModel* tree_model,
+                                         GtkTreeIter* iter,
+                                         gint column,
+                                         GValue* value);
+static gboolean nu_tree_view_model_iter_next(GtkTreeModel* tree_model,
+                                             GtkTreeIter* iter);
+static gboolean nu_tree_view_model_iter_previous(GtkTreeModel* tree_model,
+                                                 GtkTreeIter* iter);
+static gboolean nu_tree_view_model_iter_children(GtkTreeModel* tree_model,
+                                                 GtkTreeIter* iter,
+                                                 GtkTreeIter* parent);
+static gboolean nu_tree_view_model_iter_has_child(GtkTreeModel* tree_model,
+                                                  GtkTreeIter* iter);
+static gint nu_tree_view_model_iter_n_children(GtkTreeModel* tree_model,
+                                               GtkTreeIter* iter);
+static gboolean nu_tree_view_model_iter_nth_child(GtkTreeModel* tree_model,
+                                                  GtkTreeIter* iter,
+                                                  GtkTreeIter* parent,
+                                                  gint n);
+static gboolean nu_tree_view_model_iter_parent(GtkTreeModel* tree_model,
+                                               GtkTreeIter* iter,
+                                               GtkTreeIter* child);
+
+G_DEFINE_TYPE_WITH_CODE(NUTreeViewModel, nu_tree_view_model, G_TYPE_OBJECT,
+                        G_ADD_PRIVATE(NUTreeViewModel)
+                        G_IMPLEMENT_INTERFACE(
+                            GTK_TYPE_TREE_MODEL,
+                            nu_tree_view_model_tree_model_init))
+
+static void nu_tree_view_model_class_init(NUTreeViewModelClass* cl) {
+}
+
+static void nu_tree_view_model_tree_model_init(GtkTreeModelIface* iface) {
+  iface->get_flags = nu_tree_view_model_get_flags;
+  iface->get_n_columns = nu_tree_view_model_get_n_columns;
+  iface->get_column_type = nu_tree_view_model_get_column_type;
+  iface->get_iter = nu_tree_view_model_get_iter;
+  iface->get_path = nu_tree_view_model_get_path;
+  iface->get_value = nu_tree_view_model_get_value;
+  iface->iter_next = nu_tree_view_model_iter_next;
+  iface->iter_previous = nu_tree_view_model_iter_previous;
+  iface->iter_children = nu_tree_view_model_iter_children;
+  iface->iter_has_child = nu_tree_view_model_iter_has_child;
+  iface->iter_n_children = nu_tree_view_model_iter_n_children;
+  iface->iter_nth_child = nu_tree_view_model_iter_nth_child;
+  iface->iter_parent = nu_tree_view_model_iter_parent;
+}
+
+static GtkTreeModelFlags nu_tree_view_model_get_flags(
+    GtkTreeModel* tree_model) {
+  return GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+static gint nu_tree_view_model_get_n_columns(GtkTreeModel* tree_model) {
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  return priv->model->GetColumnCount();
+}
+
+static GType nu_tree_view_model_get_column_type(GtkTreeModel* tree_model,
+                                                gint index) {
+  return G_TYPE_POINTER;
+}
+
+static gboolean nu_tree_view_model_get_iter(GtkTreeModel* tree_model,
+                                            GtkTreeIter* iter,
+                                            GtkTreePath* path) {
+  iter->stamp = 0;
+  int depth = gtk_tree_path_get_depth(path);
+  if (depth < 1)
+    return false;
+  gint* indices = gtk_tree_path_get_indices(path);
+  GtkTreeIter parent;
+  for (int i = 0; i < depth; ++i) {
+    if (!gtk_tree_model_iter_nth_child(tree_model, iter,
+                                       i == 0 ? nullptr : &parent,
+                                       indices[i]))
+      return false;
+    parent = *iter;
+  }
+  return true;
+}
+
+static GtkTreePath* nu_tree_view_model_get_path(GtkTreeModel* tree_model,
+                                                GtkTreeIter* iter) {
+  if (iter->stamp != kStamp)
+    return nullptr;
+  auto* model = NU_TREE_VIEW_MODEL(tree_model);
+  TreeModel::NodeId node = nu_tree_view_model_get_node(iter);
+  GtkTreePath* path = nu_tree_view_model_get_node_path(model, node);
+  if (nu_tree_view_model_is_placeholder(iter))
+    gtk_tree_path_append_index(path, 0);
+  return path;
+}
+
+static void nu_tree_view_model_get_value(GtkTreeModel* tree_model,
+                                         GtkTreeIter* iter,
+                                         gint column,
+                                         GValue* value) {
+  if (iter->stamp != kStamp)
+    return;
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  const base::Value* result = nullptr;
+  // Placeholders have no value.
+  if (!nu_tree_view_model_is_placeholder(iter))
+    result = priv->model->GetValue(nu_tree_view_model_get_node(iter), column);
+  g_value_init(value, G_TYPE_POINTER);
+  g_value_set_pointer(value, const_cast<base::Value*>(result));
+}
+
+static gboolean nu_tree_view_model_iter_next(GtkTreeModel* tree_model,
+                                             GtkTreeIter* iter) {
+  if (iter->stamp != kStamp || nu_tree_view_model_is_placeholder(iter)) {
+    iter->stamp = 0;
+    return false;
+  }
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  TreeModel::NodeId node = nu_tree_view_model_get_node(iter);
+  TreeModel::NodeId parent = priv->model->GetParent(node);
+  uint32_t index = priv->model->GetIndex(node) + 1;
+  if (index >= priv->model->GetChildCount(parent)) {
+    iter->stamp = 0;
+    return false;
+  }
+  nu_tree_view_model_init_iter(
+      iter, priv->model->GetChildAt(parent, index), false);
+  return true;
+}
+
+static gboolean nu_tree_view_model_iter_previous(GtkTreeModel* tree_model,
+                                                 GtkTreeIter* iter) {
+  if (iter->stamp != kStamp || nu_tree_view_model_is_placeholder(iter)) {
+    iter->stamp = 0;
+    return false;
+  }
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  TreeModel::NodeId node = nu_tree_view_model_get_node(iter);
+  uint32_t index = priv->model->GetIndex(node);
+  if (index == 0) {
+    iter->stamp = 0;
+    return false;
+  }
+  nu_tree_view_model_init_iter(
+      iter, priv->model->GetChildAt(priv->model->GetParent(node), index - 1),
+      false);
+  return true;
+}
+
+static gboolean nu_tree_view_model_iter_children(GtkTreeModel* tree_model,
+                                                 GtkTreeIter* iter,
+                                                 GtkTreeIter* parent) {
+  return gtk_tree_model_iter_nth_child(tree_model, iter, parent, 0);
+}
+
+static gboolean nu_tree_view_model_iter_has_child(GtkTreeModel* tree_model,
+                                                  GtkTreeIter* iter) {
+  return gtk_tree_model_iter_n_children(tree_model, iter) > 0;
+}
+
+static gint nu_tree_view_model_iter_n_children(GtkTreeModel* tree_model,
+                                               GtkTreeIter* iter) {
+  if (!iter)
+    return nu_tree_view_model_get_n_rows(NU_TREE_VIEW_MODEL(tree_model),
+                                         TreeModel::kRootNode);
+  if (iter->stamp != kStamp || nu_tree_view_model_is_placeholder(iter))
+    return 0;
+  return nu_tree_view_model_get_n_rows(NU_TREE_VIEW_MODEL(tree_model),
+                                       nu_tree_view_model_get_node(iter));
+}
+
+static gboolean nu_tree_view_model_iter_nth_child(GtkTreeModel* tree_model,
+                                                  GtkTreeIter* iter,
+                                                  GtkTreeIter* parent,
+                                                  gint n) {
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  TreeModel::NodeId node = TreeModel::kRootNode;
+  if (parent) {
+    if (parent->stamp != kStamp || nu_tree_view_model_is_placeholder(parent)) {
+      iter->stamp = 0;
+      return false;
+    }
+    node = nu_tree_view_model_get_node(parent);
+  }
+  if (n < 0 || n >= nu_tree_view_model_get_n_rows(
+                        NU_TREE_VIEW_MODEL(tree_model), node)) {
+    iter->stamp = 0;
+    return false;
+  }
+  if (priv->model->IsLoaded(node))
+    nu_tree_view_model_init_iter(iter, priv->model->GetChildAt(node, n),
+                                 false);
+  else
+    nu_tree_view_model_init_iter(iter, node, true);
+  return true;
+}
+
+static gboolean nu_tree_view_model_iter_parent(GtkTreeModel* tree_model,
+                                               GtkTreeIter* iter,
+                                               GtkTreeIter* child) {
+  if (child->stamp != kStamp) {
+    iter->stamp = 0;
+    return false;
+  }
+  NUTreeViewModelPrivate* priv = NU_TREE_VIEW_MODEL(tree_model)->priv;
+  TreeModel::NodeId node = nu_tree_view_model_get_node(child);
+  if (!nu_tree_view_model_is_placeholder(child))
+    node = priv->model->GetParent(node);
+  if (node == TreeModel::kRootNode) {
+    iter->stamp = 0;
+    return false;
+  }
+  nu_tree_view_model_init_iter(iter, node, false);
+  return true;
+}
+
+static void nu_tree_view_model_init(NUTreeViewModel* tree_model) {
+  tree_model->priv = static_cast<NUTreeViewModelPrivate*>(
+      nu_tree_view_model_get_instance_private(tree_model));
+}
+
+NUTreeViewModel* nu_tree_view_model_new(TreeModel* model) {
+  void* obj = g_object_new(NU_TYPE_TREE_VIEW_MODEL, nullptr);
+  NU_TREE_VIEW_MODEL(obj)->priv->model = model;
+  return NU_TREE_VIEW_MODEL(obj);
+}
+
+void nu_tree_view_model_init_iter(GtkTreeIter* iter,
+                                  TreeModel::NodeId node,
+                                  bool placeholder) {
+  iter->stamp = kStamp;
+  iter->user_data = GUINT_TO_POINTER(node);
+  iter->user_data2 = GINT_TO_POINTER(placeholder);
+}
+
+TreeModel::NodeId nu_tree_view_model_get_node(GtkTreeIter* iter) {
+  return GPOINTER_TO_UINT(iter->user_data);
+}
+
+bool nu_tree_view_model_is_placeholder(GtkTreeIter* iter) {
+  return GPOINTER_TO_INT(iter->user_data2);
+}
+
+GtkTreePath* nu_tree_view_model_get_node_path(NUTreeViewModel* tree_model,
+                                              TreeModel::NodeId node) {
+  TreeModel* model = tree_model->priv->model;
+  std::vector<gint> indices;
+  for (; node != TreeModel::kRootNode; node = model->GetParent(node))
+    indices.push_back(model->GetIndex(node));
+  GtkTreePath* path = gtk_tree_path_new();
+  for (auto it = indices.rbegin(); it != indices.rend(); ++it)
+    gtk_tree_path_append_index(path, *it);
+  return path;
+}
+
+int nu_tree_view_model_get_n_rows(NUTreeViewModel* tree_model,
+                                  TreeModel::NodeId node) {
+  TreeModel* model = tree_model->priv->model;
+  // The root node is never shown, so it does not need placeholder.
+  if (node != TreeModel::kRootNode && model->IsExpandable(node) &&
+      !model->IsLoaded(node))
+    return 1;
+  return model->GetChildCount(node);
+}
+
+}  // namespace nu
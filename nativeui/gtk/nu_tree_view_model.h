@@ -0,0 +1,59 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GTK_NU_TREE_VIEW_MODEL_H_
+#define NATIVEUI_GTK_NU_TREE_VIEW_MODEL_H_
+
+#include <gtk/gtk.h>
+
+#include "nativeui/tree_model.h"
+
+// Custom tree model type for TreeModel.
+//
+// The iters store the ids of nodes, which stay valid until the nodes are
+// removed. Nodes whose children are not loaded yet get a placeholder child,
+// so they can be expanded.
+
+namespace nu {
+
+#define NU_TYPE_TREE_VIEW_MODEL (nu_tree_view_model_get_type())
+#define NU_TREE_VIEW_MODEL(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), \
+                                 NU_TYPE_TREE_VIEW_MODEL, NUTreeViewModel))
+#define NU_IS_TREE_VIEW_MODEL(obj) (G_TYPE_CHECK_INSTANCE_TYPE((obj), \
+                                    NU_TYPE_TREE_VIEW_MODEL))
+
+typedef struct _NUTreeViewModel        NUTreeViewModel;
+typedef struct _NUTreeViewModelPrivate NUTreeViewModelPrivate;
+typedef struct _NUTreeViewModelClass   NUTreeViewModelClass;
+
+struct _NUTreeViewModel {
+  GObject parent;
+  NUTreeViewModelPrivate* priv;
+};
+
+struct _NUTreeViewModelClass {
+  GObjectClass parent_class;
+};
+
+GType nu_tree_view_model_get_type();
+NUTreeViewModel* nu_tree_view_model_new(TreeModel* model);
+
+// Fill |iter| for |node|, or for the placeholder under |node|.
+void nu_tree_view_model_init_iter(GtkTreeIter* iter,
+                                  TreeModel::NodeId node,
+                                  bool placeholder);
+TreeModel::NodeId nu_tree_view_model_get_node(GtkTreeIter* iter);
+bool nu_tree_view_model_is_placeholder(GtkTreeIter* iter);
+
+// Return the path of |node|, the root node has an empty path.
+GtkTreePath* nu_tree_view_model_get_node_path(NUTreeViewModel* tree_model,
+                                              TreeModel::NodeId node);
+
+// Return how many rows are shown under |node|, including placeholder.
+int nu_tree_view_model_get_n_rows(NUTreeViewModel* tree_model,
+                                  TreeModel::NodeId node);
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GTK_NU_TREE_VIEW_MODEL_H_
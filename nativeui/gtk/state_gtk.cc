@@ -4,9 +4,42 @@
 
 #include "nativeui/state.h"
 
+#include <gtk/gtk.h>
+
+#include "nativeui/gfx/text_layout_cache.h"
+
 namespace nu {
 
+namespace {
+
+// Cached text layouts are no longer valid when fonts or resolution change.
+void OnFontSettingsChanged(GObject* object, GParamSpec* pspec,
+                           gpointer data) {
+  State* state = State::GetCurrent();
+  if (state)
+    state->GetTextLayoutCache()->Clear();
+}
+
+}  // namespace
+
 void State::PlatformInit() {
+  // The settings objects live until exit, so only connect once.
+  static bool signals_connected = false;
+  if (signals_connected)
+    return;
+  GtkSettings* settings = gtk_settings_get_default();
+  GdkScreen* screen = gdk_screen_get_default();
+  if (!settings || !screen)
+    return;
+  signals_connected = true;
+  g_signal_connect(settings, "notify::gtk-font-name",
+                   G_CALLBACK(OnFontSettingsChanged), nullptr);
+  g_signal_connect(settings, "notify::gtk-xft-dpi",
+                   G_CALLBACK(OnFontSettingsChanged), nullptr);
+  g_signal_connect(screen, "notify::resolution",
+                   G_CALLBACK(OnFontSettingsChanged), nullptr);
+  g_signal_connect(screen, "notify::font-options",
+                   G_CALLBACK(OnFontSettingsChanged), nullptr);
 }
 
 }  // namespace nu
@@ -4,6 +4,9 @@
 
 #include "nativeui/table.h"
 
+#include <algorithm>
+
+#include "base/strings/string_number_conversions.h"
 #include "base/values.h"
 #include "nativeui/gtk/nu_custom_cell_renderer.h"
 #include "nativeui/gtk/nu_tree_model.h"
@@ -14,6 +17,12 @@ namespace nu {
 
 namespace {
 
+// Batches smaller than this are always notified row by row.
+const uint32_t kMinRowsForReattach = 64;
+
+// Batches larger than this are always notified by reattaching model.
+const uint32_t kMaxRowsForSignals = 4096;
+
 // Calculate the default row height of cell.
 int GetDefaultRowHeight() {
   // Cache calls.
@@ -70,18 +79,132 @@ void TreeCellData(GtkTreeViewColumn* tree_column,
   switch (options->type) {
     case Table::ColumnType::Text:
     case Table::ColumnType::Edit: {
-      if (value && value->is_string())
+      if (value && value->is_string()) {
         g_object_set(renderer, "text", value->GetString().c_str(), nullptr);
+      } else if (value && value->is_int()) {
+        // Typed models like ColumnarTableModel return numbers.
+        g_object_set(renderer, "text",
+                     base::IntToString(value->GetInt()).c_str(), nullptr);
+      } else if (value && value->is_double()) {
+        g_object_set(renderer, "text",
+                     base::NumberToString(value->GetDouble()).c_str(),
+                     nullptr);
+      } else if (value && value->is_bool()) {
+        g_object_set(renderer, "text", value->GetBool() ? "true" : "false",
+                     nullptr);
+      }
       break;
     }
 
     case nu::Table::ColumnType::Custom: {
-      g_object_set(renderer, "value", value, nullptr);
+      nu_custom_cell_renderer_set_cell(
+          renderer, GPOINTER_TO_INT(iter->user_data), value);
       break;
     }
   }
 }
 
+// Drop cached drawings of custom cells in |column| from |start| to |end|,
+// -1 |column| means all columns.
+void InvalidateCustomCells(GtkTreeView* tree_view,
+                           int column,
+                           int start = 0,
+                           int end = G_MAXINT) {
+  GList* columns = gtk_tree_view_get_columns(tree_view);
+  for (GList* i = columns; i; i = i->next) {
+    GList* renderers =
+        gtk_cell_layout_get_cells(GTK_CELL_LAYOUT(i->data));
+    for (GList* j = renderers; j; j = j->next) {
+      auto* renderer = GTK_CELL_RENDERER(j->data);
+      if (!NU_IS_CUSTOM_CELL_RENDERER(renderer))
+        continue;
+      if (column != -1 && column != GPOINTER_TO_INT(
+              g_object_get_data(G_OBJECT(renderer), "column")))
+        continue;
+      nu_custom_cell_renderer_invalidate(renderer, start, end);
+    }
+    g_list_free(renderers);
+  }
+  g_list_free(columns);
+}
+
+// Detach and reattach the model so GtkTreeView rebuilds its rows in one pass,
+// which is much faster than emitting a signal for each row.
+//
+// The |selected_row| is selected and |top_row| is scrolled to after the
+// model has been attached, pass -1 to skip.
+void ReattachModel(GtkTreeView* tree_view, int selected_row, int top_row) {
+  GtkTreeModel* tree_model = gtk_tree_view_get_model(tree_view);
+  g_object_ref(tree_model);
+  gtk_tree_view_set_model(tree_view, nullptr);
+  gtk_tree_view_set_model(tree_view, tree_model);
+  g_object_unref(tree_model);
+
+  int rows = gtk_tree_model_iter_n_children(tree_model, nullptr);
+  if (selected_row >= 0 && selected_row < rows) {
+    GtkTreeSelection* selection = gtk_tree_view_get_selection(tree_view);
+    GtkTreeIter iter = {true, GINT_TO_POINTER(selected_row)};
+    gtk_tree_selection_select_iter(selection, &iter);
+  }
+  if (top_row >= 0 && rows > 0) {
+    // The scroll is delayed until the view has been allocated.
+    GtkTreePath* tree_path =
+        gtk_tree_path_new_from_indices(std::min(top_row, rows - 1), -1);
+    gtk_tree_view_scroll_to_cell(tree_view, tree_path, nullptr, true, 0, 0);
+    gtk_tree_path_free(tree_path);
+  }
+}
+
+// Return the first visible row, or -1 if nothing is visible.
+int GetTopRow(GtkTreeView* tree_view) {
+  GtkTreePath* start_path;
+  if (!gtk_tree_view_get_visible_range(tree_view, &start_path, nullptr))
+    return -1;
+  int row = gtk_tree_path_get_indices(start_path)[0];
+  gtk_tree_path_free(start_path);
+  return row;
+}
+
+// Return the selected row by reading the view, the model may have already
+// been changed when this is called.
+int GetSelectedViewRow(GtkTreeView* tree_view) {
+  GtkTreeSelection* selection = gtk_tree_view_get_selection(tree_view);
+  GList* paths = gtk_tree_selection_get_selected_rows(selection, nullptr);
+  if (!paths)
+    return -1;
+  int row = gtk_tree_path_get_indices(static_cast<GtkTreePath*>(
+      paths->data))[0];
+  g_list_free_full(paths, reinterpret_cast<GDestroyNotify>(gtk_tree_path_free));
+  return row;
+}
+
+// Return the last visible row, or -1 if nothing is visible.
+int GetBottomRow(GtkTreeView* tree_view) {
+  GtkTreePath* end_path;
+  if (!gtk_tree_view_get_visible_range(tree_view, nullptr, &end_path))
+    return -1;
+  int row = gtk_tree_path_get_indices(end_path)[0];
+  gtk_tree_path_free(end_path);
+  return row;
+}
+
+// Whether a batch of |count| rows starting at |start| should be notified by
+// reattaching model.
+bool ShouldReattach(GtkTreeView* tree_view, uint32_t start, uint32_t count) {
+  if (count < kMinRowsForReattach)
+    return false;
+  // Each signal costs far more than rebuilding a row, so large batches are
+  // always rebuilt, no matter where they are.
+  GtkTreeModel* tree_model = gtk_tree_view_get_model(tree_view);
+  uint32_t rows = gtk_tree_model_iter_n_children(tree_model, nullptr);
+  if (count >= kMaxRowsForSignals || count >= rows / 8)
+    return true;
+  // Rows below the visible area do not move anything on screen, so a small
+  // batch there is cheaper to notify row by row than rebuilding all rows.
+  int bottom = GetBottomRow(tree_view);
+  return bottom < 0 || start <= static_cast<uint32_t>(bottom);
+}
+
 }  // namespace
 
 NativeView Table::PlatformCreate() {
@@ -106,6 +229,8 @@ void Table::PlatformDestroy() {
 void Table::PlatformSetModel(TableModel* model) {
   auto* tree_view = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(GetNative()),
                                                     "tree-view"));
+  // The cached drawings are keyed by rows of previous model.
+  InvalidateCustomCells(tree_view, -1);
   NUTreeModel* tree_model = nu_tree_model_new(this, model);
   gtk_tree_view_set_model(tree_view, GTK_TREE_MODEL(tree_model));
 }
@@ -214,6 +339,7 @@ void Table::NotifyRowInsertion(uint32_t row) {
   auto* tree_model = gtk_tree_view_get_model(tree_view);
   if (!tree_model)
     return;
+  InvalidateCustomCells(tree_view, -1, row);
   GtkTreeIter iter = {true, GINT_TO_POINTER(row)};
   GtkTreePath* tree_path = gtk_tree_path_new_from_indices(row, -1);
   gtk_tree_model_row_inserted(tree_model, tree_path, &iter);
@@ -226,6 +352,7 @@ void Table::NotifyRowDeletion(uint32_t row) {
   auto* tree_model = gtk_tree_view_get_model(tree_view);
   if (!tree_model)
     return;
+  InvalidateCustomCells(tree_view, -1, row);
   GtkTreePath* tree_path = gtk_tree_path_new_from_indices(row, -1);
   gtk_tree_model_row_deleted(tree_model, tree_path);
   gtk_tree_path_free(tree_path);
@@ -237,10 +364,104 @@ void Table::NotifyValueChange(uint32_t column, uint32_t row) {
   auto* tree_model = gtk_tree_view_get_model(tree_view);
   if (!tree_model)
     return;
+  InvalidateCustomCells(tree_view, column, row, row + 1);
   GtkTreeIter iter = {true, GINT_TO_POINTER(row)};
   GtkTreePath* tree_path = gtk_tree_path_new_from_indices(row, -1);
   gtk_tree_model_row_changed(tree_model, tree_path, &iter);
   gtk_tree_path_free(tree_path);
 }
 
+void Table::NotifyRowsInserted(uint32_t start, uint32_t count) {
+  auto* tree_view = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(GetNative()),
+                                                    "tree-view"));
+  auto* tree_model = gtk_tree_view_get_model(tree_view);
+  if (!tree_model)
+    return;
+  InvalidateCustomCells(tree_view, -1, start);
+  if (ShouldReattach(tree_view, start, count)) {
+    // Keep the selection and scroll position on the same rows.
+    int selected = GetSelectedViewRow(tree_view);
+    if (selected >= static_cast<int>(start))
+      selected += count;
+    int top = GetTopRow(tree_view);
+    // Stay at the top when the view is not scrolled.
+    if (top >= static_cast<int>(start) && top > 0)
+      top += count;
+    ReattachModel(tree_view, selected, top);
+    return;
+  }
+  GtkTreePath* tree_path = gtk_tree_path_new_from_indices(start, -1);
+  for (uint32_t row = start; row < start + count; ++row) {
+    GtkTreeIter iter = {true, GINT_TO_POINTER(row)};
+    gtk_tree_model_row_inserted(tree_model, tree_path, &iter);
+    gtk_tree_path_next(tree_path);
+  }
+  gtk_tree_path_free(tree_path);
+}
+
+void Table::NotifyRowsDeleted(uint32_t start, uint32_t count) {
+  auto* tree_view = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(GetNative()),
+                                                    "tree-view"));
+  auto* tree_model = gtk_tree_view_get_model(tree_view);
+  if (!tree_model)
+    return;
+  InvalidateCustomCells(tree_view, -1, start);
+  if (ShouldReattach(tree_view, start, count)) {
+    int selected = GetSelectedViewRow(tree_view);
+    if (selected >= static_cast<int>(start + count))
+      selected -= count;
+    else if (selected >= static_cast<int>(start))
+      selected = -1;
+    int top = GetTopRow(tree_view);
+    if (top >= static_cast<int>(start + count))
+      top -= count;
+    else if (top >= static_cast<int>(start))
+      top = start;
+    ReattachModel(tree_view, selected, top);
+    return;
+  }
+  // Remove from the end so the paths of remaining rows do not change.
+  for (uint32_t row = start + count; row > start; --row) {
+    GtkTreePath* tree_path = gtk_tree_path_new_from_indices(row - 1, -1);
+    gtk_tree_model_row_deleted(tree_model, tree_path);
+    gtk_tree_path_free(tree_path);
+  }
+}
+
+void Table::NotifyRowsChanged(uint32_t start, uint32_t count) {
+  auto* tree_view = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(GetNative()),
+                                                    "tree-view"));
+  auto* tree_model = gtk_tree_view_get_model(tree_view);
+  if (!tree_model)
+    return;
+  InvalidateCustomCells(tree_view, -1, start, start + count);
+  // Values are read when drawing, so only visible rows need to be updated.
+  GtkTreePath* start_path;
+  GtkTreePath* end_path;
+  if (!gtk_tree_view_get_visible_range(tree_view, &start_path, &end_path))
+    return;
+  uint32_t first = std::max(start,
+      static_cast<uint32_t>(gtk_tree_path_get_indices(start_path)[0]));
+  uint32_t last = std::min(start + count - 1,
+      static_cast<uint32_t>(gtk_tree_path_get_indices(end_path)[0]));
+  gtk_tree_path_free(start_path);
+  gtk_tree_path_free(end_path);
+  for (uint32_t row = first; row <= last; ++row) {
+    GtkTreeIter iter = {true, GINT_TO_POINTER(row)};
+    GtkTreePath* tree_path = gtk_tree_path_new_from_indices(row, -1);
+    gtk_tree_model_row_changed(tree_model, tree_path, &iter);
+    gtk_tree_path_free(tree_path);
+  }
+}
+
+void Table::NotifyReset() {
+  auto* tree_view = GTK_TREE_VIEW(g_object_get_data(G_OBJECT(GetNative()),
+                                                    "tree-view"));
+  if (!gtk_tree_view_get_model(tree_view))
+    return;
+  InvalidateCustomCells(tree_view, -1);
+  // The rows are different after reset, so only keep the scroll position.
+  ReattachModel(tree_view, -1, GetTopRow(tree_view));
+}
+
 }  // namespace nu
@@ -0,0 +1,164 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/gtk/text_buffer_loader.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
+#include "nativeui/gtk/undoable_text_buffer.h"
+
+namespace nu {
+
+namespace {
+
+// Bytes inserted by one gtk_text_buffer_insert call.
+const size_t kPieceSize = 64 * 1024;
+
+// How long to keep inserting in one idle callback, in microseconds.
+const gint64 kTimeSlice = 8 * 1000;
+
+// U+FFFD, replaces invalid bytes.
+const char kReplacementChar[] = "\xEF\xBF\xBD";
+
+}  // namespace
+
+TextBufferLoader::Source::Source() = default;
+
+TextBufferLoader::Source::Source(Source&&) = default;
+
+TextBufferLoader::Source::~Source() = default;
+
+const char* TextBufferLoader::Source::data() const {
+  return file ? reinterpret_cast<const char*>(file->data()) : str.data();
+}
+
+TextBufferLoader::TextBufferLoader(GtkTextBuffer* buffer,
+                                   const ProgressCallback& callback)
+    : buffer_(buffer), callback_(callback) {}
+
+TextBufferLoader::~TextBufferLoader() {
+  Stop();
+}
+
+bool TextBufferLoader::AddFile(const base::FilePath& path) {
+  int64_t size = 0;
+  if (!base::GetFileSize(path, &size))
+    return false;
+  if (size == 0) {
+    // Nothing to map, but still report progress to the caller.
+    Start();
+    return true;
+  }
+  Source source;
+  source.file.reset(new base::MemoryMappedFile);
+  if (!source.file->Initialize(path))
+    return false;
+  source.size = source.file->length();
+  // The file is read once from start to end.
+  madvise(const_cast<uint8_t*>(source.file->data()), source.size,
+          MADV_SEQUENTIAL);
+  total_ += source.size;
+  sources_.push_back(std::move(source));
+  Start();
+  return true;
+}
+
+void TextBufferLoader::AddChunks(std::vector<std::string> chunks) {
+  for (std::string& chunk : chunks) {
+    if (chunk.empty())
+      continue;
+    sources_.emplace_back();
+    Source& source = sources_.back();
+    source.str = std::move(chunk);
+    source.size = source.str.size();
+    total_ += source.size;
+  }
+  Start();
+}
+
+void TextBufferLoader::Cancel() {
+  Stop();
+}
+
+// static
+gboolean TextBufferLoader::OnIdle(gpointer self) {
+  auto* loader = static_cast<TextBufferLoader*>(self);
+  if (loader->LoadSome()) {
+    loader->callback_(static_cast<float>(loader->loaded_) / loader->total_);
+    return G_SOURCE_CONTINUE;
+  }
+  ProgressCallback callback = loader->callback_;
+  loader->Finish();
+  // The callback may delete the loader.
+  callback(1.f);
+  return G_SOURCE_REMOVE;
+}
+
+void TextBufferLoader::Start() {
+  if (source_id_ != 0)
+    return;
+  // Run after input and redraw, so the view stays interactive.
+  source_id_ = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, &OnIdle, this,
+                               nullptr);
+}
+
+void TextBufferLoader::Stop() {
+  if (source_id_ == 0)
+    return;
+  g_source_remove(source_id_);
+  Finish();
+}
+
+void TextBufferLoader::Finish() {
+  source_id_ = 0;
+  sources_.clear();
+  total_ = 0;
+  loaded_ = 0;
+}
+
+bool TextBufferLoader::LoadSome() {
+  gint64 deadline = g_get_monotonic_time() + kTimeSlice;
+  while (!sources_.empty()) {
+    Source& source = sources_.front();
+    const char* data = source.data();
+    size_t end = std::min(source.pos + kPieceSize, source.size);
+    if (end < source.size) {
+      // Do not split a character, or a CRLF line terminator.
+      while (end > source.pos + 1 &&
+             (static_cast<unsigned char>(data[end]) & 0xC0) == 0x80)
+        --end;
+      if (end > source.pos + 1 &&
+          data[end - 1] == '\r' && data[end] == '\n')
+        --end;
+    }
+
+    const char* start = data + source.pos;
+    const char* valid_end = nullptr;
+    g_utf8_validate(start, end - source.pos, &valid_end);
+    // Only the loaded text is not recorded, so user can still edit and undo
+    // while loading.
+    if (valid_end > start)
+      TextBufferAppendNotUndoable(buffer_, start, valid_end - start);
+    size_t consumed = valid_end - start;
+    if (valid_end < data + end) {
+      TextBufferAppendNotUndoable(buffer_, kReplacementChar, -1);
+      ++consumed;
+    }
+    source.pos += consumed;
+    loaded_ += consumed;
+
+    if (source.pos >= source.size)
+      sources_.pop_front();
+    if (g_get_monotonic_time() >= deadline)
+      break;
+  }
+  return !sources_.empty();
+}
+
+}  // namespace nu
@@ -0,0 +1,87 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_GTK_TEXT_BUFFER_LOADER_H_
+#define NATIVEUI_GTK_TEXT_BUFFER_LOADER_H_
+
+#include <gtk/gtk.h>
+#include <stdint.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace base {
+class FilePath;
+class MemoryMappedFile;
+}
+
+namespace nu {
+
+// Appends text to the end of a GtkTextBuffer in small pieces at idle time, so
+// large documents can be loaded without blocking the UI. The inserted text is
+// not recorded in the undo history.
+class TextBufferLoader {
+ public:
+  // Called with the fraction of bytes loaded, 1 means done.
+  using ProgressCallback = std::function<void(float)>;
+
+  TextBufferLoader(GtkTextBuffer* buffer, const ProgressCallback& callback);
+  ~TextBufferLoader();
+
+  // Queue the content of |path|, the file is mapped into memory instead of
+  // being read.
+  bool AddFile(const base::FilePath& path);
+
+  // Queue the |chunks|, each chunk must be valid UTF-8 on its own.
+  void AddChunks(std::vector<std::string> chunks);
+
+  // Stop loading and drop the remaining content.
+  void Cancel();
+
+  bool IsLoading() const { return source_id_ != 0; }
+
+ private:
+  // A piece of content waiting to be inserted.
+  struct Source {
+    Source();
+    Source(Source&&);
+    ~Source();
+
+    const char* data() const;
+
+    std::unique_ptr<base::MemoryMappedFile> file;
+    std::string str;
+    size_t size = 0;
+    size_t pos = 0;
+  };
+
+  static gboolean OnIdle(gpointer self);
+
+  void Start();
+  void Stop();
+  void Finish();
+
+  // Insert content for a short while, return false when everything is
+  // loaded.
+  bool LoadSome();
+
+  GtkTextBuffer* buffer_;
+  ProgressCallback callback_;
+
+  std::deque<Source> sources_;
+  uint64_t total_ = 0;
+  uint64_t loaded_ = 0;
+  guint source_id_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TextBufferLoader);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_GTK_TEXT_BUFFER_LOADER_H_
@@ -7,7 +7,18 @@
 #include <gdk/gdkkeysyms.h>
 #include <gtk/gtk.h>
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/strings/stringprintf.h"
 #include "nativeui/gfx/font.h"
+#include "nativeui/gtk/text_buffer_loader.h"
 #include "nativeui/gtk/undoable_text_buffer.h"
 #include "nativeui/gtk/widget_util.h"
 
@@ -24,10 +35,191 @@ GtkPolicyType PolicyToGTK(Scroll::Policy policy) {
     return GTK_POLICY_AUTOMATIC;
 }
 
-void OnTextChange(GtkTextBuffer*, TextEdit* edit) {
+// Private data attached to the text buffer.
+struct TextEditData {
+  // The deletion being made, only known before deletion.
+  TextEdit::TextChange pending_delete;
+  int revision = 0;
+  // Tags shared by ranges with same style.
+  std::unordered_map<std::string, GtkTextTag*> style_tags;
+};
+
+// A range of text with a style tag applied.
+struct StyleSpan {
+  int start;
+  int end;
+  GtkTextTag* tag;
+
+  bool operator<(const StyleSpan& other) const {
+    return std::tie(start, end, tag) <
+           std::tie(other.start, other.end, other.tag);
+  }
+  bool operator==(const StyleSpan& other) const {
+    return start == other.start && end == other.end && tag == other.tag;
+  }
+};
+
+TextEditData* GetData(GtkTextBuffer* buffer) {
+  return static_cast<TextEditData*>(
+      g_object_get_data(G_OBJECT(buffer), "text-edit-data"));
+}
+
+void OnTextChange(GtkTextBuffer* buffer, TextEdit* edit) {
+  GetData(buffer)->revision++;
   edit->on_text_change.Emit(edit);
 }
 
+void OnInsertTextAfter(GtkTextBuffer*,
+                       GtkTextIter* iter,
+                       gchar* text, gint length,
+                       TextEdit* edit) {
+  if (edit->on_text_edit.IsEmpty())
+    return;
+  // The iter has been moved to the end of inserted text.
+  TextEdit::TextChange change;
+  change.offset = gtk_text_iter_get_offset(iter) -
+                  g_utf8_strlen(text, length);
+  change.inserted_text.assign(text, length);
+  edit->on_text_edit.Emit(edit, change);
+}
+
+void OnDeleteRange(GtkTextBuffer* buffer,
+                   GtkTextIter* start_iter,
+                   GtkTextIter* end_iter,
+                   TextEdit* edit) {
+  // The deleted length can only be computed before deletion.
+  TextEdit::TextChange* change = &GetData(buffer)->pending_delete;
+  change->offset = gtk_text_iter_get_offset(start_iter);
+  change->deleted_length = gtk_text_iter_get_offset(end_iter) - change->offset;
+}
+
+void OnDeleteRangeAfter(GtkTextBuffer* buffer,
+                        GtkTextIter*,
+                        GtkTextIter*,
+                        TextEdit* edit) {
+  TextEdit::TextChange* change = &GetData(buffer)->pending_delete;
+  if (change->deleted_length > 0)
+    edit->on_text_edit.Emit(edit, *change);
+}
+
+GtkTextBuffer* GetBuffer(const TextEdit* edit) {
+  return gtk_text_view_get_buffer(
+      GTK_TEXT_VIEW(g_object_get_data(G_OBJECT(edit->GetNative()),
+                                      "text-view")));
+}
+
+TextBufferLoader* GetLoader(const TextEdit* edit) {
+  return static_cast<TextBufferLoader*>(
+      g_object_get_data(G_OBJECT(GetBuffer(edit)), "text-loader"));
+}
+
+// Return a tag shared by all ranges with the same style as |range|.
+GtkTextTag* GetStyleTag(GtkTextBuffer* buffer,
+                        const TextEdit::StyledRange& range) {
+  std::string key;
+  if (range.font) {
+    key = base::StringPrintf("%s:%f:%d:%d", range.font->GetName().c_str(),
+                             range.font->GetSize(),
+                             static_cast<int>(range.font->GetWeight()),
+                             static_cast<int>(range.font->GetStyle()));
+  }
+  if (range.color)
+    key += base::StringPrintf("|%08X", range.color->value());
+  else
+    key += "|";
+  if (range.background)
+    key += base::StringPrintf("|%08X", range.background->value());
+  else
+    key += "|";
+
+  TextEditData* data = GetData(buffer);
+  auto it = data->style_tags.find(key);
+  if (it != data->style_tags.end())
+    return it->second;
+
+  GtkTextTag* tag = gtk_text_buffer_create_tag(buffer, nullptr, nullptr);
+  if (range.font)
+    g_object_set(tag, "font-desc", range.font->GetNative(), nullptr);
+  if (range.color) {
+    GdkRGBA rgba = range.color->ToGdkRGBA();
+    g_object_set(tag, "foreground-rgba", &rgba, nullptr);
+  }
+  if (range.background) {
+    GdkRGBA rgba = range.background->ToGdkRGBA();
+    g_object_set(tag, "background-rgba", &rgba, nullptr);
+  }
+  g_object_set_data(G_OBJECT(tag), "style-tag", tag);
+  data->style_tags[key] = tag;
+  return tag;
+}
+
+// Add spans of style tags toggled on at |iter| to |spans|, clipped to
+// [start, end).
+void AddStyleSpans(GtkTextIter* iter, GSList* tags, int start, int end,
+                   std::vector<StyleSpan>* spans) {
+  for (GSList* i = tags; i; i = i->next) {
+    GtkTextTag* tag = GTK_TEXT_TAG(i->data);
+    if (!g_object_get_data(G_OBJECT(tag), "style-tag"))
+      continue;
+    GtkTextIter tag_end = *iter;
+    gtk_text_iter_forward_to_tag_toggle(&tag_end, tag);
+    spans->push_back({std::max(start, gtk_text_iter_get_offset(iter)),
+                      std::min(end, gtk_text_iter_get_offset(&tag_end)),
+                      tag});
+  }
+  g_slist_free(tags);
+}
+
+// Read the style tags currently applied in [start, end).
+std::vector<StyleSpan> GetStyleSpans(GtkTextBuffer* buffer,
+                                     int start, int end) {
+  std::vector<StyleSpan> spans;
+  GtkTextIter iter, end_iter;
+  gtk_text_buffer_get_iter_at_offset(buffer, &iter, start);
+  gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, end);
+  AddStyleSpans(&iter, gtk_text_iter_get_tags(&iter), start, end, &spans);
+  while (gtk_text_iter_forward_to_tag_toggle(&iter, nullptr) &&
+         gtk_text_iter_compare(&iter, &end_iter) < 0) {
+    AddStyleSpans(&iter, gtk_text_iter_get_toggled_tags(&iter, TRUE),
+                  start, end, &spans);
+  }
+  std::sort(spans.begin(), spans.end());
+  return spans;
+}
+
+// Convert |ranges| to spans clipped to [start, end), with spans of same tag
+// merged, which is how they would be read back from the buffer.
+std::vector<StyleSpan> GetSpansFromRanges(
+    GtkTextBuffer* buffer, int start, int end,
+    const std::vector<TextEdit::StyledRange>& ranges) {
+  std::vector<StyleSpan> spans;
+  spans.reserve(ranges.size());
+  for (const TextEdit::StyledRange& range : ranges) {
+    int range_start = std::max(start, range.start);
+    int range_end = range.end < 0 ? end : std::min(end, range.end);
+    if (range_start >= range_end)
+      continue;
+    if (!range.font && !range.color && !range.background)
+      continue;
+    spans.push_back({range_start, range_end, GetStyleTag(buffer, range)});
+  }
+  std::sort(spans.begin(), spans.end(),
+            [](const StyleSpan& a, const StyleSpan& b) {
+    return std::tie(a.tag, a.start) < std::tie(b.tag, b.start);
+  });
+  std::vector<StyleSpan> merged;
+  merged.reserve(spans.size());
+  for (const StyleSpan& span : spans) {
+    if (!merged.empty() && merged.back().tag == span.tag &&
+        merged.back().end >= span.start)
+      merged.back().end = std::max(merged.back().end, span.end);
+    else
+      merged.push_back(span);
+  }
+  std::sort(merged.begin(), merged.end());
+  return merged;
+}
+
 gboolean OnKeyPress(GtkWidget*, GdkEventKey* event, TextEdit* edit) {
   if (event->type == GDK_KEY_PRESS && event->keyval == GDK_KEY_Return &&
       edit->should_insert_new_line)
@@ -51,12 +243,25 @@ TextEdit::TextEdit() {
   GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(text_view));
   TextBufferMakeUndoable(buffer);
   g_signal_connect(buffer, "changed", G_CALLBACK(OnTextChange), this);
+  g_object_set_data_full(G_OBJECT(buffer), "text-edit-data", new TextEditData,
+                         Delete<TextEditData>);
+  g_signal_connect_after(buffer, "insert-text",
+                         G_CALLBACK(OnInsertTextAfter), this);
+  g_signal_connect(buffer, "delete-range", G_CALLBACK(OnDeleteRange), this);
+  g_signal_connect_after(buffer, "delete-range",
+                         G_CALLBACK(OnDeleteRangeAfter), this);
+  auto* loader = new TextBufferLoader(buffer, [this](float progress) {
+    on_load_progress.Emit(this, progress);
+  });
+  g_object_set_data_full(G_OBJECT(buffer), "text-loader", loader,
+                         Delete<TextBufferLoader>);
 }
 
 TextEdit::~TextEdit() {
 }
 
 void TextEdit::SetText(const std::string& text) {
+  CancelLoading();
   GtkTextBuffer* buffer = gtk_text_view_get_buffer(
       GTK_TEXT_VIEW(g_object_get_data(G_OBJECT(GetNative()), "text-view")));
   gtk_text_buffer_set_text(buffer, text.c_str(), text.size());
@@ -98,6 +303,22 @@ bool TextEdit::CanUndo() const {
   return TextBufferCanUndo(buffer);
 }
 
+void TextEdit::BeginUndoGroup() {
+  TextBufferBeginUndoGroup(GetBuffer(this));
+}
+
+void TextEdit::EndUndoGroup() {
+  TextBufferEndUndoGroup(GetBuffer(this));
+}
+
+void TextEdit::SetUndoMemoryLimit(uint32_t bytes) {
+  TextBufferSetUndoMemoryLimit(GetBuffer(this), bytes);
+}
+
+uint32_t TextEdit::GetUndoMemoryUsage() const {
+  return static_cast<uint32_t>(TextBufferGetUndoMemoryUsage(GetBuffer(this)));
+}
+
 void TextEdit::Cut() {
   GtkClipboard* clipboard = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
   GtkTextBuffer* buffer = gtk_text_view_get_buffer(
@@ -189,6 +410,124 @@ void TextEdit::DeleteRange(int start, int end) {
   gtk_text_buffer_delete(buffer, &start_iter, &end_iter);
 }
 
+int TextEdit::GetTextLength() const {
+  return gtk_text_buffer_get_char_count(GetBuffer(this));
+}
+
+int TextEdit::GetLineCount() const {
+  return gtk_text_buffer_get_line_count(GetBuffer(this));
+}
+
+std::string TextEdit::GetLine(int line) const {
+  GtkTextBuffer* buffer = GetBuffer(this);
+  if (line < 0 || line >= gtk_text_buffer_get_line_count(buffer))
+    return std::string();
+  GtkTextIter start_iter, end_iter;
+  gtk_text_buffer_get_iter_at_line(buffer, &start_iter, line);
+  end_iter = start_iter;
+  if (!gtk_text_iter_ends_line(&end_iter))
+    gtk_text_iter_forward_to_line_end(&end_iter);
+  char* text = gtk_text_buffer_get_text(buffer, &start_iter, &end_iter, false);
+  std::string result(text);
+  g_free(text);
+  return result;
+}
+
+int TextEdit::GetLineAtOffset(int offset) const {
+  GtkTextIter iter;
+  gtk_text_buffer_get_iter_at_offset(GetBuffer(this), &iter, offset);
+  return gtk_text_iter_get_line(&iter);
+}
+
+int TextEdit::GetLineStartOffset(int line) const {
+  GtkTextBuffer* buffer = GetBuffer(this);
+  if (line < 0 || line >= gtk_text_buffer_get_line_count(buffer))
+    return -1;
+  GtkTextIter iter;
+  gtk_text_buffer_get_iter_at_line(buffer, &iter, line);
+  return gtk_text_iter_get_offset(&iter);
+}
+
+std::tuple<int, int> TextEdit::GetVisibleRange() const {
+  GtkTextView* text_view =
+      GTK_TEXT_VIEW(g_object_get_data(G_OBJECT(GetNative()), "text-view"));
+  GdkRectangle rect;
+  gtk_text_view_get_visible_rect(text_view, &rect);
+  GtkTextIter start_iter, end_iter;
+  gtk_text_view_get_line_at_y(text_view, &start_iter, rect.y, nullptr);
+  gtk_text_view_get_line_at_y(text_view, &end_iter, rect.y + rect.height,
+                              nullptr);
+  if (!gtk_text_iter_ends_line(&end_iter))
+    gtk_text_iter_forward_to_line_end(&end_iter);
+  return std::make_tuple(gtk_text_iter_get_offset(&start_iter),
+                         gtk_text_iter_get_offset(&end_iter));
+}
+
+int TextEdit::GetRevision() const {
+  return GetData(GetBuffer(this))->revision;
+}
+
+void TextEdit::SetStyledRanges(const std::vector<StyledRange>& ranges) {
+  SetStyledRangesInRange(0, -1, ranges);
+}
+
+void TextEdit::SetStyledRangesInRange(int start, int end,
+                                      const std::vector<StyledRange>& ranges) {
+  GtkTextBuffer* buffer = GetBuffer(this);
+  int length = gtk_text_buffer_get_char_count(buffer);
+  if (end < 0 || end > length)
+    end = length;
+  start = std::max(0, start);
+  if (start >= end)
+    return;
+
+  // Only touch the spans that differ, so restyling unchanged text is cheap.
+  std::vector<StyleSpan> old_spans = GetStyleSpans(buffer, start, end);
+  std::vector<StyleSpan> new_spans =
+      GetSpansFromRanges(buffer, start, end, ranges);
+  std::vector<StyleSpan> removed, added;
+  std::set_difference(old_spans.begin(), old_spans.end(),
+                      new_spans.begin(), new_spans.end(),
+                      std::back_inserter(removed));
+  std::set_difference(new_spans.begin(), new_spans.end(),
+                      old_spans.begin(), old_spans.end(),
+                      std::back_inserter(added));
+  GtkTextIter start_iter, end_iter;
+  for (const StyleSpan& span : removed) {
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, span.start);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, span.end);
+    gtk_text_buffer_remove_tag(buffer, span.tag, &start_iter, &end_iter);
+  }
+  for (const StyleSpan& span : added) {
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, span.start);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, span.end);
+    gtk_text_buffer_apply_tag(buffer, span.tag, &start_iter, &end_iter);
+  }
+}
+
+bool TextEdit::LoadFromFile(const base::FilePath& path) {
+  CancelLoading();
+  if (!GetLoader(this)->AddFile(path))
+    return false;
+  // The history does not apply to the new content.
+  TextBufferBeginNotUndoableAction(GetBuffer(this));
+  gtk_text_buffer_set_text(GetBuffer(this), "", 0);
+  TextBufferEndNotUndoableAction(GetBuffer(this));
+  return true;
+}
+
+void TextEdit::AppendChunks(std::vector<std::string> chunks) {
+  GetLoader(this)->AddChunks(std::move(chunks));
+}
+
+bool TextEdit::IsLoading() const {
+  return GetLoader(this)->IsLoading();
+}
+
+void TextEdit::CancelLoading() {
+  GetLoader(this)->Cancel();
+}
+
 void TextEdit::SetOverlayScrollbar(bool overlay) {
   if (GtkVersionCheck(3, 16))
     gtk_scrolled_window_set_overlay_scrolling(GTK_SCROLLED_WINDOW(GetNative()),
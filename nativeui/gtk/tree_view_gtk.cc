@@ -0,0 +1,287 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/tree_view.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "nativeui/gtk/nu_tree_view_model.h"
+#include "nativeui/gtk/widget_util.h"
+
+namespace nu {
+
+namespace {
+
+GtkTreeView* GetTreeView(const View* view) {
+  return GTK_TREE_VIEW(g_object_get_data(G_OBJECT(view->GetNative()),
+                                         "tree-view"));
+}
+
+// Load the children of a node before it is expanded.
+gboolean OnTestExpandRow(GtkTreeView* tree_view,
+                         GtkTreeIter* iter,
+                         GtkTreePath* path,
+                         TreeView* view) {
+  TreeModel::NodeId node = nu_tree_view_model_get_node(iter);
+  view->GetModel()->LoadChildren(node);
+  // Nodes loaded without children can not be expanded.
+  auto* tree_model = NU_TREE_VIEW_MODEL(gtk_tree_view_get_model(tree_view));
+  return nu_tree_view_model_get_n_rows(tree_model, node) == 0;
+}
+
+// Called to provide data to cell renderer.
+void TreeCellData(GtkTreeViewColumn* tree_column,
+                  GtkCellRenderer* renderer,
+                  GtkTreeModel* tree_model,
+                  GtkTreeIter* iter,
+                  void* user_data) {
+  int column = GPOINTER_TO_INT(user_data);
+
+  // The placeholder shows loading text in first column.
+  if (nu_tree_view_model_is_placeholder(iter)) {
+    GtkWidget* tree_view = gtk_tree_view_column_get_tree_view(tree_column);
+    bool first = gtk_tree_view_get_column(GTK_TREE_VIEW(tree_view), 0) ==
+                 tree_column;
+    g_object_set(renderer, "text",
+                 first ? static_cast<const char*>(g_object_get_data(
+                             G_OBJECT(tree_view), "loading-text"))
+                       : "",
+                 nullptr);
+    return;
+  }
+
+  GValue gval = G_VALUE_INIT;
+  gtk_tree_model_get_value(tree_model, iter, column, &gval);
+  const auto* value =
+      static_cast<const base::Value*>(g_value_get_pointer(&gval));
+  g_value_unset(&gval);
+
+  std::string text;
+  if (value && value->is_string())
+    text = value->GetString();
+  else if (value && value->is_int())
+    text = base::IntToString(value->GetInt());
+  else if (value && value->is_double())
+    text = base::NumberToString(value->GetDouble());
+  else if (value && value->is_bool())
+    text = value->GetBool() ? "true" : "false";
+  g_object_set(renderer, "text", text.c_str(), nullptr);
+}
+
+}  // namespace
+
+// static
+const char TreeView::kClassName[] = "TreeView";
+
+TreeView::TreeView() {
+  GtkWidget* tree_view = gtk_tree_view_new();
+  g_object_set_data_full(G_OBJECT(tree_view), "loading-text",
+                         g_strdup("Loading..."), g_free);
+  g_signal_connect(tree_view, "test-expand-row",
+                   G_CALLBACK(OnTestExpandRow), this);
+  gtk_widget_show(tree_view);
+
+  GtkWidget* scroll = gtk_scrolled_window_new(nullptr, nullptr);
+  g_object_set_data(G_OBJECT(scroll), "tree-view", tree_view);
+  gtk_container_add(GTK_CONTAINER(scroll), tree_view);
+  TakeOverView(scroll);
+}
+
+TreeView::~TreeView() {
+  // The widget relies on the model to get nodes, so we must ensure the
+  // widget is destroyed before the model.
+  PlatformDestroy();
+  if (model_)
+    model_->RemoveObserver(this);
+}
+
+void TreeView::SetModel(TreeModel* model) {
+  if (model_)
+    model_->RemoveObserver(this);
+  model_ = model;
+  GtkTreeView* tree_view = GetTreeView(this);
+  if (!model) {
+    gtk_tree_view_set_model(tree_view, nullptr);
+    return;
+  }
+  NUTreeViewModel* tree_model = nu_tree_view_model_new(model);
+  gtk_tree_view_set_model(tree_view, GTK_TREE_MODEL(tree_model));
+  g_object_unref(tree_model);
+  model->AddObserver(this);
+  // Top level nodes are loaded when the model is shown.
+  model->LoadChildren(TreeModel::kRootNode);
+}
+
+TreeModel* TreeView::GetModel() {
+  return model_.get();
+}
+
+void TreeView::AddColumn(const std::string& title) {
+  GtkTreeView* tree_view = GetTreeView(this);
+  int column = GetColumnCount();
+  GtkCellRenderer* renderer = gtk_cell_renderer_text_new();
+  auto* tree_column = gtk_tree_view_column_new_with_attributes(
+      title.c_str(), renderer, nullptr);
+  gtk_tree_view_column_set_resizable(tree_column, true);
+  gtk_tree_view_column_set_cell_data_func(
+      tree_column, renderer, &TreeCellData, GINT_TO_POINTER(column), nullptr);
+  gtk_tree_view_append_column(tree_view, tree_column);
+}
+
+int TreeView::GetColumnCount() const {
+  return gtk_tree_view_get_n_columns(GetTreeView(this));
+}
+
+void TreeView::SetColumnsVisible(bool visible) {
+  gtk_tree_view_set_headers_visible(GetTreeView(this), visible);
+}
+
+bool TreeView::IsColumnsVisible() const {
+  return gtk_tree_view_get_headers_visible(GetTreeView(this));
+}
+
+void TreeView::SetLoadingText(const std::string& text) {
+  GtkTreeView* tree_view = GetTreeView(this);
+  g_object_set_data_full(G_OBJECT(tree_view), "loading-text",
+                         g_strdup(text.c_str()), g_free);
+  gtk_widget_queue_draw(GTK_WIDGET(tree_view));
+}
+
+void TreeView::ExpandNode(NodeId node) {
+  if (!model_ || !model_->HasNode(node) || node == TreeModel::kRootNode)
+    return;
+  GtkTreeView* tree_view = GetTreeView(this);
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(gtk_tree_view_get_model(tree_view)), node);
+  gtk_tree_view_expand_to_path(tree_view, path);
+  gtk_tree_path_free(path);
+}
+
+void TreeView::CollapseNode(NodeId node) {
+  if (!model_ || !model_->HasNode(node) || node == TreeModel::kRootNode)
+    return;
+  GtkTreeView* tree_view = GetTreeView(this);
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(gtk_tree_view_get_model(tree_view)), node);
+  gtk_tree_view_collapse_row(tree_view, path);
+  gtk_tree_path_free(path);
+}
+
+bool TreeView::IsNodeExpanded(NodeId node) const {
+  if (!model_ || !model_->HasNode(node) || node == TreeModel::kRootNode)
+    return false;
+  GtkTreeView* tree_view = GetTreeView(this);
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(gtk_tree_view_get_model(tree_view)), node);
+  bool expanded = gtk_tree_view_row_expanded(tree_view, path);
+  gtk_tree_path_free(path);
+  return expanded;
+}
+
+void TreeView::SelectNode(NodeId node) {
+  if (!model_ || !model_->HasNode(node) || node == TreeModel::kRootNode)
+    return;
+  GtkTreeSelection* selection = gtk_tree_view_get_selection(GetTreeView(this));
+  GtkTreeIter iter;
+  nu_tree_view_model_init_iter(&iter, node, false);
+  gtk_tree_selection_select_iter(selection, &iter);
+}
+
+TreeView::NodeId TreeView::GetSelectedNode() const {
+  GtkTreeView* tree_view = GetTreeView(this);
+  GtkTreeModel* tree_model = gtk_tree_view_get_model(tree_view);
+  if (!tree_model)
+    return TreeModel::kRootNode;
+  GtkTreeIter iter;
+  GtkTreeSelection* selection = gtk_tree_view_get_selection(tree_view);
+  if (!gtk_tree_selection_get_selected(selection, &tree_model, &iter) ||
+      nu_tree_view_model_is_placeholder(&iter))
+    return TreeModel::kRootNode;
+  return nu_tree_view_model_get_node(&iter);
+}
+
+const char* TreeView::GetClassName() const {
+  return kClassName;
+}
+
+void TreeView::OnNodesInserted(TreeModel* model, NodeId parent,
+                               uint32_t start, uint32_t count) {
+  auto* tree_model = gtk_tree_view_get_model(GetTreeView(this));
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(tree_model), parent);
+  gtk_tree_path_append_index(path, start);
+  // Rows under collapsed nodes are not built by GtkTreeView, so notifying
+  // them is cheap.
+  for (uint32_t i = 0; i < count; ++i) {
+    GtkTreeIter iter;
+    nu_tree_view_model_init_iter(
+        &iter, model->GetChildAt(parent, start + i), false);
+    gtk_tree_model_row_inserted(tree_model, path, &iter);
+    gtk_tree_path_next(path);
+  }
+  gtk_tree_path_free(path);
+  if (parent != TreeModel::kRootNode && start == 0) {
+    GtkTreePath* parent_path = nu_tree_view_model_get_node_path(
+        NU_TREE_VIEW_MODEL(tree_model), parent);
+    GtkTreeIter iter;
+    nu_tree_view_model_init_iter(&iter, parent, false);
+    gtk_tree_model_row_has_child_toggled(tree_model, parent_path, &iter);
+    gtk_tree_path_free(parent_path);
+  }
+}
+
+void TreeView::OnNodesDeleted(TreeModel* model, NodeId parent,
+                              uint32_t start, uint32_t count) {
+  auto* tree_model = gtk_tree_view_get_model(GetTreeView(this));
+  GtkTreePath* parent_path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(tree_model), parent);
+  // Remove from the end so the paths of remaining rows do not change.
+  for (uint32_t i = start + count; i > start; --i) {
+    GtkTreePath* path = gtk_tree_path_copy(parent_path);
+    gtk_tree_path_append_index(path, i - 1);
+    gtk_tree_model_row_deleted(tree_model, path);
+    gtk_tree_path_free(path);
+  }
+  if (parent != TreeModel::kRootNode && model->GetChildCount(parent) == 0) {
+    GtkTreeIter iter;
+    nu_tree_view_model_init_iter(&iter, parent, false);
+    gtk_tree_model_row_has_child_toggled(tree_model, parent_path, &iter);
+  }
+  gtk_tree_path_free(parent_path);
+}
+
+void TreeView::OnNodeChanged(TreeModel* model, NodeId node) {
+  auto* tree_model = gtk_tree_view_get_model(GetTreeView(this));
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(tree_model), node);
+  GtkTreeIter iter;
+  nu_tree_view_model_init_iter(&iter, node, false);
+  gtk_tree_model_row_changed(tree_model, path, &iter);
+  gtk_tree_path_free(path);
+}
+
+void TreeView::OnNodeLoadStateChanged(TreeModel* model, NodeId node) {
+  if (node == TreeModel::kRootNode || !model->IsExpandable(node))
+    return;
+  auto* tree_model = gtk_tree_view_get_model(GetTreeView(this));
+  GtkTreePath* path = nu_tree_view_model_get_node_path(
+      NU_TREE_VIEW_MODEL(tree_model), node);
+  GtkTreeIter iter;
+  if (model->IsLoaded(node)) {
+    // The placeholder is after the newly inserted children, removing it last
+    // keeps the node expanded.
+    gtk_tree_path_append_index(path, model->GetChildCount(node));
+    gtk_tree_model_row_deleted(tree_model, path);
+    gtk_tree_path_up(path);
+  } else {
+    gtk_tree_path_append_index(path, 0);
+    nu_tree_view_model_init_iter(&iter, node, true);
+    gtk_tree_model_row_inserted(tree_model, path, &iter);
+    gtk_tree_path_up(path);
+  }
+  nu_tree_view_model_init_iter(&iter, node, false);
+  gtk_tree_model_row_has_child_toggled(tree_model, path, &iter);
+  gtk_tree_path_free(path);
+}
+
+}  // namespace nu
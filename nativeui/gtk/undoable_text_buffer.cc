@@ -6,9 +6,10 @@
 
 #include <gtk/gtk.h>
 
-#include <stack>
+#include <deque>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "nativeui/gtk/widget_util.h"
 
@@ -16,6 +17,9 @@ namespace nu {
 
 namespace {
 
+// Typing within this time is merged into one undo step, in microseconds.
+const gint64 kMergeTimeout = 1000 * 1000;
+
 // Insert or Delete.
 enum ActionType {
   INSERT,
@@ -26,7 +30,11 @@ enum ActionType {
 struct UndoableAction {
   // Insert action.
   UndoableAction(GtkTextIter* iter, std::string&& text)
-      : type(INSERT), start(gtk_text_iter_get_offset(iter)), text(text) {}
+      : type(INSERT),
+        start(gtk_text_iter_get_offset(iter)),
+        end(start + g_utf8_strlen(text.data(), text.size())),
+        text(std::move(text)),
+        is_delete(false) {}
 
   // Delete action.
   UndoableAction(GtkTextBuffer* buffer,
@@ -34,8 +42,11 @@ struct UndoableAction {
                  GtkTextIter* end_iter)
       : type(DELETE),
         start(gtk_text_iter_get_offset(start_iter)),
-        end(gtk_text_iter_get_offset(end_iter)),
-        text(gtk_text_buffer_get_text(buffer, start_iter, end_iter, TRUE)) {
+        end(gtk_text_iter_get_offset(end_iter)) {
+    char* deleted = gtk_text_buffer_get_text(buffer, start_iter, end_iter,
+                                             TRUE);
+    text = deleted;
+    g_free(deleted);
     // Whether it is Delete or Backspace key.
     GtkTextIter insert_iter;
     gtk_text_buffer_get_iter_at_mark(buffer, &insert_iter,
@@ -43,38 +54,237 @@ struct UndoableAction {
     is_delete = gtk_text_iter_get_offset(&insert_iter) <= start;
   }
 
+  // Approximate memory used by this action.
+  size_t GetMemoryUsage() const {
+    return sizeof(UndoableAction) + text.capacity();
+  }
+
   ActionType type;
   int start;
-  int end;  // only used by delete action
+  int end;  // in characters, the text is stored in UTF-8
   std::string text;
   bool is_delete;
 };
 
+// Actions undone and redone together.
+struct UndoableGroup {
+  std::vector<UndoableAction> actions;
+  size_t memory_usage = 0;
+};
+
 // A structure holding the undo and redo stacks.
 struct UndoableData {
-  std::stack<UndoableAction> undo_stack;
-  std::stack<UndoableAction> redo_stack;
+  // The oldest history is at the front, so it can be dropped cheaply.
+  std::deque<UndoableGroup> undo_stack;
+  std::deque<UndoableGroup> redo_stack;
   bool ignore_events = false;
+  int not_undoable_level = 0;
+  int user_action_level = 0;
+  int group_level = 0;
+  // Whether new actions go into the group at the top of undo stack.
+  bool in_group = false;
+  // Whether the top action can be merged with typing.
+  bool can_merge = false;
+  gint64 last_edit_time = 0;
+  size_t memory_usage = 0;
+  size_t memory_limit = kDefaultUndoMemoryLimit;
 };
 
+UndoableData* GetData(GtkTextBuffer* buffer) {
+  return static_cast<UndoableData*>(
+      g_object_get_data(G_OBJECT(buffer), "undoable-data"));
+}
+
+// Whether the action is a single character typed or deleted by user.
+bool IsTyping(const UndoableAction& action) {
+  if (action.end - action.start != 1)
+    return false;
+  return action.text != "\n" && action.text != "\r";
+}
+
+bool IsSpace(const std::string& text, size_t pos) {
+  return g_unichar_isspace(g_utf8_get_char(text.data() + pos));
+}
+
+// Try to merge typing |action| into |top|.
+bool MergeAction(UndoableAction* top, const UndoableAction& action) {
+  if (top->type != action.type || !IsTyping(action))
+    return false;
+  if (action.type == INSERT) {
+    if (action.start != top->end)
+      return false;
+    // Start a new step at word boundaries.
+    const char* last = g_utf8_find_prev_char(top->text.data(),
+                                             top->text.data() +
+                                             top->text.size());
+    if (last && IsSpace(action.text, 0) &&
+        !IsSpace(top->text, last - top->text.data()))
+      return false;
+    top->text += action.text;
+    top->end = action.end;
+    return true;
+  } else {
+    if (action.is_delete != top->is_delete)
+      return false;
+    if (action.is_delete && action.start == top->start) {
+      top->text += action.text;
+      top->end += 1;
+      return true;
+    } else if (!action.is_delete && action.end == top->start) {
+      top->text.insert(0, action.text);
+      top->start = action.start;
+      return true;
+    }
+    return false;
+  }
+}
+
+void ClearRedoStack(UndoableData* data) {
+  for (const UndoableGroup& group : data->redo_stack)
+    data->memory_usage -= group.memory_usage;
+  data->redo_stack.clear();
+}
+
+// Drop the oldest history until memory usage is under limit.
+void TrimHistory(UndoableData* data) {
+  while (data->memory_usage > data->memory_limit &&
+         !data->undo_stack.empty()) {
+    // Never drop the group being built.
+    if (data->undo_stack.size() == 1 && data->in_group)
+      break;
+    data->memory_usage -= data->undo_stack.front().memory_usage;
+    data->undo_stack.pop_front();
+  }
+  // The last typing has been dropped, there is nothing to merge with.
+  if (data->undo_stack.empty())
+    data->can_merge = false;
+  while (data->memory_usage > data->memory_limit &&
+         !data->redo_stack.empty()) {
+    data->memory_usage -= data->redo_stack.front().memory_usage;
+    data->redo_stack.pop_front();
+  }
+}
+
+// Merge |action| into the last action of |group|, the memory usage is only
+// updated by the change of the merged action.
+bool MergeIntoGroup(UndoableData* data, UndoableGroup* group,
+                    const UndoableAction& action) {
+  UndoableAction* top = &group->actions.back();
+  size_t old_size = top->GetMemoryUsage();
+  if (!MergeAction(top, action))
+    return false;
+  size_t new_size = top->GetMemoryUsage();
+  group->memory_usage = group->memory_usage - old_size + new_size;
+  data->memory_usage = data->memory_usage - old_size + new_size;
+  return true;
+}
+
+void PushToGroup(UndoableData* data, UndoableGroup* group,
+                 UndoableAction&& action) {
+  size_t size = action.GetMemoryUsage();
+  group->memory_usage += size;
+  data->memory_usage += size;
+  group->actions.push_back(std::move(action));
+}
+
+void RecordAction(UndoableData* data, UndoableAction&& action) {
+  ClearRedoStack(data);
+
+  gint64 now = g_get_monotonic_time();
+  bool typing = data->user_action_level > 0 && data->group_level == 0;
+  bool is_typing = IsTyping(action);
+  if (data->in_group) {
+    // Adding to current group.
+    UndoableGroup* group = &data->undo_stack.back();
+    if (!typing || !MergeIntoGroup(data, group, action))
+      PushToGroup(data, group, std::move(action));
+  } else if (typing && data->can_merge && !data->undo_stack.empty() &&
+             now - data->last_edit_time < kMergeTimeout &&
+             MergeIntoGroup(data, &data->undo_stack.back(), action)) {
+    // Merged with last typing.
+  } else {
+    // Start a new step.
+    data->undo_stack.emplace_back();
+    PushToGroup(data, &data->undo_stack.back(), std::move(action));
+  }
+  data->in_group = data->user_action_level > 0 || data->group_level > 0;
+  data->can_merge = typing && is_typing;
+  data->last_edit_time = now;
+  TrimHistory(data);
+}
+
 void OnInsertText(GtkTextBuffer* buffer,
                   GtkTextIter* iter,
                   gchar* text, gint length,
                   UndoableData* data) {
-  if (data->ignore_events)
+  if (data->ignore_events || data->not_undoable_level > 0)
     return;
-  data->redo_stack = std::stack<UndoableAction>();
-  data->undo_stack.emplace(iter, std::string(text, length));
+  RecordAction(data, UndoableAction(iter, std::string(text, length)));
 }
 
 void OnDeleteRange(GtkTextBuffer* buffer,
                    GtkTextIter* start_iter,
                    GtkTextIter* end_iter,
                    UndoableData* data) {
-  if (data->ignore_events)
+  if (data->ignore_events || data->not_undoable_level > 0)
     return;
-  data->redo_stack = std::stack<UndoableAction>();
-  data->undo_stack.emplace(buffer, start_iter, end_iter);
+  RecordAction(data, UndoableAction(buffer, start_iter, end_iter));
+}
+
+void OnBeginUserAction(GtkTextBuffer* buffer, UndoableData* data) {
+  data->user_action_level++;
+}
+
+void OnEndUserAction(GtkTextBuffer* buffer, UndoableData* data) {
+  if (data->user_action_level > 0 && --data->user_action_level == 0 &&
+      data->group_level == 0)
+    data->in_group = false;
+}
+
+// Close the group being built, so it is undone as a whole.
+void CloseGroup(UndoableData* data) {
+  data->in_group = false;
+  data->can_merge = false;
+}
+
+void ApplyUndo(GtkTextBuffer* buffer, const UndoableAction& action) {
+  if (action.type == INSERT) {
+    GtkTextIter start_iter, end_iter;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, action.start);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, action.end);
+    gtk_text_buffer_delete(buffer, &start_iter, &end_iter);
+    gtk_text_buffer_place_cursor(buffer, &start_iter);
+  } else {
+    GtkTextIter start_iter;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, action.start);
+    gtk_text_buffer_insert(buffer, &start_iter,
+                           action.text.data(), action.text.length());
+    if (action.is_delete) {
+      gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, action.start);
+      gtk_text_buffer_place_cursor(buffer, &start_iter);
+    } else {
+      GtkTextIter end_iter;
+      gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, action.end);
+      gtk_text_buffer_place_cursor(buffer, &end_iter);
+    }
+  }
+}
+
+void ApplyRedo(GtkTextBuffer* buffer, const UndoableAction& action) {
+  if (action.type == INSERT) {
+    GtkTextIter start_iter, end_iter;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, action.start);
+    gtk_text_buffer_insert(buffer, &start_iter,
+                           action.text.data(), action.text.length());
+    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, action.end);
+    gtk_text_buffer_place_cursor(buffer, &end_iter);
+  } else {
+    GtkTextIter start_iter, end_iter;
+    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, action.start);
+    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, action.end);
+    gtk_text_buffer_delete(buffer, &start_iter, &end_iter);
+    gtk_text_buffer_place_cursor(buffer, &start_iter);
+  }
 }
 
 }  // namespace
@@ -85,6 +295,10 @@ void TextBufferMakeUndoable(GtkTextBuffer* buffer) {
                          Delete<UndoableData>);
   g_signal_connect(buffer, "insert-text", G_CALLBACK(OnInsertText), data);
   g_signal_connect(buffer, "delete-range", G_CALLBACK(OnDeleteRange), data);
+  g_signal_connect(buffer, "begin-user-action",
+                   G_CALLBACK(OnBeginUserAction), data);
+  g_signal_connect(buffer, "end-user-action",
+                   G_CALLBACK(OnEndUserAction), data);
 }
 
 bool TextBufferIsUndoable(GtkTextBuffer* buffer) {
@@ -92,80 +306,95 @@ bool TextBufferIsUndoable(GtkTextBuffer* buffer) {
 }
 
 void TextBufferUndo(GtkTextBuffer* buffer) {
-  auto* data = static_cast<UndoableData*>(
-      g_object_get_data(G_OBJECT(buffer), "undoable-data"));
+  UndoableData* data = GetData(buffer);
+  CloseGroup(data);
   if (data->undo_stack.empty())
     return;
 
-  UndoableAction undo_action = std::move(data->undo_stack.top());
-  data->undo_stack.pop();
+  UndoableGroup group = std::move(data->undo_stack.back());
+  data->undo_stack.pop_back();
 
   data->ignore_events = true;
-  if (undo_action.type == INSERT) {
-    GtkTextIter start_iter, end_iter;
-    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, undo_action.start);
-    gtk_text_buffer_get_iter_at_offset(
-        buffer, &end_iter, undo_action.start + undo_action.text.length());
-    gtk_text_buffer_delete(buffer, &start_iter, &end_iter);
-    gtk_text_buffer_place_cursor(buffer, &start_iter);
-  } else {
-    GtkTextIter start_iter;
-    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, undo_action.start);
-    gtk_text_buffer_insert(buffer, &start_iter,
-                           undo_action.text.data(), undo_action.text.length());
-    if (undo_action.is_delete) {
-      gtk_text_buffer_place_cursor(buffer, &start_iter);
-    } else {
-      GtkTextIter end_iter;
-      gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, undo_action.end);
-      gtk_text_buffer_place_cursor(buffer, &end_iter);
-    }
-  }
+  for (auto it = group.actions.rbegin(); it != group.actions.rend(); ++it)
+    ApplyUndo(buffer, *it);
   data->ignore_events = false;
 
-  data->redo_stack.push(std::move(undo_action));
+  data->redo_stack.push_back(std::move(group));
 }
 
 bool TextBufferCanUndo(GtkTextBuffer* buffer) {
-  auto* data = static_cast<UndoableData*>(
-      g_object_get_data(G_OBJECT(buffer), "undoable-data"));
-  return !data->undo_stack.empty();
+  return !GetData(buffer)->undo_stack.empty();
 }
 
 void TextBufferRedo(GtkTextBuffer* buffer) {
-  auto* data = static_cast<UndoableData*>(
-      g_object_get_data(G_OBJECT(buffer), "undoable-data"));
+  UndoableData* data = GetData(buffer);
+  CloseGroup(data);
   if (data->redo_stack.empty())
     return;
 
-  UndoableAction redo_action = std::move(data->redo_stack.top());
-  data->redo_stack.pop();
+  UndoableGroup group = std::move(data->redo_stack.back());
+  data->redo_stack.pop_back();
 
   data->ignore_events = true;
-  if (redo_action.type == INSERT) {
-    GtkTextIter start_iter, end_iter;
-    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, redo_action.start);
-    gtk_text_buffer_insert(buffer, &start_iter,
-                           redo_action.text.data(), redo_action.text.length());
-    gtk_text_buffer_get_iter_at_offset(
-        buffer, &end_iter, redo_action.start + redo_action.text.length());
-    gtk_text_buffer_place_cursor(buffer, &end_iter);
-  } else {
-    GtkTextIter start_iter, end_iter;
-    gtk_text_buffer_get_iter_at_offset(buffer, &start_iter, redo_action.start);
-    gtk_text_buffer_get_iter_at_offset(buffer, &end_iter, redo_action.end);
-    gtk_text_buffer_delete(buffer, &start_iter, &end_iter);
-    gtk_text_buffer_place_cursor(buffer, &start_iter);
-  }
+  for (const UndoableAction& action : group.actions)
+    ApplyRedo(buffer, action);
   data->ignore_events = false;
 
-  data->undo_stack.emplace(std::move(redo_action));
+  data->undo_stack.push_back(std::move(group));
 }
 
 bool TextBufferCanRedo(GtkTextBuffer* buffer) {
-  auto* data = static_cast<UndoableData*>(
-      g_object_get_data(G_OBJECT(buffer), "undoable-data"));
-  return !data->redo_stack.empty();
+  return !GetData(buffer)->redo_stack.empty();
+}
+
+void TextBufferBeginUndoGroup(GtkTextBuffer* buffer) {
+  UndoableData* data = GetData(buffer);
+  if (data->group_level++ == 0)
+    CloseGroup(data);
+}
+
+void TextBufferEndUndoGroup(GtkTextBuffer* buffer) {
+  UndoableData* data = GetData(buffer);
+  if (data->group_level > 0 && --data->group_level == 0)
+    CloseGroup(data);
+}
+
+void TextBufferSetUndoMemoryLimit(GtkTextBuffer* buffer, size_t limit) {
+  UndoableData* data = GetData(buffer);
+  data->memory_limit = limit;
+  TrimHistory(data);
+}
+
+size_t TextBufferGetUndoMemoryUsage(GtkTextBuffer* buffer) {
+  return GetData(buffer)->memory_usage;
+}
+
+void TextBufferBeginNotUndoableAction(GtkTextBuffer* buffer) {
+  UndoableData* data = GetData(buffer);
+  if (data->not_undoable_level++ == 0) {
+    CloseGroup(data);
+    data->undo_stack.clear();
+    data->redo_stack.clear();
+    data->memory_usage = 0;
+  }
+}
+
+void TextBufferEndNotUndoableAction(GtkTextBuffer* buffer) {
+  UndoableData* data = GetData(buffer);
+  // The data may have been destroyed when the buffer is being finalized.
+  if (data && data->not_undoable_level > 0)
+    --data->not_undoable_level;
+}
+
+void TextBufferAppendNotUndoable(GtkTextBuffer* buffer,
+                                 const char* text,
+                                 int length) {
+  UndoableData* data = GetData(buffer);
+  data->not_undoable_level++;
+  GtkTextIter iter;
+  gtk_text_buffer_get_end_iter(buffer, &iter);
+  gtk_text_buffer_insert(buffer, &iter, text, length);
+  data->not_undoable_level--;
 }
 
 }  // namespace nu
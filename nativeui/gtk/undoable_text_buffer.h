@@ -5,10 +5,15 @@
 #ifndef NATIVEUI_GTK_UNDOABLE_TEXT_BUFFER_H_
 #define NATIVEUI_GTK_UNDOABLE_TEXT_BUFFER_H_
 
+#include <stddef.h>
+
 typedef struct _GtkTextBuffer GtkTextBuffer;
 
 namespace nu {
 
+// Default memory used by undo history before dropping oldest steps.
+const size_t kDefaultUndoMemoryLimit = 16 * 1024 * 1024;
+
 // Attach undo/redo stacks to a text buffer.
 void TextBufferMakeUndoable(GtkTextBuffer* buffer);
 bool TextBufferIsUndoable(GtkTextBuffer* buffer);
@@ -19,6 +24,26 @@ bool TextBufferCanUndo(GtkTextBuffer* buffer);
 void TextBufferRedo(GtkTextBuffer* buffer);
 bool TextBufferCanRedo(GtkTextBuffer* buffer);
 
+// Changes made between the calls are undone in one step. Typing is merged
+// into one step automatically.
+void TextBufferBeginUndoGroup(GtkTextBuffer* buffer);
+void TextBufferEndUndoGroup(GtkTextBuffer* buffer);
+
+// Bound the memory used by undo history, oldest steps are dropped first.
+void TextBufferSetUndoMemoryLimit(GtkTextBuffer* buffer, size_t limit);
+size_t TextBufferGetUndoMemoryUsage(GtkTextBuffer* buffer);
+
+// Changes made between the calls are not recorded, and the existing history
+// is dropped since it no longer matches the text. Calls can be nested.
+void TextBufferBeginNotUndoableAction(GtkTextBuffer* buffer);
+void TextBufferEndNotUndoableAction(GtkTextBuffer* buffer);
+
+// Append text at the end without recording it. Unlike the not undoable
+// actions the history is kept, since appending does not move existing text.
+void TextBufferAppendNotUndoable(GtkTextBuffer* buffer,
+                                 const char* text,
+                                 int length);
+
 }  // namespace nu
 
 #endif  // NATIVEUI_GTK_UNDOABLE_TEXT_BUFFER_H_
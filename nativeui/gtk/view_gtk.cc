@@ -14,6 +14,7 @@
 #include "nativeui/gfx/geometry/point_f.h"
 #include "nativeui/gfx/geometry/rect_conversions.h"
 #include "nativeui/gfx/geometry/rect_f.h"
+#include "nativeui/gfx/gtk/pixbuf_util.h"
 #include "nativeui/gtk/clipboard_util.h"
 #include "nativeui/gtk/dragging_info_gtk.h"
 #include "nativeui/gtk/nu_container.h"
@@ -452,10 +453,10 @@ int View::DoDragWithOptions(std::vector<Clipboard::Data> objects,
 
   // Provide drag image if available.
   if (options.image)
-    gtk_drag_set_icon_pixbuf(
+    gtk_drag_set_icon_surface(
         priv->drag_context,
-        gdk_pixbuf_animation_get_static_image(options.image->GetNative()),
-        0, 0);
+        GetCachedSurfaceForPixbuf(
+            gdk_pixbuf_animation_get_static_image(options.image->GetNative())));
 
   // Block until the drag operation is done.
   gtk_main();
@@ -4,6 +4,7 @@
 
 #include "nativeui/mac/browser/nu_custom_protocol.h"
 
+#include <algorithm>
 #include <map>
 
 #include "base/mac/scoped_nsobject.h"
@@ -100,23 +101,73 @@ base::Lock g_lock;
     return;
   }
 
+  // Serve content already in memory without copying.
+  scoped_refptr<base::RefCountedMemory> content =
+      protocol_job_->GetMappedContent();
+
+  // Serve range requests when the job can seek.
+  NSString* range_header = [self.request valueForHTTPHeaderField:@"Range"];
+  std::string range(range_header ? [range_header UTF8String] : "");
+
   // Start.
-  protocol_job_->Plug([&](int size) {
+  protocol_job_->Plug([&, content, range](int64_t size) {
     std::string mime_type;
     protocol_job_->GetMimeType(&mime_type);
+    int64_t start = 0, end = size;
+    bool is_range = !range.empty() &&
+                    nu::ProtocolJob::ParseRange(range, size, &start, &end) &&
+                    (content || protocol_job_->Seek(start));
     // Send response.
-    base::scoped_nsobject<NSURLResponse> response(
-        [[NSURLResponse alloc] initWithURL:self.request.URL
-                                  MIMEType:base::SysUTF8ToNSString(mime_type)
-                     expectedContentLength:size
-                          textEncodingName:nil]);
+    base::scoped_nsobject<NSURLResponse> response;
+    if (is_range) {
+      NSDictionary* headers = @{
+        @"Accept-Ranges": @"bytes",
+        @"Content-Type": base::SysUTF8ToNSString(mime_type),
+        @"Content-Length": [NSString stringWithFormat:@"%lld", end - start],
+        @"Content-Range": [NSString stringWithFormat:@"bytes %lld-%lld/%lld",
+                                                     start, end - 1, size],
+      };
+      response.reset([[NSHTTPURLResponse alloc] initWithURL:self.request.URL
+                                                 statusCode:206
+                                                HTTPVersion:@"HTTP/1.1"
+                                               headerFields:headers]);
+    } else {
+      response.reset([[NSURLResponse alloc]
+                initWithURL:self.request.URL
+                   MIMEType:base::SysUTF8ToNSString(mime_type)
+      expectedContentLength:size
+           textEncodingName:nil]);
+    }
     [[self client] URLProtocol:self
             didReceiveResponse:response
             cacheStoragePolicy:NSURLCacheStorageNotAllowed];
-    // Read data.
+    if (content) {
+      // The data keeps a reference to the content until it is released.
+      base::RefCountedMemory* memory = content.get();
+      memory->AddRef();
+      size_t offset = is_range ? start : 0;
+      size_t length = is_range ? end - start : memory->size();
+      base::scoped_nsobject<NSData> data([[NSData alloc]
+          initWithBytesNoCopy:const_cast<unsigned char*>(memory->front()) +
+                              offset
+                       length:length
+                  deallocator:^(void*, NSUInteger) {
+                    memory->Release();
+                  }]);
+      [[self client] URLProtocol:self didLoadData:data];
+      [[self client] URLProtocolDidFinishLoading:self];
+      return;
+    }
+    // Read data, stop at the end of range.
     char bytes[4089];
     size_t nread = 0;
-    while ((nread = protocol_job_->Read(bytes, sizeof(bytes))) > 0) {
+    int64_t remaining = is_range ? end - start : -1;
+    while (remaining != 0 &&
+           (nread = protocol_job_->Read(bytes, sizeof(bytes))) > 0) {
+      if (remaining > 0) {
+        nread = std::min<int64_t>(nread, remaining);
+        remaining -= nread;
+      }
       NSData* data = [NSData dataWithBytesNoCopy:bytes
                                           length:nread
                                     freeWhenDone:NO];
@@ -36,6 +36,13 @@
   if (shell_->stop_serving() || ![message.name isEqualToString:@"yue"])
     return;
   base::Value args = nu::NSValueToBaseValue(message.body);
+  // Messages of the message port.
+  if (args.is_list() && args.GetList().size() == 2 &&
+      args.GetList()[0].is_string() && args.GetList()[1].is_list()) {
+    shell_->InvokeMessagePort(args.GetList()[0].GetString(),
+                              std::move(args.GetList()[1]));
+    return;
+  }
   if (!args.is_list() || args.GetList().size() != 3 ||
       !args.GetList()[0].is_string() ||
       !args.GetList()[1].is_string() ||
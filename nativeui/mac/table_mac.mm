@@ -209,4 +209,36 @@ void Table::NotifyValueChange(uint32_t column, uint32_t row) {
                        columnIndexes:[NSIndexSet indexSetWithIndex:column]];
 }
 
+void Table::NotifyRowsInserted(uint32_t start, uint32_t count) {
+  auto* tableView = static_cast<NSTableView*>(
+      [static_cast<NUTable*>(GetNative()) documentView]);
+  [tableView insertRowsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:
+                                      NSMakeRange(start, count)]
+                   withAnimation:NSTableViewAnimationEffectNone];
+}
+
+void Table::NotifyRowsDeleted(uint32_t start, uint32_t count) {
+  auto* tableView = static_cast<NSTableView*>(
+      [static_cast<NUTable*>(GetNative()) documentView]);
+  [tableView removeRowsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:
+                                      NSMakeRange(start, count)]
+                   withAnimation:NSTableViewAnimationEffectNone];
+}
+
+void Table::NotifyRowsChanged(uint32_t start, uint32_t count) {
+  auto* tableView = static_cast<NSTableView*>(
+      [static_cast<NUTable*>(GetNative()) documentView]);
+  NSIndexSet* columns = [NSIndexSet indexSetWithIndexesInRange:
+                            NSMakeRange(0, [tableView numberOfColumns])];
+  [tableView reloadDataForRowIndexes:[NSIndexSet indexSetWithIndexesInRange:
+                                         NSMakeRange(start, count)]
+                       columnIndexes:columns];
+}
+
+void Table::NotifyReset() {
+  auto* tableView = static_cast<NSTableView*>(
+      [static_cast<NUTable*>(GetNative()) documentView]);
+  [tableView reloadData];
+}
+
 }  // namespace nu
@@ -143,6 +143,20 @@ bool TextEdit::CanUndo() const {
   return [[textView undoManager] canUndo];
 }
 
+void TextEdit::BeginUndoGroup() {
+  auto* textView = static_cast<NSTextView*>(
+      [static_cast<NUTextEdit*>(GetNative()) documentView]);
+  // Close the typing group so it is not mixed with the new group.
+  [textView breakUndoCoalescing];
+  [[textView undoManager] beginUndoGrouping];
+}
+
+void TextEdit::EndUndoGroup() {
+  auto* textView = static_cast<NSTextView*>(
+      [static_cast<NUTextEdit*>(GetNative()) documentView]);
+  [[textView undoManager] endUndoGrouping];
+}
+
 void TextEdit::Cut() {
   auto* textView = static_cast<NSTextView*>(
       [static_cast<NUTextEdit*>(GetNative()) documentView]);
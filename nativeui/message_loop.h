@@ -33,9 +33,16 @@ class NATIVEUI_EXPORT MessageLoop {
   static TimerId SetTimeout(int ms, const Task& task);
   static void ClearTimeout(TimerId id);
 
+#if defined(OS_WIN)
+  // Internal: Set the window receiving tasks from all threads.
+  static void SetTaskWindow(HWND hwnd);
+#endif
+
  private:
 #if defined(OS_WIN)
   static void CALLBACK OnTimer(HWND, UINT, UINT_PTR event, DWORD);
+
+  static HWND task_window_;
 #endif
 
 #if defined(OS_WIN) || defined(OS_MACOSX)
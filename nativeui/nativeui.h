@@ -8,6 +8,7 @@
 #include "nativeui/app.h"
 #include "nativeui/browser.h"
 #include "nativeui/button.h"
+#include "nativeui/columnar_table_model.h"
 #include "nativeui/combo_box.h"
 #include "nativeui/cursor.h"
 #include "nativeui/entry.h"
@@ -16,12 +17,14 @@
 #include "nativeui/events/keyboard_codes.h"
 #include "nativeui/file_open_dialog.h"
 #include "nativeui/file_save_dialog.h"
+#include "nativeui/file_table_model.h"
 #include "nativeui/gfx/attributed_text.h"
 #include "nativeui/gfx/canvas.h"
 #include "nativeui/gfx/font.h"
 #include "nativeui/gfx/geometry/insets.h"
 #include "nativeui/gfx/image.h"
 #include "nativeui/gfx/painter.h"
+#include "nativeui/gfx/text_measurer.h"
 #include "nativeui/gif_player.h"
 #include "nativeui/group.h"
 #include "nativeui/label.h"
@@ -34,6 +37,7 @@
 #include "nativeui/protocol_asar_job.h"
 #include "nativeui/scroll.h"
 #include "nativeui/slider.h"
+#include "nativeui/sort_filter_table_model.h"
 #include "nativeui/state.h"
 #include "nativeui/system.h"
 #include "nativeui/tab.h"
@@ -41,8 +45,13 @@
 #include "nativeui/table_model.h"
 #include "nativeui/text_edit.h"
 #include "nativeui/tray.h"
+#include "nativeui/tree_model.h"
 #include "nativeui/window.h"
 
+#if defined(OS_LINUX)
+#include "nativeui/tree_view.h"
+#endif
+
 #if defined(OS_MACOSX)
 #include "nativeui/toolbar.h"
 #include "nativeui/vibrant.h"
@@ -0,0 +1,164 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "base/time/time.h"
+#include "nativeui/gfx/pixel_convert.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+using Converter = void(*)(const uint8_t*, int, uint8_t*, int, int, int);
+
+const nu::PixelConvertISA kAllISAs[] = {
+  nu::PixelConvertISA::Scalar,
+  nu::PixelConvertISA::SSE2,
+  nu::PixelConvertISA::AVX2,
+};
+
+std::vector<uint8_t> RandomPixels(size_t size) {
+  std::vector<uint8_t> pixels(size);
+  for (uint8_t& c : pixels)
+    c = static_cast<uint8_t>(rand());
+  return pixels;
+}
+
+// Run |converter| with every ISA and compare results with scalar code.
+void ExpectSameResultsForAllISAs(Converter converter, int src_bpp,
+                                 const std::vector<uint8_t>& src,
+                                 int width, int height, int padding) {
+  int src_stride = width * src_bpp + padding;
+  int dst_stride = width * 4 + padding;
+  std::vector<uint8_t> expected(dst_stride * height);
+  nu::SetPixelConvertISAForTesting(nu::PixelConvertISA::Scalar);
+  converter(src.data(), src_stride, expected.data(), dst_stride,
+            width, height);
+  for (nu::PixelConvertISA isa : kAllISAs) {
+    nu::SetPixelConvertISAForTesting(isa);
+    std::vector<uint8_t> result(dst_stride * height);
+    converter(src.data(), src_stride, result.data(), dst_stride,
+              width, height);
+    EXPECT_EQ(expected, result) << "width " << width
+                                << " isa " << static_cast<int>(isa);
+  }
+}
+
+class PixelConvertTest : public testing::Test {
+ protected:
+  void TearDown() override {
+    nu::SetPixelConvertISAForTesting(nu::PixelConvertISA::AVX2);
+  }
+};
+
+}  // namespace
+
+TEST_F(PixelConvertTest, Premultiply) {
+  const uint8_t src[] = { 255, 128, 0, 128,  10, 20, 30, 0,
+                          255, 255, 255, 255,  200, 100, 50, 51 };
+  uint32_t dst[4];
+  nu::ConvertRGBAToPremulBGRA(src, 0, reinterpret_cast<uint8_t*>(dst), 0,
+                              4, 1);
+  EXPECT_EQ(dst[0], 0x80804000u);
+  EXPECT_EQ(dst[1], 0x00000000u);
+  EXPECT_EQ(dst[2], 0xFFFFFFFFu);
+  EXPECT_EQ(dst[3], 0x3328140Au);
+}
+
+TEST_F(PixelConvertTest, Unpremultiply) {
+  const uint32_t src[] = { 0x80804000, 0x00000000, 0xFFFFFFFF, 0x3328140A };
+  uint8_t dst[16];
+  nu::ConvertPremulBGRAToRGBA(reinterpret_cast<const uint8_t*>(src), 0,
+                              dst, 0, 4, 1);
+  const uint8_t expected[] = { 255, 128, 0, 128,  0, 0, 0, 0,
+                               255, 255, 255, 255,  200, 100, 50, 51 };
+  for (size_t i = 0; i < sizeof(expected); ++i)
+    EXPECT_EQ(dst[i], expected[i]) << "byte " << i;
+}
+
+TEST_F(PixelConvertTest, RGBToBGRA) {
+  const uint8_t src[] = { 1, 2, 3,  4, 5, 6 };
+  uint32_t dst[2];
+  nu::ConvertRGBToBGRA(src, 0, reinterpret_cast<uint8_t*>(dst), 0, 2, 1);
+  EXPECT_EQ(dst[0], 0xFF010203u);
+  EXPECT_EQ(dst[1], 0xFF040506u);
+}
+
+TEST_F(PixelConvertTest, OpaqueRoundTrip) {
+  const int width = 37;
+  std::vector<uint8_t> src = RandomPixels(width * 4);
+  for (int i = 0; i < width; ++i)
+    src[i * 4 + 3] = 255;
+  for (nu::PixelConvertISA isa : kAllISAs) {
+    nu::SetPixelConvertISAForTesting(isa);
+    std::vector<uint8_t> bgra(width * 4), rgba(width * 4);
+    nu::ConvertRGBAToPremulBGRA(src.data(), 0, bgra.data(), 0, width, 1);
+    nu::ConvertPremulBGRAToRGBA(bgra.data(), 0, rgba.data(), 0, width, 1);
+    EXPECT_EQ(src, rgba);
+  }
+}
+
+TEST_F(PixelConvertTest, SameResultsForAllISAs) {
+  const int kPadding = 5;
+  for (int width : { 1, 3, 4, 7, 8, 9, 10, 15, 16, 17, 31, 64, 101 }) {
+    const int height = 3;
+    std::vector<uint8_t> rgba = RandomPixels((width * 4 + kPadding) * height);
+    // Mix in opaque and transparent pixels to reach the fast paths.
+    for (size_t i = 3; i < rgba.size(); i += 12)
+      rgba[i] = 255;
+    for (size_t i = 7; i < rgba.size(); i += 20)
+      rgba[i] = 0;
+    ExpectSameResultsForAllISAs(&nu::ConvertRGBAToPremulBGRA, 4, rgba,
+                                width, height, kPadding);
+    // Make sure input is valid premultiplied data.
+    std::vector<uint8_t> bgra((width * 4 + kPadding) * height);
+    nu::ConvertRGBAToPremulBGRA(rgba.data(), width * 4 + kPadding,
+                                bgra.data(), width * 4 + kPadding,
+                                width, height);
+    ExpectSameResultsForAllISAs(&nu::ConvertPremulBGRAToRGBA, 4, bgra,
+                                width, height, kPadding);
+    std::vector<uint8_t> rgb = RandomPixels((width * 3 + kPadding) * height);
+    ExpectSameResultsForAllISAs(&nu::ConvertRGBToBGRA, 3, rgb,
+                                width, height, kPadding);
+  }
+}
+
+// Run with --gtest_also_run_disabled_tests to print the timings of converting
+// a 4K image with each ISA.
+TEST_F(PixelConvertTest, DISABLED_Benchmark4K) {
+  const int width = 3840;
+  const int height = 2160;
+  const int kRuns = 10;
+  std::vector<uint8_t> rgba = RandomPixels(width * height * 4);
+  std::vector<uint8_t> rgb = RandomPixels(width * height * 3);
+  std::vector<uint8_t> bgra(width * height * 4);
+  for (nu::PixelConvertISA isa : kAllISAs) {
+    nu::SetPixelConvertISAForTesting(isa);
+    if (nu::GetPixelConvertISA() != isa)
+      continue;
+    base::TimeTicks start = base::TimeTicks::Now();
+    for (int i = 0; i < kRuns; ++i)
+      nu::ConvertRGBAToPremulBGRA(rgba.data(), width * 4, bgra.data(),
+                                  width * 4, width, height);
+    base::TimeDelta premul = base::TimeTicks::Now() - start;
+    start = base::TimeTicks::Now();
+    for (int i = 0; i < kRuns; ++i)
+      nu::ConvertPremulBGRAToRGBA(bgra.data(), width * 4, rgba.data(),
+                                  width * 4, width, height);
+    base::TimeDelta unpremul = base::TimeTicks::Now() - start;
+    start = base::TimeTicks::Now();
+    for (int i = 0; i < kRuns; ++i)
+      nu::ConvertRGBToBGRA(rgb.data(), width * 3, bgra.data(), width * 4,
+                           width, height);
+    base::TimeDelta rgb_to_bgra = base::TimeTicks::Now() - start;
+    printf("ISA %d: premultiply %.2fms, unpremultiply %.2fms, "
+           "rgb %.2fms per frame\n", static_cast<int>(isa),
+           premul.InMillisecondsF() / kRuns,
+           unpremul.InMillisecondsF() / kRuns,
+           rgb_to_bgra.InMillisecondsF() / kRuns);
+  }
+}
@@ -6,7 +6,9 @@
 
 #include <string.h>
 
-#include "nativeui/asar_archive.h"
+#include <algorithm>
+
+#include "third_party/zlib/zlib.h"
 
 namespace nu {
 
@@ -15,6 +17,13 @@ namespace {
 // The old asar extension name.
 const base::FilePath::CharType kOldAsarExt[] = FILE_PATH_LITERAL(".asar");
 
+// The size of encrypted or compressed data read from file each time.
+const size_t kChunkSize = 32 * 1024;
+
+// Where the decrypted chunk starts in buffer, leaving space for the last block
+// of previous chunk.
+const size_t kBlockOffset = AES_BLOCKLEN;
+
 }  // namespace
 
 ProtocolAsarJob::ProtocolAsarJob(const base::FilePath& asar,
@@ -24,22 +33,39 @@ ProtocolAsarJob::ProtocolAsarJob(const base::FilePath& asar,
   if (!file_.IsValid())
     return;
 
-  // Read asar.
-  AsarArchive archive(file_.Duplicate(), !asar.MatchesExtension(kOldAsarExt));
-  AsarArchive::FileInfo info;
-  if (!archive.IsValid() ||
-      !archive.GetFileInfo(path, &info)) {
+  // Read asar, the parsed header is shared by all jobs.
+  archive_ = AsarArchive::Open(asar, !asar.MatchesExtension(kOldAsarExt));
+  if (!archive_ ||
+      !archive_->GetFileInfo(path, &info_) ||
+      (info_.flags & AsarArchive::kUnpacked)) {
     file_.Close();
     return;
   }
 
   // Seek to the position of the path.
-  file_.Seek(base::File::FROM_BEGIN, info.offset);
+  file_.Seek(base::File::FROM_BEGIN, info_.offset);
   path_ = base::FilePath::FromUTF8Unsafe(path);
-  content_length_ = info.size;
+  content_length_ = content_size_ = info_.stored_size;
+  content_offset_ = info_.offset;
+
+  // Prepare for decompression.
+  if (info_.IsCompressed()) {
+    zstream_.reset(new z_stream);
+    memset(zstream_.get(), 0, sizeof(z_stream));
+    // Adding 32 to window bits enables automatic detection of zlib and gzip
+    // headers, while negative window bits means raw deflate.
+    int window_bits = (info_.flags & AsarArchive::kZlib) ? MAX_WBITS + 32
+                                                         : -MAX_WBITS;
+    if (inflateInit2(zstream_.get(), window_bits) != Z_OK) {
+      zstream_.reset();
+      file_.Close();
+    }
+  }
 }
 
 ProtocolAsarJob::~ProtocolAsarJob() {
+  if (zstream_)
+    inflateEnd(zstream_.get());
 }
 
 bool ProtocolAsarJob::SetDecipher(const std::string& key,
@@ -48,73 +74,144 @@ bool ProtocolAsarJob::SetDecipher(const std::string& key,
 }
 
 bool ProtocolAsarJob::Start() {
-  if (!aes_.IsValid())
+  if (!aes_.IsValid() && !zstream_)
     return ProtocolFileJob::Start();
   if (!file_.IsValid())
     return false;
+  // The size of decompressed data is recorded in archive.
+  if (zstream_) {
+    notify_content_length(info_.size);
+    return true;
+  }
   // Don't pass content length when stream is encrypted, since the decrypted
   // size might be smaller.
   notify_content_length(-1);
   return true;
 }
 
+scoped_refptr<base::RefCountedMemory> ProtocolAsarJob::GetMappedContent() {
+  // Encrypted and compressed content must be handled by Read.
+  if (!file_.IsValid() || aes_.IsValid() || zstream_)
+    return nullptr;
+  return archive_->GetFileContent(info_);
+}
+
+bool ProtocolAsarJob::CanSeek() const {
+  // Seeking in encrypted or compressed stream is not supported.
+  return !aes_.IsValid() && !zstream_ && ProtocolFileJob::CanSeek();
+}
+
+bool ProtocolAsarJob::Seek(int64_t offset) {
+  return CanSeek() && ProtocolFileJob::Seek(offset);
+}
+
 size_t ProtocolAsarJob::Read(void* buf, size_t buf_size) {
+  if (zstream_)
+    return ReadCompressed(buf, buf_size);
+  return ReadStored(buf, buf_size);
+}
+
+size_t ProtocolAsarJob::ReadStored(void* buf, size_t buf_size) {
   if (!aes_.IsValid())
     return ProtocolFileJob::Read(buf, buf_size);
 
-  if (buf_size < remaining_)
-    return 0;  // this is unlikely to happen
+  // Fill the buffer as much as we can, which works with any |buf_size|.
+  size_t nread = 0;
+  while (nread < buf_size) {
+    if (begin_ == end_ && !DecryptChunk())
+      break;
+    size_t size = std::min(buf_size - nread, end_ - begin_);
+    memcpy(static_cast<uint8_t*>(buf) + nread, &buffer_[begin_], size);
+    begin_ += size;
+    nread += size;
+  }
+  return nread;
+}
 
-  // Read as much as we can.
-  size_t nread = ProtocolFileJob::Read(static_cast<char*>(buf) + remaining_,
-                                       buf_size - remaining_);
-  if (nread == 0) {
-    if (remaining_ != 0) {
+bool ProtocolAsarJob::DecryptChunk() {
+  if (finished_)
+    return false;
+  begin_ = end_ = kBlockOffset;
+  if (buffer_.empty())
+    buffer_.resize(kBlockOffset + AES_BLOCKLEN + kChunkSize);
+
+  // Continue with the data left by last chunk.
+  uint8_t* data = &buffer_[kBlockOffset];
+  memcpy(data, remaining_, remaining_size_);
+  size_t size = remaining_size_ +
+                ProtocolFileJob::Read(data + remaining_size_, kChunkSize);
+
+  if (size == remaining_size_) {
+    // Reached the end of file, strip the padding from last block.
+    finished_ = true;
+    if (remaining_size_ != 0) {
       LOG(ERROR) << "The encrypted stream stored in asar is not aligned to "
-                 << AES_BLOCKLEN << "bytes";
+                 << AES_BLOCKLEN << " bytes";
     }
-    return 0;
-  }
-
-  // Put the remaining data of last read into buf, as if it was read this time.
-  if (remaining_ > 0) {
-    memcpy(buf, buffer_, remaining_);
-    nread += remaining_;
+    if (!has_last_block_)
+      return false;
+    uint8_t paddings = last_block_[AES_BLOCKLEN - 1];
+    if (paddings == 0 || paddings > AES_BLOCKLEN) {
+      LOG(ERROR) << "The encrypted stream stored in asar has invalid padding";
+      return false;
+    }
+    begin_ = kBlockOffset - AES_BLOCKLEN;
+    end_ = kBlockOffset - paddings;
+    memcpy(&buffer_[begin_], last_block_, AES_BLOCKLEN);
+    return begin_ != end_;
   }
 
-  // Handle the data in alignment of 16 bytes.
-  uint8_t* in = static_cast<uint8_t*>(buf);
-  uint8_t* out = static_cast<uint8_t*>(buf);
-  remaining_ = nread;
-  while (remaining_ >= AES_BLOCKLEN) {
-    // Fill buffer with 16 bytes and move pointers forward.
-    memcpy(buffer_, in, AES_BLOCKLEN);
-    in += AES_BLOCKLEN;
-    remaining_ -= AES_BLOCKLEN;
-    // Write to output buffer with decrypted data.
-    aes_.CBCDecryptBuffer(buffer_, AES_BLOCKLEN);
-    memcpy(out, buffer_, AES_BLOCKLEN);
-    out += AES_BLOCKLEN;
+  // Decrypt whole blocks in place, and leave the rest to next chunk.
+  size_t blocks_size = size - size % AES_BLOCKLEN;
+  remaining_size_ = size - blocks_size;
+  memcpy(remaining_, data + blocks_size, remaining_size_);
+  if (blocks_size == 0)
+    return true;
+  aes_.CBCDecryptBuffer(data, blocks_size);
+
+  // Release the held back block, and hold back the new last block.
+  if (has_last_block_) {
+    begin_ = kBlockOffset - AES_BLOCKLEN;
+    memcpy(&buffer_[begin_], last_block_, AES_BLOCKLEN);
   }
+  end_ = kBlockOffset + blocks_size - AES_BLOCKLEN;
+  memcpy(last_block_, &buffer_[end_], AES_BLOCKLEN);
+  has_last_block_ = true;
+  return true;
+}
 
-  // Determine the padding when all data has been read.
-  if (content_length_ == 0) {
-    int paddings = buffer_[AES_BLOCKLEN - 1];
-    if (nread < paddings + remaining_)
-      return 0;  // likely a corrupted padding value
-    // We should probably do some verification, but we don't really care when
-    // the encryption is corrupted.
-    nread -= paddings;
+size_t ProtocolAsarJob::ReadCompressed(void* buf, size_t buf_size) {
+  if (inflate_finished_)
+    return 0;
+  if (compressed_.empty())
+    compressed_.resize(kChunkSize);
+
+  zstream_->next_out = static_cast<Bytef*>(buf);
+  zstream_->avail_out = static_cast<uInt>(buf_size);
+  while (zstream_->avail_out > 0) {
+    // Read more data when previous data has been consumed.
+    if (zstream_->avail_in == 0) {
+      size_t nread = ReadStored(compressed_.data(), compressed_.size());
+      if (nread == 0) {
+        LOG(ERROR) << "The compressed stream stored in asar is truncated";
+        inflate_finished_ = true;
+        break;
+      }
+      zstream_->next_in = compressed_.data();
+      zstream_->avail_in = static_cast<uInt>(nread);
+    }
+    int ret = inflate(zstream_.get(), Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      inflate_finished_ = true;
+      break;
+    }
+    if (ret != Z_OK) {
+      LOG(ERROR) << "Failed to decompress the stream stored in asar: " << ret;
+      inflate_finished_ = true;
+      break;
+    }
   }
-
-  // Still have some data left, leave it to the next read.
-  DCHECK(remaining_ < AES_BLOCKLEN);
-  memcpy(buffer_, in, remaining_);
-
-  // Return the bytes we decrypted.
-  // FIXME(zcbenz): The stream would end when we can not get 16 bytes in one
-  // read, we should probably improve our API to fix this.
-  return nread - remaining_;
+  return buf_size - zstream_->avail_out;
 }
 
 }  // namespace nu
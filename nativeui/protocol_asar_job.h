@@ -5,11 +5,16 @@
 #ifndef NATIVEUI_PROTOCOL_ASAR_JOB_H_
 #define NATIVEUI_PROTOCOL_ASAR_JOB_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "nativeui/asar_archive.h"
 #include "nativeui/protocol_file_job.h"
 #include "nativeui/util/aes.h"
 
+struct z_stream_s;
+
 namespace nu {
 
 class AES;
@@ -26,12 +31,43 @@ class NATIVEUI_EXPORT ProtocolAsarJob : public ProtocolFileJob {
   // ProtocolJob:
   bool Start() override;
   size_t Read(void* buf, size_t buf_size) override;
+  scoped_refptr<base::RefCountedMemory> GetMappedContent() override;
+  bool CanSeek() const override;
+  bool Seek(int64_t offset) override;
+
+  scoped_refptr<AsarArchive> archive_;
+  AsarArchive::FileInfo info_;
 
   AES aes_;
 
-  // Buffer used to store remaining encrypted data.
-  uint8_t buffer_[AES_BLOCKLEN];
-  size_t remaining_ = 0;
+ private:
+  // Read the data stored in archive, decrypting it when needed.
+  size_t ReadStored(void* buf, size_t buf_size);
+  // Read and decrypt next chunk of file into |buffer_|, return false when
+  // there is no more data.
+  bool DecryptChunk();
+  // Read and decompress the stored data.
+  size_t ReadCompressed(void* buf, size_t buf_size);
+
+  // The decrypted data waiting to be read is |buffer_[begin_, end_)|, the
+  // space before |kBlockOffset| holds the last block of previous chunk.
+  std::vector<uint8_t> buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+  // The encrypted data not aligned to blocks, left to next chunk.
+  uint8_t remaining_[AES_BLOCKLEN];
+  size_t remaining_size_ = 0;
+  // The last decrypted block, which is held back until the end of file is
+  // reached, since it contains the padding.
+  uint8_t last_block_[AES_BLOCKLEN];
+  bool has_last_block_ = false;
+  bool finished_ = false;
+
+  // The state of decompression, the stored data waiting to be decompressed is
+  // kept in |compressed_|.
+  std::unique_ptr<z_stream_s> zstream_;
+  std::vector<uint8_t> compressed_;
+  bool inflate_finished_ = false;
 };
 
 }  // namespace nu
@@ -5,8 +5,14 @@
 
 #include "nativeui/protocol_file_job.h"
 
+#include <memory>
+#include <utility>
+
+#include "base/files/memory_mapped_file.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "nativeui/message_loop.h"
+#include "nativeui/util/worker_pool.h"
 
 namespace nu {
 
@@ -148,12 +154,31 @@ bool GetMimeTypeFromExtension(const base::FilePath::StringType& ext,
   return false;
 }
 
+// Keeps a mapped file alive while its content is being used.
+class MappedFileMemory : public base::RefCountedMemory {
+ public:
+  explicit MappedFileMemory(std::unique_ptr<base::MemoryMappedFile> file)
+      : file_(std::move(file)) {}
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override { return file_->data(); }
+  size_t size() const override { return file_->length(); }
+
+ private:
+  ~MappedFileMemory() override {}
+
+  std::unique_ptr<base::MemoryMappedFile> file_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedFileMemory);
+};
+
 }  // namespace
 
 ProtocolFileJob::ProtocolFileJob(const base::FilePath& path)
     : path_(path),
       file_(path, base::File::FLAG_OPEN | base::File::FLAG_READ),
-      content_length_(file_.IsValid() ? file_.GetLength() : 0) {
+      content_length_(file_.IsValid() ? file_.GetLength() : 0),
+      content_size_(content_length_) {
 }
 
 ProtocolFileJob::~ProtocolFileJob() {
@@ -167,7 +192,9 @@ bool ProtocolFileJob::Start() {
 }
 
 void ProtocolFileJob::Kill() {
-  file_.Close();
+  killed_ = true;
+  if (!reading_)
+    file_.Close();
 }
 
 bool ProtocolFileJob::GetMimeType(std::string* mime_type) {
@@ -193,4 +220,55 @@ size_t ProtocolFileJob::Read(void* buf, size_t buf_size) {
   }
 }
 
+scoped_refptr<base::RefCountedMemory> ProtocolFileJob::GetMappedContent() {
+  // Empty files can not be mapped.
+  if (!file_.IsValid() || content_length_ == 0)
+    return nullptr;
+  auto mapped = std::make_unique<base::MemoryMappedFile>();
+  if (!mapped->Initialize(file_.Duplicate()))
+    return nullptr;
+  return new MappedFileMemory(std::move(mapped));
+}
+
+bool ProtocolFileJob::CanSeek() const {
+  return file_.IsValid();
+}
+
+bool ProtocolFileJob::Seek(int64_t offset) {
+  // The file is being read in worker thread.
+  if (reading_ || !CanSeek() || offset < 0 || offset > content_size_)
+    return false;
+  if (file_.Seek(base::File::FROM_BEGIN, content_offset_ + offset) == -1)
+    return false;
+  content_length_ = content_size_ - offset;
+  return true;
+}
+
+void ProtocolFileJob::ReadAsync(void* buf, size_t buf_size,
+                                ReadCallback callback) {
+  if (killed_) {
+    callback(0);
+    return;
+  }
+  DCHECK(!reading_);
+  reading_ = true;
+  // The job is not thread-safe refcounted, hold the reference in heap and
+  // release it on main thread.
+  auto* self = new scoped_refptr<ProtocolFileJob>(this);
+  WorkerPool::PostTask([self, buf, buf_size, callback]() {
+    size_t nread = (*self)->Read(buf, buf_size);
+    MessageLoop::PostTask([self, nread, callback]() {
+      std::unique_ptr<scoped_refptr<ProtocolFileJob>> holder(self);
+      ProtocolFileJob* job = holder->get();
+      job->reading_ = false;
+      if (job->killed_) {
+        job->file_.Close();
+        callback(0);
+        return;
+      }
+      callback(nread);
+    });
+  });
+}
+
 }  // namespace nu
@@ -23,13 +23,28 @@ class NATIVEUI_EXPORT ProtocolFileJob : public ProtocolJob {
   void Kill() override;
   bool GetMimeType(std::string* mime_type) override;
   size_t Read(void* buf, size_t buf_size) override;
+  // Read file in worker thread.
+  void ReadAsync(void* buf, size_t buf_size, ReadCallback callback) override;
+  // Map the file into memory.
+  scoped_refptr<base::RefCountedMemory> GetMappedContent() override;
+  bool CanSeek() const override;
+  bool Seek(int64_t offset) override;
 
  protected:
   ~ProtocolFileJob() override;
 
   base::FilePath path_;
   base::File file_;
+  // The size of content left to read.
   int64_t content_length_ = 0;
+  // Where the content starts in file, and the size of whole content.
+  int64_t content_offset_ = 0;
+  int64_t content_size_ = 0;
+
+ private:
+  // The file can not be closed while being read in worker thread.
+  bool reading_ = false;
+  bool killed_ = false;
 };
 
 }  // namespace nu
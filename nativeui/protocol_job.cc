@@ -9,6 +9,10 @@
 #include <algorithm>
 #include <utility>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "nativeui/message_loop.h"
+
 namespace nu {
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -28,10 +32,64 @@ bool ProtocolJob::Start() {
 void ProtocolJob::Kill() {
 }
 
-void ProtocolJob::Plug(std::function<void(int)> func) {
+void ProtocolJob::ReadAsync(void* buf, size_t buf_size,
+                            ReadCallback callback) {
+  callback(Read(buf, buf_size));
+}
+
+scoped_refptr<base::RefCountedMemory> ProtocolJob::GetMappedContent() {
+  return nullptr;
+}
+
+bool ProtocolJob::CanSeek() const {
+  return false;
+}
+
+bool ProtocolJob::Seek(int64_t offset) {
+  return false;
+}
+
+void ProtocolJob::Plug(std::function<void(int64_t)> func) {
   notify_content_length = std::move(func);
 }
 
+// static
+bool ProtocolJob::ParseRange(const std::string& header, int64_t size,
+                             int64_t* start, int64_t* end) {
+  // Parse "bytes=first-last", "bytes=first-" and "bytes=-suffix".
+  base::StringPiece value(header);
+  if (size <= 0 || !value.starts_with("bytes="))
+    return false;
+  value.remove_prefix(6);
+  size_t dash = value.find('-');
+  if (dash == base::StringPiece::npos ||
+      value.find(',') != base::StringPiece::npos)
+    return false;
+  base::StringPiece first = base::TrimWhitespaceASCII(value.substr(0, dash),
+                                                      base::TRIM_ALL);
+  base::StringPiece last = base::TrimWhitespaceASCII(value.substr(dash + 1),
+                                                     base::TRIM_ALL);
+  int64_t first_pos = -1, last_pos = -1;
+  if (!first.empty() && !base::StringToInt64(first, &first_pos))
+    return false;
+  if (!last.empty() && !base::StringToInt64(last, &last_pos))
+    return false;
+  if (first.empty()) {
+    // Suffix range.
+    if (last_pos <= 0)
+      return false;
+    *start = std::max<int64_t>(0, size - last_pos);
+    *end = size;
+    return true;
+  }
+  if (first_pos < 0 || first_pos >= size ||
+      (!last.empty() && last_pos < first_pos))
+    return false;
+  *start = first_pos;
+  *end = last.empty() ? size : std::min(last_pos + 1, size);
+  return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // ProtocolStringJob implementation.
 
@@ -45,7 +103,7 @@ ProtocolStringJob::~ProtocolStringJob() {
 }
 
 bool ProtocolStringJob::Start() {
-  notify_content_length(static_cast<int>(content_.size()));
+  notify_content_length(static_cast<int64_t>(content_.size()));
   return true;
 }
 
@@ -63,4 +121,121 @@ size_t ProtocolStringJob::Read(void* buf, size_t buf_size) {
   return nread;
 }
 
+bool ProtocolStringJob::CanSeek() const {
+  return true;
+}
+
+bool ProtocolStringJob::Seek(int64_t offset) {
+  if (offset < 0 || offset > static_cast<int64_t>(content_.size()))
+    return false;
+  pos_ = static_cast<size_t>(offset);
+  return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ProtocolStreamJob implementation.
+
+ProtocolStreamJob::ProtocolStreamJob(const std::string& mime_type)
+    : mime_type_(mime_type),
+      creator_thread_(std::this_thread::get_id()),
+      data_available_(&lock_) {
+}
+
+ProtocolStreamJob::~ProtocolStreamJob() {
+}
+
+void ProtocolStreamJob::Write(const std::string& data) {
+  {
+    base::AutoLock auto_lock(lock_);
+    if (finished_)
+      return;
+    buffer_.append(data);
+    data_available_.Signal();
+  }
+  MaybeFinishPendingRead();
+}
+
+void ProtocolStreamJob::Finish() {
+  {
+    base::AutoLock auto_lock(lock_);
+    finished_ = true;
+    data_available_.Signal();
+  }
+  MaybeFinishPendingRead();
+}
+
+bool ProtocolStreamJob::Start() {
+  notify_content_length(-1);
+  return true;
+}
+
+void ProtocolStreamJob::Kill() {
+  {
+    base::AutoLock auto_lock(lock_);
+    buffer_.clear();
+    pos_ = 0;
+  }
+  Finish();
+}
+
+bool ProtocolStreamJob::GetMimeType(std::string* mime_type) {
+  *mime_type = mime_type_;
+  return true;
+}
+
+size_t ProtocolStreamJob::Read(void* buf, size_t buf_size) {
+  base::AutoLock auto_lock(lock_);
+  if (std::this_thread::get_id() != creator_thread_) {
+    while (pos_ == buffer_.size() && !finished_)
+      data_available_.Wait();
+  }
+  return ReadBuffered(buf, buf_size);
+}
+
+void ProtocolStreamJob::ReadAsync(void* buf, size_t buf_size,
+                                  ReadCallback callback) {
+  {
+    base::AutoLock auto_lock(lock_);
+    DCHECK(!pending_callback_);
+    pending_buf_ = buf;
+    pending_buf_size_ = buf_size;
+    pending_callback_ = std::move(callback);
+  }
+  MaybeFinishPendingRead();
+}
+
+size_t ProtocolStreamJob::ReadBuffered(void* buf, size_t buf_size) {
+  size_t nread = std::min(buf_size, buffer_.size() - pos_);
+  memcpy(buf, buffer_.data() + pos_, nread);
+  pos_ += nread;
+  // Drop consumed data.
+  if (pos_ == buffer_.size()) {
+    buffer_.clear();
+    pos_ = 0;
+  }
+  return nread;
+}
+
+void ProtocolStreamJob::MaybeFinishPendingRead() {
+  ReadCallback callback;
+  size_t nread = 0;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (!pending_callback_ || (pos_ == buffer_.size() && !finished_))
+      return;
+    nread = ReadBuffered(pending_buf_, pending_buf_size_);
+    callback = std::move(pending_callback_);
+    pending_callback_ = nullptr;
+    pending_buf_ = nullptr;
+  }
+  // The callback must be called on main thread.
+  if (std::this_thread::get_id() == creator_thread_) {
+    callback(nread);
+  } else {
+    MessageLoop::PostTask([callback, nread]() {
+      callback(nread);
+    });
+  }
+}
+
 }  // namespace nu
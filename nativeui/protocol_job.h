@@ -7,9 +7,13 @@
 
 #include <functional>
 #include <string>
+#include <thread>
 
 #include "base/debug/leak_tracker.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "nativeui/nativeui_export.h"
 
 namespace nu {
@@ -17,14 +21,46 @@ namespace nu {
 // A simple class used by Browser to serve custom protocol requests.
 class NATIVEUI_EXPORT ProtocolJob : public base::RefCounted<ProtocolJob> {
  public:
+  // Called with the size of data read, 0 means there is no more data.
+  using ReadCallback = std::function<void(size_t)>;
+
   // Subclasses should implement this.
   virtual bool Start();
   virtual void Kill();
   virtual bool GetMimeType(std::string* mime_type) = 0;
   virtual size_t Read(void* buf, size_t buf_size) = 0;
 
+  // Read data without blocking the calling thread, the |callback| is called on
+  // main thread and |buf| must be kept alive until then. Only one read can be
+  // pending at a time.
+  //
+  // The default implementation calls Read directly, subclasses doing blocking
+  // work should override it.
+  virtual void ReadAsync(void* buf, size_t buf_size, ReadCallback callback);
+
+  // Return the whole response if it is already in memory, so browsers can use
+  // it directly instead of calling Read. This is called before the job is
+  // started, and the returned memory can be released on any thread.
+  //
+  // The default implementation returns nullptr.
+  virtual scoped_refptr<base::RefCountedMemory> GetMappedContent();
+
+  // Whether the job supports seeking, which allows browsers to serve range
+  // requests without reading from the start.
+  //
+  // The default implementation returns false.
+  virtual bool CanSeek() const;
+  // Move the position of next Read to |offset| bytes from the start of
+  // content, return false if the position can not be changed.
+  virtual bool Seek(int64_t offset);
+
   // Internal: Used by Browser implementations to plug adapters.
-  void Plug(std::function<void(int)> start);
+  void Plug(std::function<void(int64_t)> start);
+
+  // Internal: Parse the value of HTTP Range header for content of |size|, the
+  // range is returned as [|start|, |end|). Only single range is supported.
+  static bool ParseRange(const std::string& header, int64_t size,
+                         int64_t* start, int64_t* end);
 
  protected:
   friend class base::RefCounted<ProtocolJob>;
@@ -33,7 +69,7 @@ class NATIVEUI_EXPORT ProtocolJob : public base::RefCounted<ProtocolJob> {
   virtual ~ProtocolJob();
 
   // Used by subclasses to notify the browser.
-  std::function<void(int)> notify_content_length;
+  std::function<void(int64_t)> notify_content_length;
 
   base::debug::LeakTracker<ProtocolJob> leak_tracker_;
 };
@@ -46,6 +82,8 @@ class NATIVEUI_EXPORT ProtocolStringJob : public ProtocolJob {
   bool Start() override;
   bool GetMimeType(std::string* mime_type) override;
   size_t Read(void* buf, size_t buf_size) override;
+  bool CanSeek() const override;
+  bool Seek(int64_t offset) override;
 
  protected:
   ~ProtocolStringJob() override;
@@ -56,6 +94,50 @@ class NATIVEUI_EXPORT ProtocolStringJob : public ProtocolJob {
   size_t pos_ = 0;
 };
 
+// Use data written later as response, which allows producing the data
+// asynchronously.
+class NATIVEUI_EXPORT ProtocolStreamJob : public ProtocolJob {
+ public:
+  explicit ProtocolStreamJob(const std::string& mime_type);
+
+  // Append |data| to the response, can be called from any thread.
+  void Write(const std::string& data);
+  // Mark the end of response, can be called from any thread.
+  void Finish();
+
+  // ProtocolJob:
+  bool Start() override;
+  void Kill() override;
+  bool GetMimeType(std::string* mime_type) override;
+  size_t Read(void* buf, size_t buf_size) override;
+  void ReadAsync(void* buf, size_t buf_size, ReadCallback callback) override;
+
+ protected:
+  ~ProtocolStreamJob() override;
+
+ private:
+  // Copy buffered data to |buf|, must be called with lock held.
+  size_t ReadBuffered(void* buf, size_t buf_size);
+  // Finish the pending ReadAsync if there is data or stream has ended.
+  void MaybeFinishPendingRead();
+
+  std::string mime_type_;
+  // Read does not wait for data on the thread creating the job, which is
+  // where the data is usually written.
+  std::thread::id creator_thread_;
+
+  base::Lock lock_;
+  base::ConditionVariable data_available_;
+  std::string buffer_;
+  size_t pos_ = 0;
+  bool finished_ = false;
+
+  // The pending ReadAsync call.
+  void* pending_buf_ = nullptr;
+  size_t pending_buf_size_ = 0;
+  ReadCallback pending_callback_;
+};
+
 }  // namespace nu
 
 #endif  // NATIVEUI_PROTOCOL_JOB_H_
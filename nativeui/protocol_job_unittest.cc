@@ -0,0 +1,235 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include <thread>
+
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/pickle.h"
+#include "nativeui/nativeui.h"
+#include "nativeui/util/aes.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/zlib.h"
+
+class ProtocolJobTest : public testing::Test {
+ protected:
+  // Write an asar archive with a.js file, whose |info| are properties other
+  // than offset in header.
+  base::FilePath WriteAsar(const std::string& info, const std::string& data) {
+    EXPECT_TRUE(dir_.IsValid() || dir_.CreateUniqueTempDir());
+    base::Pickle header;
+    header.WriteString("{\"files\":{\"a.js\":{\"offset\":\"0\"," + info +
+                       "}}}");
+    base::Pickle size;
+    size.WriteUInt32(static_cast<uint32_t>(header.size()));
+    std::string content(static_cast<const char*>(size.data()), size.size());
+    content.append(static_cast<const char*>(header.data()), header.size());
+    content.append(data);
+    base::FilePath path = dir_.GetPath().AppendASCII("app.asar");
+    EXPECT_TRUE(base::WriteFile(path, content.data(), content.size()));
+    return path;
+  }
+
+  // Read all content of |job| in small reads.
+  std::string ReadAll(nu::ProtocolJob* job) {
+    std::string result;
+    char buf[7];
+    size_t nread;
+    while ((nread = job->Read(buf, sizeof(buf))) > 0)
+      result.append(buf, nread);
+    return result;
+  }
+
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  base::ScopedTempDir dir_;
+};
+
+TEST_F(ProtocolJobTest, StreamJobReadAsync) {
+  scoped_refptr<nu::ProtocolStreamJob> job =
+      new nu::ProtocolStreamJob("text/plain");
+  char buf[16];
+  size_t result = 0;
+  bool called = false;
+  job->ReadAsync(buf, sizeof(buf), [&](size_t nread) {
+    called = true;
+    result = nread;
+  });
+  EXPECT_FALSE(called);
+  job->Write("data");
+  EXPECT_TRUE(called);
+  EXPECT_EQ(result, 4u);
+  EXPECT_EQ(std::string(buf, result), "data");
+
+  called = false;
+  job->Finish();
+  job->ReadAsync(buf, sizeof(buf), [&](size_t nread) {
+    called = true;
+    result = nread;
+  });
+  EXPECT_TRUE(called);
+  EXPECT_EQ(result, 0u);
+}
+
+TEST_F(ProtocolJobTest, StreamJobWriteFromThread) {
+  scoped_refptr<nu::ProtocolStreamJob> job =
+      new nu::ProtocolStreamJob("text/plain");
+  char buf[16];
+  size_t result = 0;
+  job->ReadAsync(buf, sizeof(buf), [&](size_t nread) {
+    result = nread;
+    nu::MessageLoop::Quit();
+  });
+  nu::ProtocolStreamJob* ptr = job.get();
+  std::thread thread([ptr]() { ptr->Write("thread"); });
+  nu::MessageLoop::Run();
+  thread.join();
+  EXPECT_EQ(std::string(buf, result), "thread");
+}
+
+TEST_F(ProtocolJobTest, FileJobReadAsync) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath path = dir.GetPath().AppendASCII("data.txt");
+  std::string content(1000, 'a');
+  ASSERT_TRUE(base::WriteFile(path, content.data(), content.size()));
+
+  scoped_refptr<nu::ProtocolFileJob> job = new nu::ProtocolFileJob(path);
+  job->Plug([](int64_t) {});
+  ASSERT_TRUE(job->Start());
+  std::string data;
+  char buf[300];
+  std::function<void(size_t)> on_read = [&](size_t nread) {
+    if (nread == 0) {
+      nu::MessageLoop::Quit();
+      return;
+    }
+    data.append(buf, nread);
+    job->ReadAsync(buf, sizeof(buf), on_read);
+  };
+  job->ReadAsync(buf, sizeof(buf), on_read);
+  nu::MessageLoop::Run();
+  EXPECT_EQ(data, content);
+}
+
+TEST_F(ProtocolJobTest, FileJobMappedContent) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath path = dir.GetPath().AppendASCII("data.txt");
+  std::string content = "mapped content";
+  ASSERT_TRUE(base::WriteFile(path, content.data(), content.size()));
+
+  scoped_refptr<nu::ProtocolFileJob> job = new nu::ProtocolFileJob(path);
+  scoped_refptr<base::RefCountedMemory> memory = job->GetMappedContent();
+  ASSERT_TRUE(memory);
+  EXPECT_EQ(std::string(memory->front_as<char>(), memory->size()), content);
+}
+
+TEST_F(ProtocolJobTest, AsarJobDecrypt) {
+  std::string key(32, 'k');
+  std::string iv(AES_BLOCKLEN, 'i');
+  std::string content;
+  for (int i = 0; i < 1000; ++i)
+    content.push_back(static_cast<char>(i));
+  // Encrypt with PKCS#7 padding.
+  size_t paddings = AES_BLOCKLEN - content.size() % AES_BLOCKLEN;
+  std::string encrypted =
+      content + std::string(paddings, static_cast<char>(paddings));
+  nu::AES aes;
+  ASSERT_TRUE(aes.Init(key, iv));
+  aes.CBCEncryptBuffer(reinterpret_cast<uint8_t*>(&encrypted[0]),
+                       encrypted.size());
+
+  base::FilePath path = WriteAsar(
+      "\"size\":" + std::to_string(encrypted.size()), encrypted);
+
+  // Reads smaller than a block should work.
+  scoped_refptr<nu::ProtocolAsarJob> job =
+      new nu::ProtocolAsarJob(path, "a.js");
+  ASSERT_TRUE(job->SetDecipher(key, iv));
+  nu::ProtocolJob* base_job = job.get();
+  EXPECT_FALSE(base_job->GetMappedContent());
+  base_job->Plug([](int64_t) {});
+  ASSERT_TRUE(base_job->Start());
+  EXPECT_EQ(ReadAll(base_job), content);
+}
+
+TEST_F(ProtocolJobTest, AsarJobDecompress) {
+  std::string content(10000, 'c');
+  uLongf compressed_size = compressBound(content.size());
+  std::string compressed(compressed_size, '\0');
+  ASSERT_EQ(compress(reinterpret_cast<Bytef*>(&compressed[0]),
+                     &compressed_size,
+                     reinterpret_cast<const Bytef*>(content.data()),
+                     content.size()),
+            Z_OK);
+  compressed.resize(compressed_size);
+  base::FilePath path = WriteAsar(
+      "\"size\":" + std::to_string(content.size()) +
+      ",\"compressedSize\":" + std::to_string(compressed.size()) +
+      ",\"compression\":\"zlib\"",
+      compressed);
+
+  scoped_refptr<nu::ProtocolAsarJob> job =
+      new nu::ProtocolAsarJob(path, "a.js");
+  nu::ProtocolJob* base_job = job.get();
+  EXPECT_FALSE(base_job->GetMappedContent());
+  int64_t content_length = 0;
+  base_job->Plug([&](int64_t size) { content_length = size; });
+  ASSERT_TRUE(base_job->Start());
+  EXPECT_EQ(content_length, static_cast<int64_t>(content.size()));
+  EXPECT_EQ(ReadAll(base_job), content);
+}
+
+TEST_F(ProtocolJobTest, ParseRange) {
+  int64_t start, end;
+  EXPECT_TRUE(nu::ProtocolJob::ParseRange("bytes=0-99", 1000, &start, &end));
+  EXPECT_EQ(start, 0);
+  EXPECT_EQ(end, 100);
+  EXPECT_TRUE(nu::ProtocolJob::ParseRange("bytes=900-", 1000, &start, &end));
+  EXPECT_EQ(start, 900);
+  EXPECT_EQ(end, 1000);
+  EXPECT_TRUE(nu::ProtocolJob::ParseRange("bytes=-100", 1000, &start, &end));
+  EXPECT_EQ(start, 900);
+  EXPECT_EQ(end, 1000);
+  EXPECT_TRUE(nu::ProtocolJob::ParseRange("bytes=10-5000", 1000, &start, &end));
+  EXPECT_EQ(end, 1000);
+  EXPECT_FALSE(nu::ProtocolJob::ParseRange("bytes=1000-", 1000, &start, &end));
+  EXPECT_FALSE(nu::ProtocolJob::ParseRange("bytes=5-1", 1000, &start, &end));
+  EXPECT_FALSE(nu::ProtocolJob::ParseRange("bytes=0-1,5-6", 1000, &start,
+                                           &end));
+  EXPECT_FALSE(nu::ProtocolJob::ParseRange("items=0-1", 1000, &start, &end));
+  EXPECT_FALSE(nu::ProtocolJob::ParseRange("bytes=0-1", -1, &start, &end));
+}
+
+TEST_F(ProtocolJobTest, FileJobSeek) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath path = dir.GetPath().AppendASCII("data.txt");
+  std::string content = "0123456789";
+  ASSERT_TRUE(base::WriteFile(path, content.data(), content.size()));
+
+  scoped_refptr<nu::ProtocolFileJob> job = new nu::ProtocolFileJob(path);
+  job->Plug([](int64_t) {});
+  ASSERT_TRUE(job->Start());
+  ASSERT_TRUE(job->CanSeek());
+  ASSERT_TRUE(job->Seek(7));
+  EXPECT_EQ(ReadAll(job.get()), "789");
+  ASSERT_TRUE(job->Seek(2));
+  EXPECT_EQ(ReadAll(job.get()), "23456789");
+  EXPECT_FALSE(job->Seek(11));
+}
+
+TEST_F(ProtocolJobTest, AsarJobSeek) {
+  base::FilePath path = WriteAsar("\"size\":4", "abcdXXXX");
+  scoped_refptr<nu::ProtocolAsarJob> job =
+      new nu::ProtocolAsarJob(path, "a.js");
+  nu::ProtocolJob* base_job = job.get();
+  base_job->Plug([](int64_t) {});
+  ASSERT_TRUE(base_job->Start());
+  ASSERT_TRUE(base_job->CanSeek());
+  ASSERT_TRUE(base_job->Seek(1));
+  EXPECT_EQ(ReadAll(base_job), "bcd");
+  EXPECT_FALSE(base_job->Seek(5));
+}
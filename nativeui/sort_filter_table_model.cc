@@ -0,0 +1,428 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/sort_filter_table_model.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include "nativeui/message_loop.h"
+
+namespace nu {
+
+namespace {
+
+// Models smaller than this are sorted on the calling thread.
+const size_t kMinRowsForBackgroundSort = 10000;
+
+// A copy of the value to sort by, and the source row it belongs to.
+using SortKey = std::pair<base::Value, uint32_t>;
+
+// Values of different types are ordered by their types.
+int GetTypeOrder(const base::Value& value) {
+  if (value.is_none())
+    return 0;
+  if (value.is_bool())
+    return 1;
+  if (value.is_int() || value.is_double())
+    return 2;
+  if (value.is_string())
+    return 3;
+  return 4;
+}
+
+int CompareValues(const base::Value& a, const base::Value& b) {
+  int type_a = GetTypeOrder(a);
+  int type_b = GetTypeOrder(b);
+  if (type_a != type_b)
+    return type_a < type_b ? -1 : 1;
+  if (a.is_bool())
+    return static_cast<int>(a.GetBool()) - static_cast<int>(b.GetBool());
+  if (a.is_int() && b.is_int())
+    return a.GetInt() < b.GetInt() ? -1 : (a.GetInt() > b.GetInt() ? 1 : 0);
+  if (type_a == 2) {
+    double x = a.GetDouble();
+    double y = b.GetDouble();
+    return x < y ? -1 : (x > y ? 1 : 0);
+  }
+  if (a.is_string())
+    return a.GetString().compare(b.GetString());
+  return 0;
+}
+
+// Rows with equal values keep the order of source.
+bool IsKeyLess(const SortKey& a, const SortKey& b, bool ascending) {
+  int result = CompareValues(a.first, b.first);
+  if (result != 0)
+    return ascending ? result < 0 : result > 0;
+  return a.second < b.second;
+}
+
+// Runs on worker thread for large models.
+std::vector<uint32_t> SortKeys(std::vector<SortKey> keys, bool ascending) {
+  std::sort(keys.begin(), keys.end(),
+            [ascending](const SortKey& a, const SortKey& b) {
+              return IsKeyLess(a, b, ascending);
+            });
+  std::vector<uint32_t> rows;
+  rows.reserve(keys.size());
+  for (const SortKey& key : keys)
+    rows.push_back(key.second);
+  return rows;
+}
+
+SortKey GetSortKey(TableModel* source, int column, uint32_t row) {
+  // The value must be copied since the reference returned by GetValue is
+  // temporary.
+  const base::Value* value = source->GetValue(column, row);
+  return SortKey(value ? value->Clone() : base::Value(), row);
+}
+
+// Models are not thread-safe, so values are copied before sorting.
+std::vector<SortKey> GetSortKeys(TableModel* source,
+                                 int column,
+                                 const std::vector<uint32_t>& rows) {
+  std::vector<SortKey> keys;
+  keys.reserve(rows.size());
+  for (uint32_t row : rows)
+    keys.push_back(GetSortKey(source, column, row));
+  return keys;
+}
+
+}  // namespace
+
+SortFilterTableModel::SortFilterTableModel(TableModel* source)
+    : source_(source) {
+  source_->AddObserver(this);
+  uint32_t count = source_->GetRowCount();
+  rows_.reserve(count);
+  for (uint32_t row = 0; row < count; ++row)
+    rows_.push_back(row);
+}
+
+SortFilterTableModel::~SortFilterTableModel() {
+  source_->RemoveObserver(this);
+}
+
+TableModel* SortFilterTableModel::GetSource() const {
+  return source_.get();
+}
+
+void SortFilterTableModel::SortByColumn(int column, bool ascending) {
+  sort_column_ = column;
+  ascending_ = ascending;
+  if (column < 0) {
+    // Cancel running sort.
+    sorting_ = false;
+    ++sort_job_;
+    std::sort(rows_.begin(), rows_.end());
+    NotifyReset();
+  } else if (rows_.size() >= kMinRowsForBackgroundSort) {
+    // Current rows are kept until the sort is done.
+    StartBackgroundSort();
+  } else {
+    Resort();
+  }
+}
+
+int SortFilterTableModel::GetSortColumn() const {
+  return sort_column_;
+}
+
+bool SortFilterTableModel::IsSortAscending() const {
+  return ascending_;
+}
+
+bool SortFilterTableModel::IsSorting() const {
+  return sorting_;
+}
+
+void SortFilterTableModel::SetFilter(Filter filter) {
+  filter_ = std::move(filter);
+  Refresh();
+}
+
+int SortFilterTableModel::MapToSource(uint32_t row) const {
+  if (row >= rows_.size())
+    return -1;
+  return static_cast<int>(rows_[row]);
+}
+
+int SortFilterTableModel::MapFromSource(uint32_t row) const {
+  auto it = std::find(rows_.begin(), rows_.end(), row);
+  if (it == rows_.end())
+    return -1;
+  return static_cast<int>(it - rows_.begin());
+}
+
+uint32_t SortFilterTableModel::GetRowCount() const {
+  return static_cast<uint32_t>(rows_.size());
+}
+
+const base::Value* SortFilterTableModel::GetValue(uint32_t column,
+                                                  uint32_t row) const {
+  if (row >= rows_.size())
+    return nullptr;
+  return source_->GetValue(column, rows_[row]);
+}
+
+void SortFilterTableModel::SetValue(uint32_t column, uint32_t row,
+                                    base::Value value) {
+  // The change comes back from the source's notification.
+  if (row < rows_.size())
+    source_->SetValue(column, rows_[row], std::move(value));
+}
+
+void SortFilterTableModel::OnModelRowsInserted(TableModel* model,
+                                               uint32_t start,
+                                               uint32_t count) {
+  ++version_;
+  for (uint32_t& row : rows_) {
+    if (row >= start)
+      row += count;
+  }
+  std::vector<uint32_t> added;
+  for (uint32_t row = start; row < start + count; ++row) {
+    if (Accepts(row))
+      added.push_back(row);
+  }
+  if (added.empty())
+    return;
+
+  if (sort_column_ < 0 || sorting_) {
+    // Unsorted rows follow the order of source. When sorting, the new rows
+    // are appended and the sort restarts after current one finishes.
+    uint32_t index = static_cast<uint32_t>(
+        sorting_ ? rows_.size()
+                 : std::lower_bound(rows_.begin(), rows_.end(), start) -
+                   rows_.begin());
+    rows_.insert(rows_.begin() + index, added.begin(), added.end());
+    NotifyRowsInserted(index, static_cast<uint32_t>(added.size()));
+  } else if (added.size() == 1) {
+    uint32_t index = FindInsertPosition(added[0]);
+    rows_.insert(rows_.begin() + index, added[0]);
+    NotifyRowInsertion(index);
+  } else {
+    rows_.insert(rows_.end(), added.begin(), added.end());
+    Resort();
+  }
+}
+
+void SortFilterTableModel::OnModelRowsDeleted(TableModel* model,
+                                              uint32_t start,
+                                              uint32_t count) {
+  ++version_;
+  std::vector<uint32_t> rows;
+  rows.reserve(rows_.size());
+  uint32_t first = 0;
+  uint32_t removed = 0;
+  bool is_contiguous = true;
+  for (uint32_t i = 0; i < rows_.size(); ++i) {
+    uint32_t row = rows_[i];
+    if (row >= start && row < start + count) {
+      if (removed == 0)
+        first = i;
+      else if (i != first + removed)
+        is_contiguous = false;
+      ++removed;
+    } else {
+      rows.push_back(row >= start + count ? row - count : row);
+    }
+  }
+  rows_ = std::move(rows);
+  if (removed == 0)
+    return;
+  if (is_contiguous)
+    NotifyRowsDeleted(first, removed);
+  else
+    NotifyReset();
+}
+
+void SortFilterTableModel::OnModelRowsChanged(TableModel* model,
+                                              uint32_t start,
+                                              uint32_t count) {
+  ++version_;
+  // Only the changed rows need to be filtered again.
+  std::vector<bool> accepted(count);
+  for (uint32_t i = 0; i < count; ++i)
+    accepted[i] = Accepts(start + i);
+  std::vector<bool> present(count, false);
+  std::vector<uint32_t> positions;
+  for (uint32_t i = 0; i < rows_.size(); ++i) {
+    if (rows_[i] >= start && rows_[i] < start + count) {
+      present[rows_[i] - start] = true;
+      positions.push_back(i);
+    }
+  }
+  uint32_t changed = 0;
+  uint32_t changed_row = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    if (accepted[i] != present[i]) {
+      ++changed;
+      changed_row = start + i;
+    }
+  }
+
+  if (changed == 0) {
+    if (positions.empty())
+      return;
+    if (sort_column_ >= 0 && !sorting_) {
+      for (uint32_t position : positions) {
+        if (!IsInOrder(position)) {
+          Resort();
+          return;
+        }
+      }
+    }
+    NotifyRowsChanged(positions.front(),
+                      positions.back() - positions.front() + 1);
+    return;
+  }
+
+  if (count == 1) {
+    if (present[0]) {
+      int index = MapFromSource(changed_row);
+      rows_.erase(rows_.begin() + index);
+      NotifyRowDeletion(index);
+    } else {
+      uint32_t index;
+      if (sorting_)
+        index = static_cast<uint32_t>(rows_.size());
+      else if (sort_column_ < 0)
+        index = static_cast<uint32_t>(
+            std::lower_bound(rows_.begin(), rows_.end(), changed_row) -
+            rows_.begin());
+      else
+        index = FindInsertPosition(changed_row);
+      rows_.insert(rows_.begin() + index, changed_row);
+      NotifyRowInsertion(index);
+    }
+    return;
+  }
+
+  // Rebuild rows when there are many changes.
+  rows_.erase(std::remove_if(rows_.begin(), rows_.end(),
+                             [&](uint32_t row) {
+                               return row >= start && row < start + count &&
+                                      !accepted[row - start];
+                             }),
+              rows_.end());
+  for (uint32_t i = 0; i < count; ++i) {
+    if (accepted[i] && !present[i])
+      rows_.push_back(start + i);
+  }
+  if (sort_column_ < 0) {
+    std::sort(rows_.begin(), rows_.end());
+    NotifyReset();
+  } else if (sorting_) {
+    NotifyReset();
+  } else {
+    Resort();
+  }
+}
+
+void SortFilterTableModel::OnModelReset(TableModel* model) {
+  Refresh();
+}
+
+bool SortFilterTableModel::Accepts(uint32_t source_row) const {
+  return !filter_ || filter_(source_.get(), source_row);
+}
+
+uint32_t SortFilterTableModel::FindInsertPosition(uint32_t source_row) const {
+  SortKey key = GetSortKey(source_.get(), sort_column_, source_row);
+  uint32_t low = 0;
+  uint32_t high = static_cast<uint32_t>(rows_.size());
+  while (low < high) {
+    uint32_t mid = low + (high - low) / 2;
+    if (IsKeyLess(key, GetSortKey(source_.get(), sort_column_, rows_[mid]),
+                  ascending_))
+      high = mid;
+    else
+      low = mid + 1;
+  }
+  return low;
+}
+
+bool SortFilterTableModel::IsInOrder(uint32_t row) const {
+  SortKey key = GetSortKey(source_.get(), sort_column_, rows_[row]);
+  if (row > 0 &&
+      !IsKeyLess(GetSortKey(source_.get(), sort_column_, rows_[row - 1]),
+                 key, ascending_))
+    return false;
+  if (row + 1 < rows_.size() &&
+      !IsKeyLess(key, GetSortKey(source_.get(), sort_column_, rows_[row + 1]),
+                 ascending_))
+    return false;
+  return true;
+}
+
+void SortFilterTableModel::Refresh() {
+  ++version_;
+  rows_.clear();
+  uint32_t count = source_->GetRowCount();
+  for (uint32_t row = 0; row < count; ++row) {
+    if (Accepts(row))
+      rows_.push_back(row);
+  }
+  if (sort_column_ < 0)
+    NotifyReset();
+  else
+    Resort();
+}
+
+void SortFilterTableModel::Resort() {
+  if (rows_.size() >= kMinRowsForBackgroundSort) {
+    // Show unsorted rows until the sort is done.
+    NotifyReset();
+    StartBackgroundSort();
+    return;
+  }
+  // Cancel running sort.
+  sorting_ = false;
+  ++sort_job_;
+  rows_ = SortKeys(GetSortKeys(source_.get(), sort_column_, rows_),
+                   ascending_);
+  NotifyReset();
+}
+
+void SortFilterTableModel::StartBackgroundSort() {
+  sorting_ = true;
+  uint32_t job = ++sort_job_;
+  uint32_t version = version_;
+  bool ascending = ascending_;
+  std::vector<SortKey> keys = GetSortKeys(source_.get(), sort_column_, rows_);
+  // Keep the model alive until the result is delivered, the reference is
+  // only created and released on the main thread.
+  auto* self = new scoped_refptr<SortFilterTableModel>(this);
+  std::thread([self, job, version, ascending,
+               keys = std::move(keys)]() mutable {
+    auto rows = std::make_shared<std::vector<uint32_t>>(
+        SortKeys(std::move(keys), ascending));
+    MessageLoop::PostTask([self, job, version, rows]() {
+      std::unique_ptr<scoped_refptr<SortFilterTableModel>> holder(self);
+      (*holder)->OnBackgroundSortDone(job, version, std::move(*rows));
+    });
+  }).detach();
+}
+
+void SortFilterTableModel::OnBackgroundSortDone(uint32_t job,
+                                                uint32_t version,
+                                                std::vector<uint32_t> rows) {
+  // A newer sort has started.
+  if (job != sort_job_)
+    return;
+  // Rows have been changed during sorting.
+  if (version != version_) {
+    StartBackgroundSort();
+    return;
+  }
+  sorting_ = false;
+  rows_ = std::move(rows);
+  NotifyReset();
+}
+
+}  // namespace nu
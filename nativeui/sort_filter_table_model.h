@@ -0,0 +1,96 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_SORT_FILTER_TABLE_MODEL_H_
+#define NATIVEUI_SORT_FILTER_TABLE_MODEL_H_
+
+#include <functional>
+#include <vector>
+
+#include "nativeui/table_model.h"
+
+namespace nu {
+
+// Shows the rows of another TableModel in sorted order and hides rows that
+// do not pass the filter, without copying any data.
+class NATIVEUI_EXPORT SortFilterTableModel : public TableModel,
+                                             public TableModelObserver {
+ public:
+  // Return whether the |row| of |source| should be shown.
+  using Filter = std::function<bool(TableModel* source, uint32_t row)>;
+
+  explicit SortFilterTableModel(TableModel* source);
+
+  TableModel* GetSource() const;
+
+  // Sort rows by the values of |column|, -1 restores the order of source.
+  // Large models are sorted on a worker thread, and the table is updated
+  // once the sorting is done.
+  void SortByColumn(int column, bool ascending);
+  int GetSortColumn() const;
+  bool IsSortAscending() const;
+  bool IsSorting() const;
+
+  // Only show rows that |filter| returns true for, an empty function shows
+  // all rows.
+  void SetFilter(Filter filter);
+
+  // Convert row indexes between this model and source model, return -1 if
+  // there is no such row.
+  int MapToSource(uint32_t row) const;
+  int MapFromSource(uint32_t row) const;
+
+  // TableModel:
+  uint32_t GetRowCount() const override;
+  const base::Value* GetValue(uint32_t column, uint32_t row) const override;
+  void SetValue(uint32_t column, uint32_t row, base::Value value) override;
+
+  // TableModelObserver:
+  void OnModelRowsInserted(TableModel* model,
+                           uint32_t start, uint32_t count) override;
+  void OnModelRowsDeleted(TableModel* model,
+                          uint32_t start, uint32_t count) override;
+  void OnModelRowsChanged(TableModel* model,
+                          uint32_t start, uint32_t count) override;
+  void OnModelReset(TableModel* model) override;
+
+ protected:
+  ~SortFilterTableModel() override;
+
+ private:
+  bool Accepts(uint32_t source_row) const;
+  // Return where to insert |source_row| to keep rows in order.
+  uint32_t FindInsertPosition(uint32_t source_row) const;
+  // Whether the rows around |row| are still in order.
+  bool IsInOrder(uint32_t row) const;
+
+  // Filter all source rows and sort.
+  void Refresh();
+  // Sort current rows and reset table.
+  void Resort();
+  void StartBackgroundSort();
+  void OnBackgroundSortDone(uint32_t job, uint32_t version,
+                            std::vector<uint32_t> rows);
+
+  scoped_refptr<TableModel> source_;
+  Filter filter_;
+  int sort_column_ = -1;
+  bool ascending_ = true;
+
+  // Maps rows to source rows.
+  std::vector<uint32_t> rows_;
+
+  // Whether a background sort is running, the rows are not in order before
+  // it finishes.
+  bool sorting_ = false;
+  // Identifies the latest background sort.
+  uint32_t sort_job_ = 0;
+  // Increased whenever rows are changed, so results of background sort
+  // for outdated rows are discarded.
+  uint32_t version_ = 0;
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_SORT_FILTER_TABLE_MODEL_H_
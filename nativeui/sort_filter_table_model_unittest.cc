@@ -0,0 +1,148 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class CountingObserver : public nu::TableModelObserver {
+ public:
+  void OnModelRowsInserted(nu::TableModel* model,
+                           uint32_t start, uint32_t count) override {
+    ++notifications;
+  }
+  void OnModelRowsDeleted(nu::TableModel* model,
+                          uint32_t start, uint32_t count) override {
+    ++notifications;
+  }
+  void OnModelRowsChanged(nu::TableModel* model,
+                          uint32_t start, uint32_t count) override {
+    ++notifications;
+  }
+  void OnModelReset(nu::TableModel* model) override {
+    ++notifications;
+    ++resets;
+  }
+
+  int notifications = 0;
+  int resets = 0;
+};
+
+}  // namespace
+
+class SortFilterTableModelTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    source_ = new nu::SimpleTableModel(2);
+    for (int i : {3, 1, 4, 1, 5, 9, 2, 6})
+      AddRow(i);
+    model_ = new nu::SortFilterTableModel(source_.get());
+    model_->AddObserver(&observer_);
+  }
+
+  void TearDown() override {
+    model_->RemoveObserver(&observer_);
+  }
+
+  void AddRow(int i) {
+    nu::SimpleTableModel::Row row;
+    row.emplace_back(i);
+    row.emplace_back(std::to_string(i));
+    source_->AddRow(std::move(row));
+  }
+
+  std::vector<int> GetColumn() {
+    std::vector<int> values;
+    for (uint32_t i = 0; i < model_->GetRowCount(); ++i)
+      values.push_back(model_->GetValue(0, i)->GetInt());
+    return values;
+  }
+
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  CountingObserver observer_;
+  scoped_refptr<nu::SimpleTableModel> source_;
+  scoped_refptr<nu::SortFilterTableModel> model_;
+};
+
+TEST_F(SortFilterTableModelTest, Sort) {
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 1, 4, 1, 5, 9, 2, 6}));
+  model_->SortByColumn(0, true);
+  EXPECT_EQ(GetColumn(), std::vector<int>({1, 1, 2, 3, 4, 5, 6, 9}));
+  EXPECT_EQ(model_->MapToSource(0), 1);
+  EXPECT_EQ(model_->MapToSource(1), 3);
+  EXPECT_EQ(model_->MapToSource(8), -1);
+  model_->SortByColumn(1, false);
+  EXPECT_EQ(GetColumn(), std::vector<int>({9, 6, 5, 4, 3, 2, 1, 1}));
+  model_->SortByColumn(-1, true);
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 1, 4, 1, 5, 9, 2, 6}));
+  EXPECT_EQ(observer_.resets, 3);
+}
+
+TEST_F(SortFilterTableModelTest, Filter) {
+  model_->SetFilter([](nu::TableModel* source, uint32_t row) {
+    return source->GetValue(0, row)->GetInt() > 2;
+  });
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 4, 5, 9, 6}));
+  EXPECT_EQ(model_->MapFromSource(1), -1);
+  EXPECT_EQ(model_->MapFromSource(2), 1);
+  model_->SetFilter(nullptr);
+  EXPECT_EQ(model_->GetRowCount(), 8u);
+}
+
+TEST_F(SortFilterTableModelTest, SourceChanges) {
+  model_->SetFilter([](nu::TableModel* source, uint32_t row) {
+    return source->GetValue(0, row)->GetInt() > 2;
+  });
+  model_->SortByColumn(0, true);
+  observer_.notifications = 0;
+
+  // Rows are inserted at sorted position.
+  AddRow(7);
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 4, 5, 6, 7, 9}));
+  AddRow(0);
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 4, 5, 6, 7, 9}));
+  EXPECT_EQ(observer_.notifications, 1);
+
+  // Changed rows are filtered again.
+  source_->SetValue(0, 1, base::Value(8));
+  EXPECT_EQ(GetColumn(), std::vector<int>({3, 4, 5, 6, 7, 8, 9}));
+  source_->SetValue(0, 0, base::Value(1));
+  EXPECT_EQ(GetColumn(), std::vector<int>({4, 5, 6, 7, 8, 9}));
+  EXPECT_EQ(observer_.notifications, 3);
+
+  // A batch only sends one notification.
+  source_->RemoveRows(2, 4);
+  EXPECT_EQ(GetColumn(), std::vector<int>({6, 7, 8}));
+  EXPECT_EQ(observer_.notifications, 4);
+}
+
+TEST_F(SortFilterTableModelTest, BackgroundSort) {
+  std::vector<nu::SimpleTableModel::Row> rows;
+  for (int i = 0; i < 20000; ++i) {
+    nu::SimpleTableModel::Row row;
+    row.emplace_back(i);
+    row.emplace_back(std::to_string(i));
+    rows.push_back(std::move(row));
+  }
+  source_->AddRows(std::move(rows));
+  model_->SortByColumn(0, false);
+  EXPECT_TRUE(model_->IsSorting());
+  // Old order is kept before sorting is done.
+  EXPECT_EQ(model_->GetValue(0, 0)->GetInt(), 3);
+  observer_.resets = 0;
+  std::function<void()> wait;
+  wait = [&]() {
+    if (model_->IsSorting())
+      nu::MessageLoop::PostDelayedTask(10, wait);
+    else
+      nu::MessageLoop::Quit();
+  };
+  nu::MessageLoop::PostTask(wait);
+  nu::MessageLoop::Run();
+  EXPECT_EQ(observer_.resets, 1);
+  EXPECT_EQ(model_->GetValue(0, 0)->GetInt(), 19999);
+  EXPECT_EQ(model_->GetValue(0, 20007)->GetInt(), 0);
+}
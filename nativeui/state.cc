@@ -13,6 +13,8 @@
 #include "base/lazy_instance.h"
 #include "base/threading/thread_local.h"
 #include "nativeui/gfx/font.h"
+#include "nativeui/gfx/font_registry.h"
+#include "nativeui/gfx/text_layout_cache.h"
 #include "nativeui/protocol_job.h"
 #include "third_party/yoga/yoga/Yoga.h"
 
@@ -23,6 +25,7 @@
 #include "nativeui/win/util/gdiplus_holder.h"
 #include "nativeui/win/util/scoped_ole_initializer.h"
 #include "nativeui/win/util/subwin_holder.h"
+#include "nativeui/win/util/task_window.h"
 #include "nativeui/win/util/tray_host.h"
 #endif
 
@@ -73,4 +76,16 @@ Clipboard* State::GetClipboard(Clipboard::Type type) {
   return clipboards_[index].get();
 }
 
+FontRegistry* State::GetFontRegistry() {
+  if (!font_registry_)
+    font_registry_.reset(new FontRegistry);
+  return font_registry_.get();
+}
+
+TextLayoutCache* State::GetTextLayoutCache() {
+  if (!text_layout_cache_)
+    text_layout_cache_.reset(new TextLayoutCache);
+  return text_layout_cache_.get();
+}
+
 }  // namespace nu
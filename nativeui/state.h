@@ -39,11 +39,14 @@ class ClassRegistrar;
 class GdiplusHolder;
 class NativeTheme;
 class SubwinHolder;
+class TaskWindow;
 class ScopedOleInitializer;
 class TrayHost;
 #endif
 
 class Font;
+class FontRegistry;
+class TextLayoutCache;
 
 class NATIVEUI_EXPORT State {
  public:
@@ -61,6 +64,12 @@ class NATIVEUI_EXPORT State {
   // Return clipboard instance.
   Clipboard* GetClipboard(Clipboard::Type type = Clipboard::Type::CopyPaste);
 
+  // Return the registry of shared fonts.
+  FontRegistry* GetFontRegistry();
+
+  // Return the cache of text layouts used by Painter::DrawText.
+  TextLayoutCache* GetTextLayoutCache();
+
   // Internal classes.
 #if defined(OS_WIN)
   void InitializeCOM();
@@ -89,6 +98,7 @@ class NATIVEUI_EXPORT State {
   std::unique_ptr<SubwinHolder> subwin_holder_;
   std::unique_ptr<NativeTheme> native_theme_;
   std::unique_ptr<TrayHost> tray_host_;
+  std::unique_ptr<TaskWindow> task_window_;
   Microsoft::WRL::ComPtr<IDWriteFactory> dwrite_factory_;
   Microsoft::WRL::ComPtr<ID2D1Factory> d2d1_factory_;
   Microsoft::WRL::ComPtr<IWICImagingFactory> wic_factory_;
@@ -110,6 +120,12 @@ class NATIVEUI_EXPORT State {
   std::array<std::unique_ptr<Clipboard>,
              static_cast<size_t>(Clipboard::Type::Count)> clipboards_;
 
+  // Shared fonts.
+  std::unique_ptr<FontRegistry> font_registry_;
+
+  // Cached text layouts.
+  std::unique_ptr<TextLayoutCache> text_layout_cache_;
+
   YGConfigRef yoga_config_;
 
   DISALLOW_COPY_AND_ASSIGN(State);
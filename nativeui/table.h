@@ -38,6 +38,9 @@ class NATIVEUI_EXPORT Table : public View {
     int column = -1;
     // Initial width.
     int width = -1;
+    // Whether to cache the drawings of custom cells, so on_draw is only called
+    // again after the value has been changed.
+    bool cache_drawing = false;
   };
 
   Table();
@@ -75,6 +78,10 @@ class NATIVEUI_EXPORT Table : public View {
   void NotifyRowInsertion(uint32_t row);
   void NotifyRowDeletion(uint32_t row);
   void NotifyValueChange(uint32_t column, uint32_t row);
+  void NotifyRowsInserted(uint32_t start, uint32_t count);
+  void NotifyRowsDeleted(uint32_t start, uint32_t count);
+  void NotifyRowsChanged(uint32_t start, uint32_t count);
+  void NotifyReset();
 
   scoped_refptr<TableModel> model_;
 };
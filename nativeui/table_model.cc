@@ -4,12 +4,32 @@
 
 #include "nativeui/table_model.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 #include "nativeui/table.h"
 
 namespace nu {
 
+namespace {
+
+// How many rows to request from get_rows in one call, which should cover the
+// visible rows of a table plus some overscan.
+const uint32_t kRowsPerFetch = 128;
+
+// Rows far away from the requested row are dropped when there are more cached
+// values than this.
+const size_t kMaxCachedValues = 16 * 1024;
+
+// How many rows around the requested row are kept when dropping cache.
+const uint32_t kRowsToKeep = 4 * kRowsPerFetch;
+
+// Passed to OnRowsChanged when all the rows after start have been moved.
+const uint32_t kAllRows = std::numeric_limits<uint32_t>::max();
+
+}  // namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // TableModel implementation.
 
@@ -18,20 +38,78 @@ TableModel::TableModel() {}
 TableModel::~TableModel() {}
 
 void TableModel::NotifyRowInsertion(uint32_t row) {
+  OnRowsChanged(row, kAllRows - row);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsInserted(this, row, 1);
   for (Table* table : tables_)
     table->NotifyRowInsertion(row);
 }
 
 void TableModel::NotifyRowDeletion(uint32_t row) {
+  OnRowsChanged(row, kAllRows - row);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsDeleted(this, row, 1);
   for (Table* table : tables_)
     table->NotifyRowDeletion(row);
 }
 
 void TableModel::NotifyValueChange(uint32_t column, uint32_t row) {
+  OnRowsChanged(row, 1);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsChanged(this, row, 1);
   for (Table* table : tables_)
     table->NotifyValueChange(column, row);
 }
 
+void TableModel::NotifyRowsInserted(uint32_t start, uint32_t count) {
+  if (count == 0)
+    return;
+  OnRowsChanged(start, kAllRows - start);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsInserted(this, start, count);
+  for (Table* table : tables_)
+    table->NotifyRowsInserted(start, count);
+}
+
+void TableModel::NotifyRowsDeleted(uint32_t start, uint32_t count) {
+  if (count == 0)
+    return;
+  OnRowsChanged(start, kAllRows - start);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsDeleted(this, start, count);
+  for (Table* table : tables_)
+    table->NotifyRowsDeleted(start, count);
+}
+
+void TableModel::NotifyRowsChanged(uint32_t start, uint32_t count) {
+  if (count == 0)
+    return;
+  OnRowsChanged(start, std::min(count, kAllRows - start));
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelRowsChanged(this, start, count);
+  for (Table* table : tables_)
+    table->NotifyRowsChanged(start, count);
+}
+
+void TableModel::NotifyReset() {
+  OnRowsChanged(0, kAllRows);
+  for (TableModelObserver* observer : observers_)
+    observer->OnModelReset(this);
+  for (Table* table : tables_)
+    table->NotifyReset();
+}
+
+void TableModel::AddObserver(TableModelObserver* observer) {
+  observers_.push_back(observer);
+}
+
+void TableModel::RemoveObserver(TableModelObserver* observer) {
+  observers_.remove(observer);
+}
+
+void TableModel::OnRowsChanged(uint32_t start, uint32_t count) {
+}
+
 void TableModel::Subscribe(Table* view) {
   tables_.push_back(view);
 }
@@ -48,31 +126,52 @@ AbstractTableModel::AbstractTableModel(bool index_starts_from_0)
 
 AbstractTableModel::~AbstractTableModel() {}
 
+void AbstractTableModel::ClearCache() {
+  cache_.clear();
+  row_count_.reset();
+}
+
 uint32_t AbstractTableModel::GetRowCount() const {
   if (!get_row_count)
     return 0;
-  return get_row_count(const_cast<AbstractTableModel*>(this));
+  if (!row_count_)
+    row_count_ = get_row_count(const_cast<AbstractTableModel*>(this));
+  return *row_count_;
 }
 
 const base::Value* AbstractTableModel::GetValue(
     uint32_t column, uint32_t row) const {
-  if (!get_value)
-    return nullptr;
-  if (!index_starts_from_0_) {
-    column += 1;
-    row += 1;
+  auto key = std::make_pair(row, column);
+  auto it = cache_.find(key);
+  if (it != cache_.end())
+    return &it->second;
+  TrimCache(row);
+  // Read the rows around in one call.
+  if (get_rows) {
+    FetchRows(row);
+    it = cache_.find(key);
+    if (it != cache_.end())
+      return &it->second;
+  }
+  if (!get_value) {
+    if (!get_rows)
+      return nullptr;
+    // Remember the missing value so get_rows is not called again.
+    return &cache_.emplace(key, base::Value()).first->second;
   }
   // We can not get a reference from scripting languages, so we just store a
-  // temporary copy and return a reference to the copy.
+  // copy in cache and return a reference to the copy.
   auto* self = const_cast<AbstractTableModel*>(this);
-  self->copy_ = get_value(self, column, row);
-  return &copy_;
+  base::Value value = index_starts_from_0_ ?
+      get_value(self, column, row) : get_value(self, column + 1, row + 1);
+  return &cache_.emplace(key, std::move(value)).first->second;
 }
 
 void AbstractTableModel::SetValue(uint32_t column, uint32_t row,
                                   base::Value value) {
   if (!set_value)
     return;
+  cache_.erase(std::make_pair(row, column));
   if (!index_starts_from_0_) {
     column += 1;
     row += 1;
@@ -81,6 +180,41 @@ void AbstractTableModel::SetValue(uint32_t column, uint32_t row,
             column, row, std::move(value));
 }
 
+void AbstractTableModel::OnRowsChanged(uint32_t start, uint32_t count) {
+  uint32_t end = start + count;
+  // All rows after |start| are changed for insertions and deletions.
+  if (end == kAllRows)
+    row_count_.reset();
+  cache_.erase(cache_.lower_bound(std::make_pair(start, 0u)),
+               cache_.lower_bound(std::make_pair(end, 0u)));
+}
+
+void AbstractTableModel::FetchRows(uint32_t row) const {
+  uint32_t row_count = GetRowCount();
+  if (row >= row_count)
+    return;
+  uint32_t start = row - row % kRowsPerFetch;
+  uint32_t count = std::min(kRowsPerFetch, row_count - start);
+  auto* self = const_cast<AbstractTableModel*>(this);
+  std::vector<std::vector<base::Value>> rows =
+      get_rows(self, index_starts_from_0_ ? start : start + 1, count);
+  for (uint32_t i = 0; i < rows.size() && i < count; ++i) {
+    for (uint32_t column = 0; column < rows[i].size(); ++column) {
+      cache_[std::make_pair(start + i, column)] = std::move(rows[i][column]);
+    }
+  }
+}
+
+void AbstractTableModel::TrimCache(uint32_t row) const {
+  if (cache_.size() < kMaxCachedValues)
+    return;
+  // Drop rows far away from current position.
+  uint32_t first = row > kRowsToKeep ? row - kRowsToKeep : 0;
+  uint32_t last = row < kAllRows - kRowsToKeep ? row + kRowsToKeep : kAllRows;
+  cache_.erase(cache_.begin(), cache_.lower_bound(std::make_pair(first, 0u)));
+  cache_.erase(cache_.lower_bound(std::make_pair(last, 0u)), cache_.end());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // SimpleTableModel implementation.
 
@@ -106,6 +240,35 @@ void SimpleTableModel::RemoveRowAt(uint32_t row) {
   }
 }
 
+void SimpleTableModel::AddRows(std::vector<Row> rows) {
+  uint32_t start = static_cast<uint32_t>(rows_.size());
+  rows_.reserve(rows_.size() + rows.size());
+  for (Row& row : rows) {
+    if (row.size() >= columns_) {
+      rows_.emplace_back(std::move(row));
+    } else {
+      LOG(ERROR) << "AddRows skipped a row because row length is less than "
+                    "column size.";
+    }
+  }
+  NotifyRowsInserted(start, static_cast<uint32_t>(rows_.size()) - start);
+}
+
+void SimpleTableModel::RemoveRows(uint32_t start, uint32_t count) {
+  if (start < rows_.size() && count <= rows_.size() - start) {
+    rows_.erase(rows_.begin() + start, rows_.begin() + start + count);
+    NotifyRowsDeleted(start, count);
+  } else {
+    LOG(ERROR) << "RemoveRows failed because range is not in model.";
+  }
+}
+
+void SimpleTableModel::Clear() {
+  uint32_t count = static_cast<uint32_t>(rows_.size());
+  rows_.clear();
+  NotifyRowsDeleted(0, count);
+}
+
 uint32_t SimpleTableModel::GetRowCount() const {
   return static_cast<uint32_t>(rows_.size());
 }
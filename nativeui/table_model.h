@@ -7,15 +7,34 @@
 
 #include <functional>
 #include <list>
+#include <map>
+#include <utility>
 #include <vector>
 
 #include "base/memory/ref_counted.h"
+#include "base/optional.h"
 #include "base/values.h"
 #include "nativeui/nativeui_export.h"
 
 namespace nu {
 
 class Table;
+class TableModel;
+
+// Receives changes of a TableModel, used by models that wrap other models.
+class NATIVEUI_EXPORT TableModelObserver {
+ public:
+  virtual void OnModelRowsInserted(TableModel* model,
+                                   uint32_t start, uint32_t count) = 0;
+  virtual void OnModelRowsDeleted(TableModel* model,
+                                  uint32_t start, uint32_t count) = 0;
+  virtual void OnModelRowsChanged(TableModel* model,
+                                  uint32_t start, uint32_t count) = 0;
+  virtual void OnModelReset(TableModel* model) = 0;
+
+ protected:
+  virtual ~TableModelObserver() {}
+};
 
 // Users should sublcass TableModel to provide their own implementation.
 class NATIVEUI_EXPORT TableModel : public base::RefCounted<TableModel> {
@@ -26,6 +45,10 @@ class NATIVEUI_EXPORT TableModel : public base::RefCounted<TableModel> {
   // Return the reference to the data in the model.
   // Caller should not store the return value, as it is a temporary reference
   // that may immediately get destroyed after exiting current stack.
+  //
+  // Implementations must keep the returned value alive until GetValue is
+  // called again for the same column, since tables may read all cells of a
+  // row before drawing them.
   virtual const base::Value* GetValue(uint32_t column, uint32_t row) const = 0;
 
   // Change the value.
@@ -36,10 +59,28 @@ class NATIVEUI_EXPORT TableModel : public base::RefCounted<TableModel> {
   void NotifyRowDeletion(uint32_t row);
   void NotifyValueChange(uint32_t column, uint32_t row);
 
+  // Notify that |count| rows starting at |start| have been inserted or
+  // removed, which is much faster than notifying each row.
+  void NotifyRowsInserted(uint32_t start, uint32_t count);
+  void NotifyRowsDeleted(uint32_t start, uint32_t count);
+  void NotifyRowsChanged(uint32_t start, uint32_t count);
+
+  // Notify that the whole model has been changed, the table will reload all
+  // rows.
+  void NotifyReset();
+
+  // Observers are notified before tables.
+  void AddObserver(TableModelObserver* observer);
+  void RemoveObserver(TableModelObserver* observer);
+
  protected:
   TableModel();
   virtual ~TableModel();
 
+  // Called before notifying tables that |count| rows starting at |start| have
+  // been changed, inserted or removed.
+  virtual void OnRowsChanged(uint32_t start, uint32_t count);
+
  private:
   friend class base::RefCounted<TableModel>;
   friend class Table;
@@ -49,6 +90,7 @@ class NATIVEUI_EXPORT TableModel : public base::RefCounted<TableModel> {
   void Unsubscribe(Table* view);
 
   std::list<Table*> tables_;
+  std::list<TableModelObserver*> observers_;
 };
 
 // Used by language bindings.
@@ -62,18 +104,36 @@ class NATIVEUI_EXPORT AbstractTableModel : public TableModel {
   const base::Value* GetValue(uint32_t column, uint32_t row) const override;
   void SetValue(uint32_t column, uint32_t row, base::Value value) override;
 
+  // Drop all cached rows and row count.
+  void ClearCache();
+
   // Delegate methods.
   std::function<uint32_t(AbstractTableModel*)> get_row_count;
   std::function<base::Value(AbstractTableModel*, uint32_t, uint32_t)> get_value;
   std::function<void(AbstractTableModel*,
                      uint32_t, uint32_t, base::Value)> set_value;
+  // Optional, return |count| rows starting at |start| in one call.
+  std::function<std::vector<std::vector<base::Value>>(
+      AbstractTableModel*, uint32_t, uint32_t)> get_rows;
 
  protected:
   ~AbstractTableModel() override;
 
+  // TableModel:
+  void OnRowsChanged(uint32_t start, uint32_t count) override;
+
  private:
+  // Fetch the rows around |row| with get_rows.
+  void FetchRows(uint32_t row) const;
+  // Drop cached values far away from |row| when there are too many.
+  void TrimCache(uint32_t row) const;
+
   bool index_starts_from_0_;
-  base::Value copy_;
+
+  // Values returned from delegates, the values are kept until the rows are
+  // notified as changed so the delegates are not called again when drawing.
+  mutable std::map<std::pair<uint32_t, uint32_t>, base::Value> cache_;
+  mutable base::Optional<uint32_t> row_count_;
 };
 
 // A simple implementation of TableModel that manages the data.
@@ -86,6 +146,11 @@ class NATIVEUI_EXPORT SimpleTableModel : public TableModel {
   void AddRow(Row data);
   void RemoveRowAt(uint32_t row);
 
+  // Batch operations, which only notify the table once.
+  void AddRows(std::vector<Row> rows);
+  void RemoveRows(uint32_t start, uint32_t count);
+  void Clear();
+
   // TableModel:
   uint32_t GetRowCount() const override;
   const base::Value* GetValue(uint32_t column, uint32_t row) const override;
@@ -6,6 +6,10 @@
 #include "nativeui/nativeui.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#if defined(OS_LINUX)
+#include <gtk/gtk.h>
+#endif
+
 class TableTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -57,3 +61,116 @@ TEST_F(TableTest, SelectSingleRow) {
   table_->SelectRow(100001);
   EXPECT_EQ(table_->GetSelectedRow(), 9999);
 }
+
+TEST_F(TableTest, BatchInsertKeepsSelection) {
+  scoped_refptr<nu::SimpleTableModel> model = new nu::SimpleTableModel(1);
+  table_->AddColumn("A");
+  table_->SetModel(model.get());
+  std::vector<nu::SimpleTableModel::Row> rows;
+  for (int i = 0; i < 10; ++i)
+    rows.push_back({base::Value(i)});
+  model->AddRows(std::move(rows));
+  table_->SelectRow(5);
+  rows.clear();
+  for (int i = 0; i < 10000; ++i)
+    rows.push_back({base::Value(i)});
+  model->AddRows(std::move(rows));
+  EXPECT_EQ(model->GetRowCount(), 10010u);
+  EXPECT_EQ(table_->GetSelectedRow(), 5);
+  model->RemoveRows(0, 5000);
+  EXPECT_EQ(table_->GetSelectedRow(), -1);
+  table_->SelectRow(5009);
+  EXPECT_EQ(table_->GetSelectedRow(), 5009);
+}
+
+#if defined(OS_LINUX)
+void OnModelNotify(GObject*, GParamSpec*, int* reattaches) {
+  ++(*reattaches);
+}
+
+TEST_F(TableTest, BatchAppendBelowViewport) {
+  scoped_refptr<nu::SimpleTableModel> model = new nu::SimpleTableModel(1);
+  table_->AddColumn("A");
+  table_->SetModel(model.get());
+  scoped_refptr<nu::Window> window = new nu::Window(nu::Window::Options());
+  window->SetContentView(table_.get());
+  window->SetContentSize(nu::SizeF(100, 100));
+  window->SetVisible(true);
+  std::vector<nu::SimpleTableModel::Row> rows;
+  for (int i = 0; i < 1000; ++i)
+    rows.push_back({base::Value(i)});
+  model->AddRows(std::move(rows));
+  while (gtk_events_pending())
+    gtk_main_iteration();
+
+  // Reattaching the model notifies "model" twice.
+  int reattaches = 0;
+  GObject* tree_view = static_cast<GObject*>(
+      g_object_get_data(G_OBJECT(table_->GetNative()), "tree-view"));
+  g_signal_connect(tree_view, "notify::model", G_CALLBACK(OnModelNotify),
+                   &reattaches);
+  // Small batch below the visible rows is notified row by row.
+  rows.clear();
+  for (int i = 0; i < 100; ++i)
+    rows.push_back({base::Value(i)});
+  model->AddRows(std::move(rows));
+  EXPECT_EQ(reattaches, 0);
+  // Large batch is rebuilt even when it is below the visible rows.
+  rows.clear();
+  for (int i = 0; i < 100000; ++i)
+    rows.push_back({base::Value(i)});
+  model->AddRows(std::move(rows));
+  EXPECT_EQ(reattaches, 2);
+  EXPECT_EQ(model->GetRowCount(), 101100u);
+  g_signal_handlers_disconnect_by_data(tree_view, &reattaches);
+}
+#endif
+
+TEST_F(TableTest, NotifyReset) {
+  scoped_refptr<TestTableModel> model = new TestTableModel;
+  table_->AddColumn("A");
+  table_->SetModel(model.get());
+  model->NotifyRowsChanged(0, 10000);
+  model->NotifyReset();
+  table_->SelectRow(100);
+  EXPECT_EQ(table_->GetSelectedRow(), 100);
+}
+
+TEST_F(TableTest, AbstractTableModelCache) {
+  scoped_refptr<nu::AbstractTableModel> model = new nu::AbstractTableModel;
+  int get_value_calls = 0;
+  int get_rows_calls = 0;
+  model->get_row_count = [](nu::AbstractTableModel*) { return 1000u; };
+  model->get_value = [&](nu::AbstractTableModel*, uint32_t column,
+                         uint32_t row) {
+    ++get_value_calls;
+    return base::Value(static_cast<int>(row));
+  };
+  EXPECT_EQ(*model->GetValue(0, 10), base::Value(10));
+  EXPECT_EQ(*model->GetValue(0, 10), base::Value(10));
+  EXPECT_EQ(get_value_calls, 1);
+
+  model->get_rows = [&](nu::AbstractTableModel*, uint32_t start,
+                        uint32_t count) {
+    ++get_rows_calls;
+    std::vector<std::vector<base::Value>> rows;
+    for (uint32_t i = start; i < start + count; ++i) {
+      std::vector<base::Value> row;
+      row.emplace_back(static_cast<int>(i));
+      rows.push_back(std::move(row));
+    }
+    return rows;
+  };
+  for (uint32_t i = 20; i < 60; ++i)
+    EXPECT_EQ(*model->GetValue(0, i), base::Value(static_cast<int>(i)));
+  EXPECT_EQ(get_rows_calls, 1);
+  EXPECT_EQ(get_value_calls, 1);
+
+  // Notifications invalidate the cache.
+  model->NotifyValueChange(0, 30);
+  model->GetValue(0, 30);
+  EXPECT_EQ(get_rows_calls, 2);
+  model->ClearCache();
+  model->GetValue(0, 10);
+  EXPECT_EQ(get_rows_calls, 3);
+}
@@ -4,8 +4,18 @@
 
 #include "nativeui/text_edit.h"
 
+#include "nativeui/gfx/font.h"
+
 namespace nu {
 
+#if defined(OS_LINUX)
+TextEdit::StyledRange::StyledRange() {}
+
+TextEdit::StyledRange::StyledRange(const StyledRange& other) = default;
+
+TextEdit::StyledRange::~StyledRange() {}
+#endif
+
 // static
 const char TextEdit::kClassName[] = "TextEdit";
 
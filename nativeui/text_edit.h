@@ -7,15 +7,43 @@
 
 #include <string>
 #include <tuple>
+#include <vector>
 
+#include "base/optional.h"
 #include "nativeui/scroll.h"
 
+namespace base {
+class FilePath;
+}
+
 namespace nu {
 
 class NATIVEUI_EXPORT TextEdit : public View {
  public:
   TextEdit();
 
+#if defined(OS_LINUX)
+  // Describes one edit of the text, offsets and lengths are in characters.
+  struct TextChange {
+    int offset = 0;
+    int deleted_length = 0;
+    std::string inserted_text;
+  };
+
+  // Style applied to a range of text.
+  struct NATIVEUI_EXPORT StyledRange {
+    StyledRange();
+    StyledRange(const StyledRange& other);
+    ~StyledRange();
+
+    int start = 0;
+    int end = 0;
+    scoped_refptr<Font> font;
+    base::Optional<Color> color;
+    base::Optional<Color> background;
+  };
+#endif
+
   // View class name.
   static const char kClassName[];
 
@@ -29,6 +57,16 @@ class NATIVEUI_EXPORT TextEdit : public View {
   bool CanRedo() const;
   void Undo();
   bool CanUndo() const;
+#if !defined(OS_WIN)
+  // Changes made between the calls are undone in one step.
+  void BeginUndoGroup();
+  void EndUndoGroup();
+#endif
+#if defined(OS_LINUX)
+  // Bound the memory of undo history, oldest steps are dropped first.
+  void SetUndoMemoryLimit(uint32_t bytes);
+  uint32_t GetUndoMemoryUsage() const;
+#endif
 
   void Cut();
   void Copy();
@@ -43,6 +81,36 @@ class NATIVEUI_EXPORT TextEdit : public View {
   void Delete();
   void DeleteRange(int start, int end);
 
+#if defined(OS_LINUX)
+  // Access to text without copying the whole buffer, lines are 0-based and
+  // do not include the line terminator.
+  int GetTextLength() const;
+  int GetLineCount() const;
+  std::string GetLine(int line) const;
+  int GetLineAtOffset(int offset) const;
+  int GetLineStartOffset(int line) const;
+  // Return the range of characters currently shown.
+  std::tuple<int, int> GetVisibleRange() const;
+  // Increased on every edit, can be used to check whether the text has
+  // changed since a range of text was read.
+  int GetRevision() const;
+
+  // Replace the styles of text with |ranges|, only the ranges that differ
+  // from current styles are touched.
+  void SetStyledRanges(const std::vector<StyledRange>& ranges);
+  // Like SetStyledRanges but only replace styles between |start| and |end|.
+  void SetStyledRangesInRange(int start, int end,
+                              const std::vector<StyledRange>& ranges);
+
+  // Replace the text with the content of |path|, which is loaded in chunks
+  // at idle time. The load is not recorded in undo history.
+  bool LoadFromFile(const base::FilePath& path);
+  // Append |chunks| to the text at idle time, after pending loads.
+  void AppendChunks(std::vector<std::string> chunks);
+  bool IsLoading() const;
+  void CancelLoading();
+#endif
+
 #if !defined(OS_WIN)
   void SetOverlayScrollbar(bool overlay);
 #endif
@@ -52,6 +120,10 @@ class NATIVEUI_EXPORT TextEdit : public View {
 
   // Events.
   Signal<void(TextEdit*)> on_text_change;
+#if defined(OS_LINUX)
+  Signal<void(TextEdit*, const TextChange&)> on_text_edit;
+  Signal<void(TextEdit*, float)> on_load_progress;
+#endif
 
   // Delegate methods.
   std::function<bool(TextEdit*)> should_insert_new_line;
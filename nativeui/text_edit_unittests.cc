@@ -2,9 +2,17 @@
 // Use of this source code is governed by the license that can be found in the
 // LICENSE file.
 
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
 #include "nativeui/nativeui.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
+#if defined(OS_LINUX)
+#include <gtk/gtk.h>
+
+#include <thread>
+#endif
+
 class TextEditTest : public testing::Test {
  protected:
   void SetUp() override {
@@ -96,3 +104,245 @@ TEST_F(TextEditTest, Undo) {
   EXPECT_EQ(edit_->CanUndo(), true);
   EXPECT_EQ(edit_->CanRedo(), false);
 }
+
+#if !defined(OS_WIN)
+TEST_F(TextEditTest, UndoGroup) {
+  edit_->SetText("a");
+  edit_->BeginUndoGroup();
+  edit_->InsertTextAt("b", 1);
+  edit_->BeginUndoGroup();
+  edit_->InsertTextAt("c", 2);
+  edit_->EndUndoGroup();
+  edit_->DeleteRange(0, 1);
+  edit_->EndUndoGroup();
+  EXPECT_EQ(edit_->GetText(), "bc");
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "a");
+  edit_->Redo();
+  EXPECT_EQ(edit_->GetText(), "bc");
+}
+#endif
+
+#if defined(OS_LINUX)
+TEST_F(TextEditTest, MergeTyping) {
+  GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(
+      g_object_get_data(G_OBJECT(edit_->GetNative()), "text-view")));
+  edit_->SetText("");
+  for (const char* c : { "a", "b", " ", "\xC3\xA9" })
+    gtk_text_buffer_insert_interactive_at_cursor(buffer, c, -1, TRUE);
+  EXPECT_EQ(edit_->GetText(), "ab \xC3\xA9");
+  // Word boundary starts a new step.
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "ab");
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "");
+  edit_->Redo();
+  edit_->Redo();
+  EXPECT_EQ(edit_->GetText(), "ab \xC3\xA9");
+  EXPECT_EQ(edit_->GetSelectionRange(), std::make_tuple(4, 4));
+}
+
+TEST_F(TextEditTest, MergeTypingAfterHistoryDropped) {
+  GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(
+      g_object_get_data(G_OBJECT(edit_->GetNative()), "text-view")));
+  edit_->SetText("");
+  gtk_text_buffer_insert_interactive_at_cursor(buffer, "a", -1, TRUE);
+  edit_->SetUndoMemoryLimit(0);
+  EXPECT_FALSE(edit_->CanUndo());
+  edit_->SetUndoMemoryLimit(64 * 1024);
+  gtk_text_buffer_insert_interactive_at_cursor(buffer, "b", -1, TRUE);
+  EXPECT_EQ(edit_->GetText(), "ab");
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "a");
+}
+
+TEST_F(TextEditTest, UndoMemoryLimit) {
+  edit_->SetText("");
+  edit_->SetUndoMemoryLimit(64 * 1024);
+  std::string line(1000, 'x');
+  for (int i = 0; i < 1000; ++i)
+    edit_->InsertText(line);
+  EXPECT_LE(edit_->GetUndoMemoryUsage(), 64u * 1024);
+  EXPECT_GT(edit_->GetUndoMemoryUsage(), 0u);
+  int steps = 0;
+  while (edit_->CanUndo()) {
+    edit_->Undo();
+    ++steps;
+  }
+  EXPECT_LT(steps, 1000);
+  EXPECT_EQ(edit_->GetText().size(), (1000u - steps) * 1000);
+  edit_->SetUndoMemoryLimit(0);
+  EXPECT_EQ(edit_->GetUndoMemoryUsage(), 0u);
+  EXPECT_FALSE(edit_->CanRedo());
+}
+
+TEST_F(TextEditTest, TextEditEvent) {
+  edit_->SetText("ab\xC3\xA9" "c");
+  std::vector<nu::TextEdit::TextChange> changes;
+  edit_->on_text_edit.Connect(
+      [&changes](nu::TextEdit*, const nu::TextEdit::TextChange& change) {
+    changes.push_back(change);
+  });
+  edit_->InsertTextAt("xy", 3);
+  edit_->DeleteRange(1, 4);
+  ASSERT_EQ(changes.size(), 2u);
+  EXPECT_EQ(changes[0].offset, 3);
+  EXPECT_EQ(changes[0].deleted_length, 0);
+  EXPECT_EQ(changes[0].inserted_text, "xy");
+  EXPECT_EQ(changes[1].offset, 1);
+  EXPECT_EQ(changes[1].deleted_length, 3);
+  EXPECT_EQ(changes[1].inserted_text, "");
+  EXPECT_EQ(edit_->GetText(), "ayc");
+}
+
+TEST_F(TextEditTest, Lines) {
+  edit_->SetText("first\n\nthird line");
+  EXPECT_EQ(edit_->GetTextLength(), 17);
+  EXPECT_EQ(edit_->GetLineCount(), 3);
+  EXPECT_EQ(edit_->GetLine(0), "first");
+  EXPECT_EQ(edit_->GetLine(1), "");
+  EXPECT_EQ(edit_->GetLine(2), "third line");
+  EXPECT_EQ(edit_->GetLine(3), "");
+  EXPECT_EQ(edit_->GetLineStartOffset(2), 7);
+  EXPECT_EQ(edit_->GetLineStartOffset(3), -1);
+  EXPECT_EQ(edit_->GetLineAtOffset(0), 0);
+  EXPECT_EQ(edit_->GetLineAtOffset(6), 1);
+  EXPECT_EQ(edit_->GetLineAtOffset(8), 2);
+}
+
+TEST_F(TextEditTest, LoadFromFile) {
+  base::ScopedTempDir dir;
+  ASSERT_TRUE(dir.CreateUniqueTempDir());
+  base::FilePath path = dir.GetPath().AppendASCII("text.txt");
+  // Larger than one piece, with a character on the boundary.
+  std::string content(64 * 1024 - 1, 'a');
+  content += "\xC3\xA9\r\nline";
+  ASSERT_TRUE(base::WriteFile(path, content.data(), content.size()));
+
+  edit_->SetText("old");
+  float last_progress = 0;
+  edit_->on_load_progress.Connect([&](nu::TextEdit*, float progress) {
+    EXPECT_GE(progress, last_progress);
+    last_progress = progress;
+    if (progress == 1.f)
+      nu::MessageLoop::Quit();
+  });
+  ASSERT_TRUE(edit_->LoadFromFile(path));
+  EXPECT_TRUE(edit_->IsLoading());
+  nu::MessageLoop::Run();
+  EXPECT_FALSE(edit_->IsLoading());
+  EXPECT_EQ(edit_->GetText(), content);
+  EXPECT_EQ(edit_->GetLineCount(), 2);
+  EXPECT_EQ(edit_->CanUndo(), false);
+  EXPECT_FALSE(edit_->LoadFromFile(dir.GetPath().AppendASCII("none")));
+}
+
+TEST_F(TextEditTest, AppendChunks) {
+  edit_->SetText("a");
+  edit_->on_load_progress.Connect([](nu::TextEdit*, float progress) {
+    if (progress == 1.f)
+      nu::MessageLoop::Quit();
+  });
+  edit_->AppendChunks({"b", "", "cd"});
+  nu::MessageLoop::Run();
+  EXPECT_EQ(edit_->GetText(), "abcd");
+  edit_->AppendChunks({"e"});
+  edit_->CancelLoading();
+  EXPECT_FALSE(edit_->IsLoading());
+  EXPECT_EQ(edit_->GetText(), "abcd");
+}
+
+TEST_F(TextEditTest, AppendChunksKeepsHistory) {
+  edit_->SetText("");
+  edit_->InsertText("a");
+  edit_->on_load_progress.Connect([](nu::TextEdit*, float progress) {
+    if (progress == 1.f)
+      nu::MessageLoop::Quit();
+  });
+  edit_->AppendChunks({"bc"});
+  // Edits made while loading are recorded.
+  edit_->InsertText("x");
+  nu::MessageLoop::Run();
+  EXPECT_EQ(edit_->GetText(), "axbc");
+  ASSERT_TRUE(edit_->CanUndo());
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "abc");
+  edit_->Undo();
+  EXPECT_EQ(edit_->GetText(), "bc");
+}
+
+TEST_F(TextEditTest, StyledRanges) {
+  GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(
+      g_object_get_data(G_OBJECT(edit_->GetNative()), "text-view")));
+  int changes = 0;
+  auto on_change = +[](GtkTextBuffer*, GtkTextTag*, GtkTextIter*,
+                       GtkTextIter*, int* changes) { (*changes)++; };
+  g_signal_connect(buffer, "apply-tag", G_CALLBACK(on_change), &changes);
+  g_signal_connect(buffer, "remove-tag", G_CALLBACK(on_change), &changes);
+
+  edit_->SetText("0123456789");
+  std::vector<nu::TextEdit::StyledRange> ranges(3);
+  ranges[0].start = 0;
+  ranges[0].end = 2;
+  ranges[0].color = nu::Color(255, 0, 0);
+  ranges[1].start = 2;
+  ranges[1].end = 4;
+  ranges[1].color = nu::Color(255, 0, 0);
+  ranges[2].start = 6;
+  ranges[2].end = 8;
+  ranges[2].background = nu::Color(0, 0, 255);
+  edit_->SetStyledRanges(ranges);
+  // Adjacent ranges with same style share one tag.
+  EXPECT_EQ(changes, 2);
+  GtkTextIter iter;
+  gtk_text_buffer_get_iter_at_offset(buffer, &iter, 3);
+  GSList* tags = gtk_text_iter_get_tags(&iter);
+  EXPECT_EQ(g_slist_length(tags), 1u);
+  g_slist_free(tags);
+
+  // Nothing is touched when styles do not change.
+  changes = 0;
+  edit_->SetStyledRanges(ranges);
+  EXPECT_EQ(changes, 0);
+
+  // Only styles in range are replaced.
+  edit_->SetStyledRangesInRange(5, 10, {});
+  EXPECT_EQ(changes, 1);
+  gtk_text_buffer_get_iter_at_offset(buffer, &iter, 7);
+  tags = gtk_text_iter_get_tags(&iter);
+  EXPECT_EQ(g_slist_length(tags), 0u);
+  g_slist_free(tags);
+  gtk_text_buffer_get_iter_at_offset(buffer, &iter, 1);
+  tags = gtk_text_iter_get_tags(&iter);
+  EXPECT_EQ(g_slist_length(tags), 1u);
+  g_slist_free(tags);
+}
+
+TEST_F(TextEditTest, HighlightOnWorkerThread) {
+  edit_->SetText("int a;");
+  int revision = edit_->GetRevision();
+  std::string text = edit_->GetText();
+  std::thread worker([this, revision, text]() {
+    std::vector<nu::TextEdit::StyledRange> ranges(1);
+    ranges[0].start = 0;
+    ranges[0].end = static_cast<int>(text.find(' '));
+    ranges[0].color = nu::Color(0, 0, 255);
+    nu::MessageLoop::PostTask([this, revision, ranges]() {
+      if (edit_->GetRevision() == revision)
+        edit_->SetStyledRanges(ranges);
+      nu::MessageLoop::Quit();
+    });
+  });
+  nu::MessageLoop::Run();
+  worker.join();
+  GtkTextBuffer* buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(
+      g_object_get_data(G_OBJECT(edit_->GetNative()), "text-view")));
+  GtkTextIter iter;
+  gtk_text_buffer_get_iter_at_offset(buffer, &iter, 2);
+  GSList* tags = gtk_text_iter_get_tags(&iter);
+  EXPECT_EQ(g_slist_length(tags), 1u);
+  g_slist_free(tags);
+  edit_->InsertText("b");
+  EXPECT_NE(edit_->GetRevision(), revision);
+}
+#endif
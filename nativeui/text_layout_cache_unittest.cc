@@ -0,0 +1,70 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include <string>
+
+#include "nativeui/gfx/text_layout_cache.h"
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class TextLayoutCacheTest : public testing::Test {
+ protected:
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  nu::TextLayoutCache cache_{4};
+};
+
+TEST_F(TextLayoutCacheTest, ReuseLayout) {
+  nu::TextAttributes attributes;
+  nu::SizeF size(100, 100);
+  scoped_refptr<nu::AttributedText> text1 = cache_.Get("a", attributes, size);
+  scoped_refptr<nu::AttributedText> text2 = cache_.Get("a", attributes, size);
+  EXPECT_EQ(text1, text2);
+  EXPECT_EQ(text1->GetText(), "a");
+  EXPECT_EQ(cache_.hits(), 1u);
+  EXPECT_EQ(cache_.misses(), 1u);
+}
+
+TEST_F(TextLayoutCacheTest, DifferentKeys) {
+  nu::TextAttributes attributes;
+  nu::SizeF size(100, 100);
+  scoped_refptr<nu::AttributedText> text = cache_.Get("a", attributes, size);
+  EXPECT_NE(text, cache_.Get("b", attributes, size));
+  EXPECT_NE(text, cache_.Get("a", attributes, nu::SizeF(50, 100)));
+  nu::TextAttributes red(nu::Color(255, 0, 0));
+  EXPECT_NE(text, cache_.Get("a", red, size));
+  EXPECT_EQ(cache_.hits(), 0u);
+  EXPECT_EQ(cache_.misses(), 4u);
+  // Size is ignored when not wrapping.
+  attributes.wrap = false;
+  text = cache_.Get("a", attributes, size);
+  EXPECT_EQ(text, cache_.Get("a", attributes, nu::SizeF(50, 100)));
+}
+
+TEST_F(TextLayoutCacheTest, Eviction) {
+  nu::TextAttributes attributes;
+  nu::SizeF size(100, 100);
+  for (int i = 0; i < 10; ++i)
+    cache_.Get(std::to_string(i), attributes, size);
+  EXPECT_EQ(cache_.size(), 4u);
+  cache_.ResetStats();
+  cache_.Get("9", attributes, size);
+  cache_.Get("0", attributes, size);
+  EXPECT_EQ(cache_.hits(), 1u);
+  EXPECT_EQ(cache_.misses(), 1u);
+  cache_.SetCapacity(2);
+  EXPECT_EQ(cache_.size(), 2u);
+  cache_.Clear();
+  EXPECT_EQ(cache_.size(), 0u);
+}
+
+TEST_F(TextLayoutCacheTest, DrawText) {
+  nu::TextLayoutCache* cache = state_.GetTextLayoutCache();
+  scoped_refptr<nu::Canvas> canvas = new nu::Canvas(nu::SizeF(100, 100));
+  for (int i = 0; i < 3; ++i)
+    canvas->GetPainter()->DrawText("text", nu::RectF(0, 0, 100, 100),
+                                   nu::TextAttributes());
+  EXPECT_EQ(cache->hits(), 2u);
+  EXPECT_EQ(cache->misses(), 1u);
+}
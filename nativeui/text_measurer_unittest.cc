@@ -0,0 +1,57 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "nativeui/gfx/text_measurer.h"
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+class TextMeasurerTest : public testing::Test {
+ protected:
+  nu::Lifetime lifetime_;
+  nu::State state_;
+};
+
+TEST_F(TextMeasurerTest, Empty) {
+  EXPECT_TRUE(nu::TextMeasurer::MeasureBatch({}, nu::TextAttributes(),
+                                             0).empty());
+}
+
+TEST_F(TextMeasurerTest, MeasureBatch) {
+  std::vector<nu::SizeF> sizes = nu::TextMeasurer::MeasureBatch(
+      {"a", "aaaaaaaaaa", "a"}, nu::TextAttributes(), 0);
+  ASSERT_EQ(sizes.size(), 3u);
+  EXPECT_GT(sizes[0].width(), 0);
+  EXPECT_GT(sizes[1].width(), sizes[0].width());
+  EXPECT_EQ(sizes[0], sizes[2]);
+}
+
+TEST_F(TextMeasurerTest, Wrap) {
+  std::string line(100, 'a');
+  float width = nu::TextMeasurer::MeasureBatch(
+      {line}, nu::TextAttributes(), 0)[0].width();
+  std::vector<nu::SizeF> sizes = nu::TextMeasurer::MeasureBatch(
+      {line}, nu::TextAttributes(), width / 2);
+  EXPECT_LE(sizes[0].width(), width / 2);
+  nu::TextAttributes no_wrap;
+  no_wrap.wrap = false;
+  sizes = nu::TextMeasurer::MeasureBatch({line}, no_wrap, width / 2);
+  EXPECT_EQ(sizes[0].width(), width);
+}
+
+TEST_F(TextMeasurerTest, LargeBatch) {
+  const std::vector<std::string> samples = {"short", "a longer string", "x"};
+  std::vector<nu::SizeF> expected = nu::TextMeasurer::MeasureBatch(
+      samples, nu::TextAttributes(), 0);
+  std::vector<std::string> strings;
+  for (int i = 0; i < 3000; ++i)
+    strings.push_back(samples[i % samples.size()]);
+  std::vector<nu::SizeF> sizes = nu::TextMeasurer::MeasureBatch(
+      strings, nu::TextAttributes(), 0);
+  ASSERT_EQ(sizes.size(), strings.size());
+  for (size_t i = 0; i < sizes.size(); ++i)
+    EXPECT_EQ(sizes[i], expected[i % samples.size()]) << "index " << i;
+}
@@ -0,0 +1,211 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/tree_model.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/logging.h"
+
+namespace nu {
+
+// static
+const TreeModel::NodeId TreeModel::kRootNode = 0;
+
+TreeModel::Item::Item() {}
+
+TreeModel::Item::Item(Item&&) = default;
+
+TreeModel::Item::~Item() {}
+
+TreeModel::Node::Node() {}
+
+TreeModel::Node::~Node() {}
+
+TreeModel::TreeModel(uint32_t columns) : columns_(columns) {
+  root_.id = kRootNode;
+  root_.expandable = true;
+}
+
+TreeModel::~TreeModel() {}
+
+TreeModel::NodeId TreeModel::AddNodes(NodeId parent, std::vector<Item> items) {
+  Node* node = GetNode(parent);
+  if (!node) {
+    LOG(ERROR) << "Adding children to unknown node " << parent;
+    return kRootNode;
+  }
+  NodeId first = next_id_;
+  node->expandable = true;
+  bool was_loaded = node->state == LoadState::Loaded;
+  node->state = LoadState::Loaded;
+
+  uint32_t start = static_cast<uint32_t>(node->children.size());
+  node->children.reserve(start + items.size());
+  for (Item& item : items) {
+    auto child = std::make_unique<Node>();
+    child->id = next_id_++;
+    child->parent = node;
+    child->index = static_cast<uint32_t>(node->children.size());
+    child->values = std::move(item.values);
+    child->values.resize(columns_);
+    child->expandable = item.expandable;
+    // Nodes without children have nothing to load.
+    if (!child->expandable)
+      child->state = LoadState::Loaded;
+    node->children.push_back(child.get());
+    nodes_[child->id] = std::move(child);
+  }
+  if (!items.empty()) {
+    for (TreeModelObserver* observer : observers_)
+      observer->OnNodesInserted(this, parent, start,
+                                static_cast<uint32_t>(items.size()));
+  }
+  // Notify after inserting children, so views can replace the placeholder
+  // without collapsing the node.
+  if (!was_loaded) {
+    for (TreeModelObserver* observer : observers_)
+      observer->OnNodeLoadStateChanged(this, parent);
+  }
+  return first;
+}
+
+TreeModel::NodeId TreeModel::AddNode(NodeId parent, Item item) {
+  std::vector<Item> items;
+  items.push_back(std::move(item));
+  return AddNodes(parent, std::move(items));
+}
+
+void TreeModel::RemoveNode(NodeId id) {
+  Node* node = GetNode(id);
+  if (!node || node == &root_)
+    return;
+  RemoveChildren(node->parent, node->index, 1);
+}
+
+void TreeModel::UnloadChildren(NodeId id) {
+  Node* node = GetNode(id);
+  // A node that is still loading has no children to unload, and the pending
+  // fetch_children would finish into a node the observers think is unloaded.
+  if (!node || node->state != LoadState::Loaded)
+    return;
+  RemoveChildren(node, 0, static_cast<uint32_t>(node->children.size()));
+  node->state = LoadState::NotLoaded;
+  for (TreeModelObserver* observer : observers_)
+    observer->OnNodeLoadStateChanged(this, id);
+}
+
+void TreeModel::Clear() {
+  RemoveChildren(&root_, 0, static_cast<uint32_t>(root_.children.size()));
+}
+
+void TreeModel::LoadChildren(NodeId id) {
+  Node* node = GetNode(id);
+  if (!node || node->state != LoadState::NotLoaded)
+    return;
+  node->state = LoadState::Loading;
+  if (fetch_children)
+    fetch_children(this, id);
+  else
+    AddNodes(id, std::vector<Item>());
+}
+
+bool TreeModel::IsLoaded(NodeId id) const {
+  Node* node = GetNode(id);
+  return node && node->state == LoadState::Loaded;
+}
+
+bool TreeModel::IsLoading(NodeId id) const {
+  Node* node = GetNode(id);
+  return node && node->state == LoadState::Loading;
+}
+
+bool TreeModel::IsExpandable(NodeId id) const {
+  Node* node = GetNode(id);
+  return node && node->expandable;
+}
+
+bool TreeModel::HasNode(NodeId id) const {
+  return GetNode(id) != nullptr;
+}
+
+TreeModel::NodeId TreeModel::GetParent(NodeId id) const {
+  Node* node = GetNode(id);
+  return node && node->parent ? node->parent->id : kRootNode;
+}
+
+uint32_t TreeModel::GetChildCount(NodeId id) const {
+  Node* node = GetNode(id);
+  return node ? static_cast<uint32_t>(node->children.size()) : 0;
+}
+
+TreeModel::NodeId TreeModel::GetChildAt(NodeId id, uint32_t index) const {
+  Node* node = GetNode(id);
+  if (!node || index >= node->children.size())
+    return kRootNode;
+  return node->children[index]->id;
+}
+
+uint32_t TreeModel::GetIndex(NodeId id) const {
+  Node* node = GetNode(id);
+  return node ? node->index : 0;
+}
+
+const base::Value* TreeModel::GetValue(NodeId id, uint32_t column) const {
+  Node* node = GetNode(id);
+  if (!node || node == &root_ || column >= columns_)
+    return nullptr;
+  return &node->values[column];
+}
+
+void TreeModel::SetValue(NodeId id, uint32_t column, base::Value value) {
+  Node* node = GetNode(id);
+  if (!node || node == &root_ || column >= columns_)
+    return;
+  node->values[column] = std::move(value);
+  for (TreeModelObserver* observer : observers_)
+    observer->OnNodeChanged(this, id);
+}
+
+void TreeModel::AddObserver(TreeModelObserver* observer) {
+  observers_.push_back(observer);
+}
+
+void TreeModel::RemoveObserver(TreeModelObserver* observer) {
+  observers_.remove(observer);
+}
+
+TreeModel::Node* TreeModel::GetNode(NodeId id) const {
+  if (id == kRootNode)
+    return const_cast<Node*>(&root_);
+  auto it = nodes_.find(id);
+  return it == nodes_.end() ? nullptr : it->second.get();
+}
+
+void TreeModel::RemoveChildren(Node* node, uint32_t start, uint32_t count) {
+  if (count == 0 || start >= node->children.size())
+    return;
+  count = std::min(count,
+                   static_cast<uint32_t>(node->children.size()) - start);
+  auto begin = node->children.begin() + start;
+  auto end = begin + count;
+  std::vector<Node*> removed(begin, end);
+  node->children.erase(begin, end);
+  for (uint32_t i = start; i < node->children.size(); ++i)
+    node->children[i]->index = i;
+  for (TreeModelObserver* observer : observers_)
+    observer->OnNodesDeleted(this, node->id, start, count);
+  // Free nodes after notifying, so observers can still look them up.
+  for (Node* child : removed)
+    FreeNode(child);
+}
+
+void TreeModel::FreeNode(Node* node) {
+  for (Node* child : node->children)
+    FreeNode(child);
+  nodes_.erase(node->id);
+}
+
+}  // namespace nu
@@ -0,0 +1,150 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_TREE_MODEL_H_
+#define NATIVEUI_TREE_MODEL_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/values.h"
+#include "nativeui/nativeui_export.h"
+
+namespace nu {
+
+class TreeModel;
+
+// Receives changes of a TreeModel.
+//
+// The changes are always about a range of children under one parent, and
+// removing a node also removes all of its descendants.
+class NATIVEUI_EXPORT TreeModelObserver {
+ public:
+  virtual void OnNodesInserted(TreeModel* model, uint32_t parent,
+                               uint32_t start, uint32_t count) = 0;
+  virtual void OnNodesDeleted(TreeModel* model, uint32_t parent,
+                              uint32_t start, uint32_t count) = 0;
+  virtual void OnNodeChanged(TreeModel* model, uint32_t node) = 0;
+  // The children of |node| have become loaded or unloaded, this is called
+  // after the loaded children have been inserted, and after the unloaded
+  // children have been removed.
+  virtual void OnNodeLoadStateChanged(TreeModel* model, uint32_t node) = 0;
+
+ protected:
+  virtual ~TreeModelObserver() {}
+};
+
+// A tree of nodes whose children are only loaded when they are needed.
+//
+// Nodes are identified by ids, which stay valid until the nodes are removed.
+// Only the loaded nodes are kept in memory, so the cost scales with the
+// expanded nodes instead of the whole tree.
+class NATIVEUI_EXPORT TreeModel : public base::RefCounted<TreeModel> {
+ public:
+  using NodeId = uint32_t;
+  using Row = std::vector<base::Value>;
+
+  // The invisible root node, whose children are top level nodes.
+  static const NodeId kRootNode;
+
+  struct NATIVEUI_EXPORT Item {
+    Item();
+    Item(Item&&);
+    ~Item();
+
+    Row values;
+    // Whether the node may have children, the children are loaded when
+    // they are needed.
+    bool expandable = false;
+  };
+
+  explicit TreeModel(uint32_t columns);
+
+  // Append nodes to |parent| and mark its children as loaded, return the id
+  // of first new node, the ids of new nodes are consecutive.
+  //
+  // This is also how fetch_children finishes loading, passing an empty list
+  // means |parent| has no children.
+  NodeId AddNodes(NodeId parent, std::vector<Item> items);
+  NodeId AddNode(NodeId parent, Item item);
+  // Remove |node| and all of its descendants.
+  void RemoveNode(NodeId node);
+  // Remove the children of |node| and mark them as not loaded, so they are
+  // loaded again next time they are needed. Does nothing if the children are
+  // not loaded or still loading.
+  void UnloadChildren(NodeId node);
+  // Remove all nodes.
+  void Clear();
+
+  // Request loading the children of |node| if they are not loaded.
+  void LoadChildren(NodeId node);
+  bool IsLoaded(NodeId node) const;
+  bool IsLoading(NodeId node) const;
+  bool IsExpandable(NodeId node) const;
+
+  bool HasNode(NodeId node) const;
+  NodeId GetParent(NodeId node) const;
+  uint32_t GetChildCount(NodeId node) const;
+  NodeId GetChildAt(NodeId node, uint32_t index) const;
+  // Return the index of |node| in its parent.
+  uint32_t GetIndex(NodeId node) const;
+  // Return how many nodes are loaded.
+  size_t GetNodeCount() const { return nodes_.size(); }
+
+  uint32_t GetColumnCount() const { return columns_; }
+  const base::Value* GetValue(NodeId node, uint32_t column) const;
+  void SetValue(NodeId node, uint32_t column, base::Value value);
+
+  void AddObserver(TreeModelObserver* observer);
+  void RemoveObserver(TreeModelObserver* observer);
+
+  // Called when the children of a node are needed, the delegate should call
+  // AddNodes for the node, either immediately or later.
+  std::function<void(TreeModel*, NodeId)> fetch_children;
+
+ protected:
+  virtual ~TreeModel();
+
+ private:
+  friend class base::RefCounted<TreeModel>;
+
+  enum class LoadState {
+    NotLoaded,
+    Loading,
+    Loaded,
+  };
+
+  struct Node {
+    Node();
+    ~Node();
+
+    NodeId id = 0;
+    Node* parent = nullptr;
+    uint32_t index = 0;
+    Row values;
+    bool expandable = false;
+    LoadState state = LoadState::NotLoaded;
+    std::vector<Node*> children;
+  };
+
+  Node* GetNode(NodeId node) const;
+  // Remove |count| children of |node| starting at |start|.
+  void RemoveChildren(Node* node, uint32_t start, uint32_t count);
+  // Free |node| and its descendants.
+  void FreeNode(Node* node);
+
+  const uint32_t columns_;
+  Node root_;
+  NodeId next_id_ = 1;
+  std::unordered_map<NodeId, std::unique_ptr<Node>> nodes_;
+  std::list<TreeModelObserver*> observers_;
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_TREE_MODEL_H_
@@ -0,0 +1,154 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/nativeui.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using NodeId = nu::TreeModel::NodeId;
+
+class TreeModelTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    model_ = new nu::TreeModel(1);
+  }
+
+  std::vector<nu::TreeModel::Item> CreateItems(int count, bool expandable) {
+    std::vector<nu::TreeModel::Item> items;
+    for (int i = 0; i < count; ++i) {
+      nu::TreeModel::Item item;
+      item.values.emplace_back(i);
+      item.expandable = expandable;
+      items.push_back(std::move(item));
+    }
+    return items;
+  }
+
+  nu::Lifetime lifetime_;
+  nu::State state_;
+  scoped_refptr<nu::TreeModel> model_;
+};
+
+TEST_F(TreeModelTest, AddAndRemoveNodes) {
+  NodeId first = model_->AddNodes(nu::TreeModel::kRootNode,
+                                  CreateItems(3, true));
+  ASSERT_EQ(model_->GetChildCount(nu::TreeModel::kRootNode), 3u);
+  NodeId second = model_->GetChildAt(nu::TreeModel::kRootNode, 1);
+  EXPECT_EQ(second, first + 1);
+  EXPECT_EQ(model_->GetIndex(second), 1u);
+  EXPECT_EQ(model_->GetParent(second), nu::TreeModel::kRootNode);
+  EXPECT_EQ(*model_->GetValue(second, 0), base::Value(1));
+  EXPECT_EQ(model_->GetValue(second, 1), nullptr);
+
+  NodeId child = model_->AddNodes(second, CreateItems(2, false));
+  EXPECT_EQ(model_->GetParent(child), second);
+  EXPECT_EQ(model_->GetNodeCount(), 5u);
+
+  // Removing node removes its descendants, and ids of others are kept.
+  model_->RemoveNode(first);
+  EXPECT_FALSE(model_->HasNode(first));
+  EXPECT_EQ(model_->GetIndex(second), 0u);
+  EXPECT_EQ(model_->GetChildAt(nu::TreeModel::kRootNode, 0), second);
+  model_->RemoveNode(second);
+  EXPECT_FALSE(model_->HasNode(child));
+  EXPECT_EQ(model_->GetNodeCount(), 1u);
+}
+
+TEST_F(TreeModelTest, LoadChildrenOnDemand) {
+  int loads = 0;
+  model_->fetch_children = [&](nu::TreeModel* model, NodeId node) {
+    ++loads;
+    model->AddNodes(node, CreateItems(10, node == nu::TreeModel::kRootNode));
+  };
+  model_->LoadChildren(nu::TreeModel::kRootNode);
+  EXPECT_EQ(loads, 1);
+  // Children of top level nodes are not loaded.
+  EXPECT_EQ(model_->GetNodeCount(), 10u);
+  NodeId node = model_->GetChildAt(nu::TreeModel::kRootNode, 5);
+  EXPECT_FALSE(model_->IsLoaded(node));
+  model_->LoadChildren(node);
+  model_->LoadChildren(node);
+  EXPECT_EQ(loads, 2);
+  EXPECT_TRUE(model_->IsLoaded(node));
+  EXPECT_EQ(model_->GetNodeCount(), 20u);
+  // Unloaded children are loaded again.
+  model_->UnloadChildren(node);
+  EXPECT_FALSE(model_->IsLoaded(node));
+  EXPECT_EQ(model_->GetNodeCount(), 10u);
+  model_->LoadChildren(node);
+  EXPECT_EQ(loads, 3);
+}
+
+TEST_F(TreeModelTest, LoadChildrenAsync) {
+  model_->fetch_children = [&](nu::TreeModel* model, NodeId node) {
+    scoped_refptr<nu::TreeModel> ref(model);
+    nu::MessageLoop::PostTask([=]() {
+      ref->AddNodes(node, CreateItems(2, false));
+      nu::MessageLoop::Quit();
+    });
+  };
+  model_->LoadChildren(nu::TreeModel::kRootNode);
+  EXPECT_TRUE(model_->IsLoading(nu::TreeModel::kRootNode));
+  nu::MessageLoop::Run();
+  EXPECT_TRUE(model_->IsLoaded(nu::TreeModel::kRootNode));
+  EXPECT_EQ(model_->GetChildCount(nu::TreeModel::kRootNode), 2u);
+}
+
+class LoadStateObserver : public nu::TreeModelObserver {
+ public:
+  void OnNodesInserted(nu::TreeModel*, uint32_t, uint32_t, uint32_t) override {}
+  void OnNodesDeleted(nu::TreeModel*, uint32_t, uint32_t, uint32_t) override {}
+  void OnNodeChanged(nu::TreeModel*, uint32_t) override {}
+  void OnNodeLoadStateChanged(nu::TreeModel*, uint32_t) override {
+    ++changes;
+  }
+
+  int changes = 0;
+};
+
+TEST_F(TreeModelTest, UnloadChildrenWhileLoading) {
+  model_->fetch_children = [&](nu::TreeModel* model, NodeId node) {
+    scoped_refptr<nu::TreeModel> ref(model);
+    nu::MessageLoop::PostTask([=]() {
+      ref->AddNodes(node, CreateItems(2, false));
+      nu::MessageLoop::Quit();
+    });
+  };
+  model_->LoadChildren(nu::TreeModel::kRootNode);
+  LoadStateObserver observer;
+  model_->AddObserver(&observer);
+  // Unloading a node that is still loading is ignored.
+  model_->UnloadChildren(nu::TreeModel::kRootNode);
+  EXPECT_TRUE(model_->IsLoading(nu::TreeModel::kRootNode));
+  EXPECT_EQ(observer.changes, 0);
+  nu::MessageLoop::Run();
+  EXPECT_TRUE(model_->IsLoaded(nu::TreeModel::kRootNode));
+  EXPECT_EQ(observer.changes, 1);
+  model_->RemoveObserver(&observer);
+}
+
+#if defined(OS_LINUX)
+TEST_F(TreeModelTest, WithTreeView) {
+  model_->fetch_children = [&](nu::TreeModel* model, NodeId node) {
+    model->AddNodes(node, CreateItems(3, true));
+  };
+  scoped_refptr<nu::TreeView> view = new nu::TreeView;
+  view->AddColumn("A");
+  view->SetModel(model_.get());
+  // Only top level nodes are loaded.
+  EXPECT_EQ(model_->GetNodeCount(), 3u);
+  NodeId node = model_->GetChildAt(nu::TreeModel::kRootNode, 1);
+  view->ExpandNode(node);
+  EXPECT_TRUE(view->IsNodeExpanded(node));
+  EXPECT_EQ(model_->GetNodeCount(), 6u);
+  NodeId child = model_->GetChildAt(node, 2);
+  view->SelectNode(child);
+  EXPECT_EQ(view->GetSelectedNode(), child);
+  // Nodes after the selected one can be removed.
+  model_->RemoveNode(model_->GetChildAt(nu::TreeModel::kRootNode, 2));
+  EXPECT_EQ(view->GetSelectedNode(), child);
+  model_->UnloadChildren(node);
+  EXPECT_FALSE(view->IsNodeExpanded(node));
+  EXPECT_EQ(view->GetSelectedNode(), nu::TreeModel::kRootNode);
+}
+#endif
@@ -0,0 +1,64 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_TREE_VIEW_H_
+#define NATIVEUI_TREE_VIEW_H_
+
+#include <string>
+
+#include "nativeui/tree_model.h"
+#include "nativeui/view.h"
+
+namespace nu {
+
+// Shows the nodes of a TreeModel, the children of nodes are loaded when they
+// are expanded.
+class NATIVEUI_EXPORT TreeView : public View,
+                                 public TreeModelObserver {
+ public:
+  using NodeId = TreeModel::NodeId;
+
+  TreeView();
+
+  // View class name.
+  static const char kClassName[];
+
+  void SetModel(TreeModel* model);
+  TreeModel* GetModel();
+  // Add a column showing the values of next column in model.
+  void AddColumn(const std::string& title);
+  int GetColumnCount() const;
+  void SetColumnsVisible(bool visible);
+  bool IsColumnsVisible() const;
+  // Set the text shown under a node while its children are being loaded.
+  void SetLoadingText(const std::string& text);
+
+  void ExpandNode(NodeId node);
+  void CollapseNode(NodeId node);
+  bool IsNodeExpanded(NodeId node) const;
+  void SelectNode(NodeId node);
+  // Return kRootNode if nothing is selected.
+  NodeId GetSelectedNode() const;
+
+  // View:
+  const char* GetClassName() const override;
+
+  // TreeModelObserver:
+  void OnNodesInserted(TreeModel* model, NodeId parent,
+                       uint32_t start, uint32_t count) override;
+  void OnNodesDeleted(TreeModel* model, NodeId parent,
+                      uint32_t start, uint32_t count) override;
+  void OnNodeChanged(TreeModel* model, NodeId node) override;
+  void OnNodeLoadStateChanged(TreeModel* model, NodeId node) override;
+
+ protected:
+  ~TreeView() override;
+
+ private:
+  scoped_refptr<TreeModel> model_;
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_TREE_VIEW_H_
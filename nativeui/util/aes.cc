@@ -2,8 +2,11 @@
 // Originially from https://github.com/kokke/tiny-AES-c.
 
 // This is an implementation of the AES algorithm, specifically ECB, CTR and
-// CBC mode. Block size can be chosen in aes.h - available choices are AES128,
-// AES192, AES256.
+// CBC mode. The key size is chosen by the length of key - available choices are
+// AES128, AES192, AES256.
+//
+// On x86 CPUs supporting AES-NI, the CBC decryption is done with the AES
+// instructions, which is an order of magnitude faster.
 //
 // The implementation is verified against the test vectors in:
 //   National Institute of Standards and Technology Special Publication
@@ -32,20 +35,25 @@
 
 #include <string.h>
 
-// The number of columns comprising a state in AES.
-// This is a constant in AES. Value=4.
-#define Nb 4
+#include "build/build_config.h"
+
+#if defined(ARCH_CPU_X86_FAMILY)
+#include <wmmintrin.h>
+
+#include "base/cpu.h"
 
-#if defined(AES256) && (AES256 == 1)
-  #define Nk 8
-  #define Nr 14
-#elif defined(AES192) && (AES192 == 1)
-  #define Nk 6
-  #define Nr 12
+// Allow using AES instructions in functions without compiling the whole file
+// with -maes.
+#if defined(COMPILER_GCC)
+#define AESNI_FUNCTION __attribute__((target("aes,sse2")))
 #else
-  #define Nk 4   // The number of 32 bit words in a key.
-  #define Nr 10  // The number of rounds in AES Cipher.
+#define AESNI_FUNCTION
 #endif
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
+// The number of columns comprising a state in AES.
+// This is a constant in AES. Value=4.
+#define Nb 4
 
 namespace nu {
 
@@ -125,7 +133,11 @@ inline uint8_t getSBoxInvert(uint8_t num) {
 
 // This function produces Nb(Nr+1) round keys. The round keys are used in each
 // round to decrypt the states.
-void KeyExpansion(uint8_t* RoundKey, const uint8_t* Key) {
+//
+// The Nk is the number of 32 bit words in a key, and Nr = Nk + 6 is the number
+// of rounds in AES Cipher.
+void KeyExpansion(uint8_t* RoundKey, const uint8_t* Key, int Nk) {
+  int Nr = Nk + 6;
   uint8_t tempa[4];  // used for the column/row operations
 
   // The first round key is the key itself.
@@ -167,15 +179,13 @@ void KeyExpansion(uint8_t* RoundKey, const uint8_t* Key) {
       tempa[0] = tempa[0] ^ Rcon[i/Nk];
     }
 
-#if defined(AES256) && (AES256 == 1)
-    if (i % Nk == 4) {
+    if (Nk == 8 && i % Nk == 4) {
       // Function Subword()
       tempa[0] = getSBoxValue(tempa[0]);
       tempa[1] = getSBoxValue(tempa[1]);
       tempa[2] = getSBoxValue(tempa[2]);
       tempa[3] = getSBoxValue(tempa[3]);
     }
-#endif
 
     int j = i * 4;
     k = (i - Nk) * 4;
@@ -188,7 +198,7 @@ void KeyExpansion(uint8_t* RoundKey, const uint8_t* Key) {
 
 // This function adds the round key to state.
 // The round key is added to the state by an XOR function.
-void AddRoundKey(uint8_t round, state_t* state, uint8_t* RoundKey) {
+void AddRoundKey(uint8_t round, state_t* state, const uint8_t* RoundKey) {
   for (int i = 0; i < 4; ++i)
     for (int j = 0; j < 4; ++j)
       (*state)[i][j] ^= RoundKey[(round * Nb * 4) + (i * Nb) + j];
@@ -313,7 +323,7 @@ void InvShiftRows(state_t* state) {
 }
 
 // Cipher is the main function that encrypts the PlainText.
-void Cipher(state_t* state, uint8_t* RoundKey) {
+void Cipher(state_t* state, const uint8_t* RoundKey, int Nr) {
   // Add the First round key to the state before starting the rounds.
   AddRoundKey(0, state, RoundKey);
 
@@ -334,7 +344,7 @@ void Cipher(state_t* state, uint8_t* RoundKey) {
   AddRoundKey(Nr, state, RoundKey);
 }
 
-void InvCipher(state_t* state, uint8_t* RoundKey) {
+void InvCipher(state_t* state, const uint8_t* RoundKey, int Nr) {
   // Add the First round key to the state before starting the rounds.
   AddRoundKey(Nr, state, RoundKey);
 
@@ -355,28 +365,103 @@ void InvCipher(state_t* state, uint8_t* RoundKey) {
   AddRoundKey(0, state, RoundKey);
 }
 
-void XorWithIv(uint8_t* buf, uint8_t* iv) {
+void XorWithIv(uint8_t* buf, const uint8_t* iv) {
   // The block in AES is always 128bit no matter the key size.
   for (int i = 0; i < AES_BLOCKLEN; ++i)
     buf[i] ^= iv[i];
 }
 
+#if defined(ARCH_CPU_X86_FAMILY)
+// The AES-NI decryption uses the "Equivalent Inverse Cipher", whose round keys
+// are the encryption round keys in reverse order with InvMixColumns applied.
+AESNI_FUNCTION
+void AESNIExpandDecryptKey(const uint8_t* round_key, int rounds,
+                           uint8_t* dec_round_key) {
+  const __m128i* in = reinterpret_cast<const __m128i*>(round_key);
+  __m128i* out = reinterpret_cast<__m128i*>(dec_round_key);
+  _mm_storeu_si128(out, _mm_loadu_si128(in + rounds));
+  for (int i = 1; i < rounds; ++i) {
+    _mm_storeu_si128(out + i,
+                     _mm_aesimc_si128(_mm_loadu_si128(in + rounds - i)));
+  }
+  _mm_storeu_si128(out + rounds, _mm_loadu_si128(in));
+}
+
+AESNI_FUNCTION
+void AESNICBCDecrypt(uint8_t* buf, size_t len, const uint8_t* dec_round_key,
+                     int rounds, uint8_t* iv) {
+  __m128i keys[15];
+  for (int i = 0; i <= rounds; ++i)
+    keys[i] = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(dec_round_key) + i);
+  __m128i* data = reinterpret_cast<__m128i*>(buf);
+  __m128i prev = _mm_loadu_si128(reinterpret_cast<__m128i*>(iv));
+  size_t blocks = len / AES_BLOCKLEN;
+  size_t i = 0;
+  // Unlike encryption, the blocks can be decrypted independently in CBC mode,
+  // so decrypt 4 blocks at a time to hide the latency of AES instructions.
+  for (; i + 4 <= blocks; i += 4) {
+    __m128i c0 = _mm_loadu_si128(data + i);
+    __m128i c1 = _mm_loadu_si128(data + i + 1);
+    __m128i c2 = _mm_loadu_si128(data + i + 2);
+    __m128i c3 = _mm_loadu_si128(data + i + 3);
+    __m128i b0 = _mm_xor_si128(c0, keys[0]);
+    __m128i b1 = _mm_xor_si128(c1, keys[0]);
+    __m128i b2 = _mm_xor_si128(c2, keys[0]);
+    __m128i b3 = _mm_xor_si128(c3, keys[0]);
+    for (int r = 1; r < rounds; ++r) {
+      b0 = _mm_aesdec_si128(b0, keys[r]);
+      b1 = _mm_aesdec_si128(b1, keys[r]);
+      b2 = _mm_aesdec_si128(b2, keys[r]);
+      b3 = _mm_aesdec_si128(b3, keys[r]);
+    }
+    b0 = _mm_aesdeclast_si128(b0, keys[rounds]);
+    b1 = _mm_aesdeclast_si128(b1, keys[rounds]);
+    b2 = _mm_aesdeclast_si128(b2, keys[rounds]);
+    b3 = _mm_aesdeclast_si128(b3, keys[rounds]);
+    _mm_storeu_si128(data + i, _mm_xor_si128(b0, prev));
+    _mm_storeu_si128(data + i + 1, _mm_xor_si128(b1, c0));
+    _mm_storeu_si128(data + i + 2, _mm_xor_si128(b2, c1));
+    _mm_storeu_si128(data + i + 3, _mm_xor_si128(b3, c2));
+    prev = c3;
+  }
+  for (; i < blocks; ++i) {
+    __m128i c = _mm_loadu_si128(data + i);
+    __m128i b = _mm_xor_si128(c, keys[0]);
+    for (int r = 1; r < rounds; ++r)
+      b = _mm_aesdec_si128(b, keys[r]);
+    b = _mm_aesdeclast_si128(b, keys[rounds]);
+    _mm_storeu_si128(data + i, _mm_xor_si128(b, prev));
+    prev = c;
+  }
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(iv), prev);
+}
+#endif  // defined(ARCH_CPU_X86_FAMILY)
+
 }  // namespace
 
 bool AES::Init(const std::string& key, const std::string& iv) {
-  if (key.size() != AES_BLOCKLEN || iv.size() != AES_BLOCKLEN)
+  if ((key.size() != 16 && key.size() != 24 && key.size() != 32) ||
+      iv.size() != AES_BLOCKLEN)
     return false;
-  KeyExpansion(round_key_, (uint8_t*)(key.data()));
+  int nk = static_cast<int>(key.size() / 4);
+  rounds_ = nk + 6;
+  KeyExpansion(round_key_, (uint8_t*)(key.data()), nk);
   memcpy(iv_, (uint8_t*)(iv.data()), AES_BLOCKLEN);
+#if defined(ARCH_CPU_X86_FAMILY)
+  use_aesni_ = base::CPU().has_aesni();
+  if (use_aesni_)
+    AESNIExpandDecryptKey(round_key_, rounds_, dec_round_key_);
+#endif
   is_valid_ = true;
   return true;
 }
 
-void AES::CBCEncryptBuffer(uint8_t* buf, uint32_t len) {
+void AES::CBCEncryptBuffer(uint8_t* buf, size_t len) {
   uint8_t* iv = iv_;
-  for (uint32_t i = 0; i < len; i += AES_BLOCKLEN) {
+  for (size_t i = 0; i < len; i += AES_BLOCKLEN) {
     XorWithIv(buf, iv);
-    Cipher((state_t*)buf, round_key_);
+    Cipher((state_t*)buf, round_key_, rounds_);
     iv = buf;
     buf += AES_BLOCKLEN;
   }
@@ -384,11 +469,17 @@ void AES::CBCEncryptBuffer(uint8_t* buf, uint32_t len) {
   memcpy(iv_, iv, AES_BLOCKLEN);
 }
 
-void AES::CBCDecryptBuffer(uint8_t* buf, uint32_t len) {
+void AES::CBCDecryptBuffer(uint8_t* buf, size_t len) {
+#if defined(ARCH_CPU_X86_FAMILY)
+  if (use_aesni_) {
+    AESNICBCDecrypt(buf, len, dec_round_key_, rounds_, iv_);
+    return;
+  }
+#endif
   uint8_t storeNextIv[AES_BLOCKLEN];
-  for (uint32_t i = 0; i < len; i += AES_BLOCKLEN) {
+  for (size_t i = 0; i < len; i += AES_BLOCKLEN) {
     memcpy(storeNextIv, buf, AES_BLOCKLEN);
-    InvCipher((state_t*)buf, round_key_);
+    InvCipher((state_t*)buf, round_key_, rounds_);
     XorWithIv(buf, iv_);
     memcpy(iv_, storeNextIv, AES_BLOCKLEN);
     buf += AES_BLOCKLEN;
@@ -4,38 +4,42 @@
 #ifndef NATIVEUI_UTIL_AES_H_
 #define NATIVEUI_UTIL_AES_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <string>
 
-#define AES128 1
 #define AES_BLOCKLEN 16
-
-#if defined(AES256) && (AES256 == 1)
-  #define AES_KEYLEN 32
-  #define AES_KEYEXPSIZE 240
-#elif defined(AES192) && (AES192 == 1)
-  #define AES_KEYLEN 24
-  #define AES_KEYEXPSIZE 208
-#else
-  #define AES_KEYLEN 16
-  #define AES_KEYEXPSIZE 176
-#endif
+// Enough for the expanded key of AES256.
+#define AES_KEYEXPSIZE 240
 
 namespace nu {
 
 class AES {
  public:
+  // The |key| can be 16, 24 or 32 bytes for AES128, AES192 or AES256, the |iv|
+  // must be 16 bytes.
   bool Init(const std::string& key, const std::string& iv);
   bool IsValid() const { return is_valid_; }
 
-  void CBCEncryptBuffer(uint8_t* buf, uint32_t len);
-  void CBCDecryptBuffer(uint8_t* buf, uint32_t len);
+  // Use the portable implementation even when the CPU supports AES-NI, used
+  // for testing and benchmarking.
+  void DisableAcceleration() { use_aesni_ = false; }
+  bool IsAccelerated() const { return use_aesni_; }
+
+  // The |len| must be a multiple of AES_BLOCKLEN, the buffer is processed in
+  // place and the state is kept for next call.
+  void CBCEncryptBuffer(uint8_t* buf, size_t len);
+  void CBCDecryptBuffer(uint8_t* buf, size_t len);
 
  private:
   bool is_valid_ = false;
+  bool use_aesni_ = false;
+  int rounds_ = 0;
 
   uint8_t round_key_[AES_KEYEXPSIZE];
+  // The round keys transformed for AES-NI decryption.
+  uint8_t dec_round_key_[AES_KEYEXPSIZE];
   uint8_t iv_[AES_BLOCKLEN];
 };
 
@@ -0,0 +1,76 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/util/worker_pool.h"
+
+#include <queue>
+#include <thread>
+#include <utility>
+
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+
+namespace nu {
+
+namespace {
+
+// Threads are only created when there are tasks waiting and no idle thread.
+const int kMaxThreads = 4;
+
+class Pool {
+ public:
+  Pool() : cv_(&lock_) {}
+
+  void PostTask(WorkerPool::Task task) {
+    base::AutoLock auto_lock(lock_);
+    tasks_.push(std::move(task));
+    if (idle_threads_ == 0 && threads_ < kMaxThreads) {
+      ++threads_;
+      // The pool lives until process exits, so are the threads.
+      std::thread(&Pool::Run, this).detach();
+    } else {
+      cv_.Signal();
+    }
+  }
+
+ private:
+  void Run() {
+    while (true) {
+      WorkerPool::Task task;
+      {
+        base::AutoLock auto_lock(lock_);
+        ++idle_threads_;
+        while (tasks_.empty())
+          cv_.Wait();
+        --idle_threads_;
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  base::Lock lock_;
+  base::ConditionVariable cv_;
+  std::queue<WorkerPool::Task> tasks_;
+  int threads_ = 0;
+  int idle_threads_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(Pool);
+};
+
+Pool* GetPool() {
+  // Intentionally leaked, worker threads may still be running when exiting.
+  static Pool* pool = new Pool;
+  return pool;
+}
+
+}  // namespace
+
+// static
+void WorkerPool::PostTask(Task task) {
+  GetPool()->PostTask(std::move(task));
+}
+
+}  // namespace nu
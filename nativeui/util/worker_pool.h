@@ -0,0 +1,31 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_UTIL_WORKER_POOL_H_
+#define NATIVEUI_UTIL_WORKER_POOL_H_
+
+#include <functional>
+
+#include "base/macros.h"
+#include "nativeui/nativeui_export.h"
+
+namespace nu {
+
+// Runs blocking tasks like file I/O on a few shared worker threads. All
+// methods are thread-safe.
+class NATIVEUI_EXPORT WorkerPool {
+ public:
+  using Task = std::function<void()>;
+
+  // Run |task| on a worker thread, tasks are run in the order they are
+  // posted but may finish in any order.
+  static void PostTask(Task task);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(WorkerPool);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_UTIL_WORKER_POOL_H_
@@ -91,6 +91,21 @@ IFACEMETHODIMP BrowserExternalSink::Invoke(
     return E_INVALIDARG;
   if (dispIdMember != kInvokeId || !(wFlags & DISPATCH_METHOD))
     return E_INVALIDARG;
+  // Messages of the message port, arguments are in reverse order.
+  if (pDispParams->cArgs == 2 &&
+      pDispParams->rgvarg[0].vt == VT_BSTR &&
+      pDispParams->rgvarg[1].vt == VT_BSTR) {
+    std::unique_ptr<base::Value> pv = base::JSONReader::Read(
+        base::UTF16ToUTF8(pDispParams->rgvarg[0].bstrVal));
+    if (!pv || !pv->is_list()) {
+      LOG(ERROR) << "Invalid message passed: "
+                 << pDispParams->rgvarg[0].bstrVal;
+      return E_INVALIDARG;
+    }
+    return browser_->InvokeMessagePort(
+        base::UTF16ToUTF8(pDispParams->rgvarg[1].bstrVal),
+        std::move(*pv.release())) ? S_OK : E_INVALIDARG;
+  }
   if (pDispParams->cArgs != 3 ||
       pDispParams->rgvarg[0].vt != VT_BSTR ||
       pDispParams->rgvarg[1].vt != VT_BSTR ||
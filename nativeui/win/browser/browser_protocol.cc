@@ -59,11 +59,12 @@ IFACEMETHODIMP BrowserProtocol::Start(LPCWSTR szUrl,
 
   // Start the job.
   sink_ = pIProtSink;
-  protocol_job_->Plug([this](int size) {
+  protocol_job_->Plug([this](int64_t size) {
+    content_length_ = size;
     sink_->ReportData(BSCF_FIRSTDATANOTIFICATION |
                       BSCF_LASTDATANOTIFICATION |
                       BSCF_DATAFULLYAVAILABLE,
-                      0, size);
+                      0, static_cast<ULONG>(size));
   });
   std::string mime_type;
   if (protocol_job_->GetMimeType(&mime_type)) {
@@ -105,13 +106,29 @@ IFACEMETHODIMP BrowserProtocol::Read(void *pv, ULONG cb, ULONG *pcbRead) {
     return S_FALSE;
   }
   *pcbRead = static_cast<ULONG>(nread);
+  position_ += nread;
   return S_OK;
 }
 
 IFACEMETHODIMP BrowserProtocol::Seek(LARGE_INTEGER dlibMove,
                                      DWORD dwOrigin,
                                      ULARGE_INTEGER *plibNewPosition) {
-  return E_NOTIMPL;
+  if (!protocol_job_ || !protocol_job_->CanSeek())
+    return E_NOTIMPL;
+  int64_t position = dlibMove.QuadPart;
+  if (dwOrigin == STREAM_SEEK_CUR) {
+    position += position_;
+  } else if (dwOrigin == STREAM_SEEK_END) {
+    if (content_length_ < 0)
+      return E_NOTIMPL;
+    position += content_length_;
+  }
+  if (!protocol_job_->Seek(position))
+    return E_FAIL;
+  position_ = position;
+  if (plibNewPosition)
+    plibNewPosition->QuadPart = position;
+  return S_OK;
 }
 
 IFACEMETHODIMP BrowserProtocol::LockRequest(DWORD dwOptions) {
@@ -78,6 +78,10 @@ class BrowserProtocol : public IInternetProtocol,
   Microsoft::WRL::ComPtr<IInternetProtocolSink> sink_;
   scoped_refptr<ProtocolJob> protocol_job_;
 
+  // Used for seeking.
+  int64_t content_length_ = -1;
+  int64_t position_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(BrowserProtocol);
 };
 
@@ -6,6 +6,8 @@
 
 #include <windows.h>
 
+#include "nativeui/win/util/task_window.h"
+
 namespace nu {
 
 // static
@@ -14,6 +16,9 @@ base::Lock MessageLoop::lock_;
 // static
 std::unordered_map<MessageLoop::TimerId, MessageLoop::Task> MessageLoop::tasks_;
 
+// static
+HWND MessageLoop::task_window_ = NULL;
+
 // static
 void MessageLoop::Run() {
   MSG msg;
@@ -30,11 +35,35 @@ void MessageLoop::Quit() {
 
 // static
 void MessageLoop::PostTask(const std::function<void()>& task) {
-  PostDelayedTask(USER_TIMER_MINIMUM, task);
+  {
+    base::AutoLock auto_lock(lock_);
+    if (task_window_) {
+      auto* copy = new Task(task);
+      if (::PostMessage(task_window_, TaskWindow::kMessage, 0,
+                        reinterpret_cast<LPARAM>(copy)))
+        return;
+      delete copy;
+    }
+  }
+  // There is no GUI thread to post to, run in a timer of current thread.
+  SetTimeout(USER_TIMER_MINIMUM, task);
 }
 
 // static
 void MessageLoop::PostDelayedTask(int ms, const std::function<void()>& task) {
+  HWND task_window;
+  {
+    base::AutoLock auto_lock(lock_);
+    task_window = task_window_;
+  }
+  // Timers only fire on the thread creating them, so create the timer on the
+  // GUI thread.
+  if (task_window &&
+      ::GetWindowThreadProcessId(task_window, nullptr) !=
+          ::GetCurrentThreadId()) {
+    PostTask([ms, task]() { SetTimeout(ms, task); });
+    return;
+  }
   SetTimeout(ms, task);
 }
 
@@ -53,6 +82,12 @@ void MessageLoop::ClearTimeout(TimerId id) {
   tasks_.erase(id);
 }
 
+// static
+void MessageLoop::SetTaskWindow(HWND hwnd) {
+  base::AutoLock auto_lock(lock_);
+  task_window_ = hwnd;
+}
+
 // static
 void CALLBACK MessageLoop::OnTimer(HWND, UINT, UINT_PTR event, DWORD) {
   ::KillTimer(NULL, event);
@@ -20,6 +20,7 @@
 #include "nativeui/win/util/gdiplus_holder.h"
 #include "nativeui/win/util/scoped_ole_initializer.h"
 #include "nativeui/win/util/subwin_holder.h"
+#include "nativeui/win/util/task_window.h"
 #include "nativeui/win/util/tray_host.h"
 #include "third_party/yoga/yoga/Yoga.h"
 
@@ -86,6 +87,9 @@ void State::PlatformInit() {
   ::InitCommonControlsEx(&config);
 
   gdiplus_holder_.reset(new GdiplusHolder);
+
+  // Receive tasks posted from other threads.
+  task_window_.reset(new TaskWindow);
 }
 
 void State::InitializeCOM() {
@@ -215,7 +215,8 @@ LRESULT TableImpl::OnCustomDraw(NMLVCUSTOMDRAW* nm, int row) {
     {
       PainterWin painter(&buffer, scale_factor());
       RectF bounds(ScaleSize(SizeF(rect.size()), 1.f / scale_factor()));
-      options.on_draw(&painter, bounds, value ? value->Clone() : base::Value());
+      base::Value null_value;
+      options.on_draw(&painter, bounds, value ? *value : null_value);
     }
 
     // Copy data back.
@@ -399,4 +400,27 @@ void Table::NotifyValueChange(uint32_t column, uint32_t row) {
   ListView_Update(table->hwnd(), row);
 }
 
+void Table::NotifyRowsInserted(uint32_t start, uint32_t count) {
+  auto* table = static_cast<TableImpl*>(GetNative());
+  ListView_SetItemCountEx(table->hwnd(), GetModel()->GetRowCount(),
+                          LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+}
+
+void Table::NotifyRowsDeleted(uint32_t start, uint32_t count) {
+  auto* table = static_cast<TableImpl*>(GetNative());
+  ListView_SetItemCountEx(table->hwnd(), GetModel()->GetRowCount(),
+                          LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+}
+
+void Table::NotifyRowsChanged(uint32_t start, uint32_t count) {
+  auto* table = static_cast<TableImpl*>(GetNative());
+  ListView_RedrawItems(table->hwnd(), start, start + count - 1);
+}
+
+void Table::NotifyReset() {
+  auto* table = static_cast<TableImpl*>(GetNative());
+  ListView_SetItemCountEx(table->hwnd(), GetModel()->GetRowCount(), 0);
+  ::InvalidateRect(table->hwnd(), nullptr, TRUE);
+}
+
 }  // namespace nu
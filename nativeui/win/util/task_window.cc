@@ -0,0 +1,32 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#include "nativeui/win/util/task_window.h"
+
+#include <memory>
+
+#include "nativeui/message_loop.h"
+
+namespace nu {
+
+TaskWindow::TaskWindow() : Win32Window(L"", HWND_MESSAGE, 0) {
+  MessageLoop::SetTaskWindow(hwnd());
+}
+
+TaskWindow::~TaskWindow() {
+  MessageLoop::SetTaskWindow(NULL);
+}
+
+bool TaskWindow::ProcessWindowMessage(
+    HWND, UINT message, WPARAM w_param, LPARAM l_param, LRESULT* result) {
+  if (message != kMessage)
+    return false;
+  std::unique_ptr<MessageLoop::Task> task(
+      reinterpret_cast<MessageLoop::Task*>(l_param));
+  (*task)();
+  *result = 0;
+  return true;
+}
+
+}  // namespace nu
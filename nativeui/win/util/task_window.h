@@ -0,0 +1,36 @@
+// Copyright 2019 Cheng Zhao. All rights reserved.
+// Use of this source code is governed by the license that can be found in the
+// LICENSE file.
+
+#ifndef NATIVEUI_WIN_UTIL_TASK_WINDOW_H_
+#define NATIVEUI_WIN_UTIL_TASK_WINDOW_H_
+
+#include "nativeui/win/util/win32_window.h"
+
+namespace nu {
+
+// A message-only window running the tasks posted to GUI thread.
+//
+// Timers belong to the thread creating them, so tasks posted from other
+// threads are sent to this window instead.
+class TaskWindow : public Win32Window {
+ public:
+  static const UINT kMessage = WM_APP + 2;
+
+  TaskWindow();
+  ~TaskWindow() override;
+
+ protected:
+  bool ProcessWindowMessage(HWND window,
+                            UINT message,
+                            WPARAM w_param,
+                            LPARAM l_param,
+                            LRESULT* result) override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TaskWindow);
+};
+
+}  // namespace nu
+
+#endif  // NATIVEUI_WIN_UTIL_TASK_WINDOW_H_
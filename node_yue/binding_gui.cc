@@ -252,6 +252,7 @@ struct Type<nu::AttributedText> {
         "setFontFor", &nu::AttributedText::SetFontFor,
         "setColor", &nu::AttributedText::SetColor,
         "setColorFor", &nu::AttributedText::SetColorFor,
+        "setAttributes", &nu::AttributedText::SetAttributes,
         "getSize", &nu::AttributedText::GetSize,
         "getBoundsFor", &nu::AttributedText::GetBoundsFor,
         "getFormat", &nu::AttributedText::GetFormat,
@@ -358,14 +359,28 @@ struct Type<nu::Font::Style> {
   }
 };
 
+template<>
+struct Type<nu::Font::Metrics> {
+  static constexpr const char* name = "yue.Font.Metrics";
+  static v8::Local<v8::Value> ToV8(v8::Local<v8::Context> context,
+                                   const nu::Font::Metrics& metrics) {
+    v8::Local<v8::Object> obj = v8::Object::New(context->GetIsolate());
+    Set(context, obj,
+        "ascent", metrics.ascent,
+        "descent", metrics.descent,
+        "lineHeight", metrics.line_height,
+        "averageCharWidth", metrics.average_char_width);
+    return obj;
+  }
+};
+
 template<>
 struct Type<nu::Font> {
   static constexpr const char* name = "yue.Font";
   static void BuildConstructor(v8::Local<v8::Context> context,
                                v8::Local<v8::Object> constructor) {
     Set(context, constructor,
-        "create", &CreateOnHeap<nu::Font, const std::string&, float,
-                                nu::Font::Weight, nu::Font::Style>,
+        "create", &nu::Font::Get,
         "default", &GetDefault);
   }
   static void BuildPrototype(v8::Local<v8::Context> context,
@@ -375,7 +390,8 @@ struct Type<nu::Font> {
         "getName", &nu::Font::GetName,
         "getSize", &nu::Font::GetSize,
         "getWeight", &nu::Font::GetWeight,
-        "getStyle", &nu::Font::GetStyle);
+        "getStyle", &nu::Font::GetStyle,
+        "getMetrics", &nu::Font::GetMetrics);
   }
   static nu::Font* GetDefault() {
     return nu::System::GetDefaultFont();
@@ -785,6 +801,40 @@ struct Type<nu::TextAttributes> {
   }
 };
 
+template<>
+struct Type<nu::TextRangeAttributes> {
+  static constexpr const char* name = "yue.TextRangeAttributes";
+  static bool FromV8(v8::Local<v8::Context> context,
+                     v8::Local<v8::Value> value,
+                     nu::TextRangeAttributes* out) {
+    if (!value->IsObject())
+      return false;
+    v8::Local<v8::Object> obj = value.As<v8::Object>();
+    Get(context, obj, "start", &out->start);
+    Get(context, obj, "end", &out->end);
+    nu::Font* font;
+    if (Get(context, obj, "font", &font))
+      out->font = font;
+    nu::Color color;
+    if (Get(context, obj, "color", &color))
+      out->color = color;
+    return true;
+  }
+};
+
+template<>
+struct Type<nu::TextMeasurer> {
+  static constexpr const char* name = "yue.TextMeasurer";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "measureBatch", &nu::TextMeasurer::MeasureBatch);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+  }
+};
+
 template<>
 struct Type<nu::Painter> {
   static constexpr const char* name = "yue.Painter";
@@ -1723,6 +1773,23 @@ struct Type<nu::ProtocolStringJob> {
   }
 };
 
+template<>
+struct Type<nu::ProtocolStreamJob> {
+  using base = nu::ProtocolJob;
+  static constexpr const char* name = "yue.ProtocolStreamJob";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "create", &CreateOnHeap<nu::ProtocolStreamJob, const std::string&>);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "write", &nu::ProtocolStreamJob::Write,
+        "finish", &nu::ProtocolStreamJob::Finish);
+  }
+};
+
 template<>
 struct Type<nu::ProtocolFileJob> {
   using base = nu::ProtocolJob;
@@ -1804,7 +1871,13 @@ struct Type<nu::Browser> {
         "setBindingName", &nu::Browser::SetBindingName,
         "addBinding", &AddBinding,
         "addRawBinding", &AddRawBinding,
-        "removeBinding", &RemoveBinding);
+        "removeBinding", &RemoveBinding,
+        "beginUpdateBindings", &nu::Browser::BeginUpdateBindings,
+        "endUpdateBindings", &nu::Browser::EndUpdateBindings,
+        "postMessageToPage", &nu::Browser::PostMessageToPage,
+        "setMessageQueueLimit", &SetMessageQueueLimit,
+        "getMessageQueueLimit", &GetMessageQueueLimit,
+        "getPendingMessageCount", &GetPendingMessageCount);
     SetProperty(context, templ,
                 "onClose", &nu::Browser::on_close,
                 "onUpdateCommand", &nu::Browser::on_update_command,
@@ -1813,7 +1886,10 @@ struct Type<nu::Browser> {
                 "onStartNavigation", &nu::Browser::on_start_navigation,
                 "onCommitNavigation", &nu::Browser::on_commit_navigation,
                 "onFinishNavigation", &nu::Browser::on_finish_navigation,
-                "onFailNavigation", &nu::Browser::on_fail_navigation);
+                "onFailNavigation", &nu::Browser::on_fail_navigation,
+                "onDrainMessages", &nu::Browser::on_drain_messages,
+                "handleMessage", &nu::Browser::handle_message,
+                "handleRequest", &nu::Browser::handle_request);
   }
   static void AddBinding(Arguments* args,
                          const std::string& name,
@@ -1877,6 +1953,15 @@ struct Type<nu::Browser> {
     // Pass down.
     browser->RemoveBinding(name);
   }
+  static void SetMessageQueueLimit(nu::Browser* browser, uint32_t limit) {
+    browser->SetMessageQueueLimit(limit);
+  }
+  static uint32_t GetMessageQueueLimit(nu::Browser* browser) {
+    return static_cast<uint32_t>(browser->GetMessageQueueLimit());
+  }
+  static uint32_t GetPendingMessageCount(nu::Browser* browser) {
+    return static_cast<uint32_t>(browser->GetPendingMessageCount());
+  }
 };
 
 template<>
@@ -2193,7 +2278,11 @@ struct Type<nu::TableModel> {
         "getValue", &nu::TableModel::GetValue,
         "notifyRowInsertion", &nu::TableModel::NotifyRowInsertion,
         "notifyRowDeletion", &nu::TableModel::NotifyRowDeletion,
-        "notifyValueChange", &nu::TableModel::NotifyValueChange);
+        "notifyValueChange", &nu::TableModel::NotifyValueChange,
+        "notifyRowsInserted", &nu::TableModel::NotifyRowsInserted,
+        "notifyRowsDeleted", &nu::TableModel::NotifyRowsDeleted,
+        "notifyRowsChanged", &nu::TableModel::NotifyRowsChanged,
+        "notifyReset", &nu::TableModel::NotifyReset);
   }
 };
 
@@ -2207,10 +2296,13 @@ struct Type<nu::AbstractTableModel> {
   }
   static void BuildPrototype(v8::Local<v8::Context> context,
                              v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "clearCache", &nu::AbstractTableModel::ClearCache);
     SetProperty(context, templ,
                 "getRowCount", &nu::AbstractTableModel::get_row_count,
                 "setValue", &nu::AbstractTableModel::set_value,
-                "getValue", &nu::AbstractTableModel::get_value);
+                "getValue", &nu::AbstractTableModel::get_value,
+                "getRows", &nu::AbstractTableModel::get_rows);
   }
 };
 
@@ -2227,11 +2319,124 @@ struct Type<nu::SimpleTableModel> {
                              v8::Local<v8::ObjectTemplate> templ) {
     Set(context, templ,
         "addRow", &nu::SimpleTableModel::AddRow,
+        "addRows", &nu::SimpleTableModel::AddRows,
         "removeRowAt", &nu::SimpleTableModel::RemoveRowAt,
+        "removeRows", &nu::SimpleTableModel::RemoveRows,
+        "clear", &nu::SimpleTableModel::Clear,
         "setValue", &nu::SimpleTableModel::SetValue);
   }
 };
 
+template<>
+struct Type<nu::ColumnarTableModel::ValueType> {
+  static constexpr const char* name = "yue.ColumnarTableModel.ValueType";
+  static bool FromV8(v8::Local<v8::Context> context,
+                     v8::Local<v8::Value> value,
+                     nu::ColumnarTableModel::ValueType* out) {
+    std::string type;
+    if (!vb::FromV8(context, value, &type))
+      return false;
+    if (type == "integer") {
+      *out = nu::ColumnarTableModel::ValueType::Integer;
+      return true;
+    } else if (type == "double") {
+      *out = nu::ColumnarTableModel::ValueType::Double;
+      return true;
+    } else if (type == "string") {
+      *out = nu::ColumnarTableModel::ValueType::String;
+      return true;
+    } else if (type == "boolean") {
+      *out = nu::ColumnarTableModel::ValueType::Boolean;
+      return true;
+    } else {
+      return false;
+    }
+  }
+};
+
+template<>
+struct Type<nu::ColumnarTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.ColumnarTableModel";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "create", &Create);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "addRow", &nu::ColumnarTableModel::AddRow,
+        "addRows", &nu::ColumnarTableModel::AddRows,
+        "removeRows", &nu::ColumnarTableModel::RemoveRows,
+        "clear", &nu::ColumnarTableModel::Clear,
+        "getMemoryUsage", &GetMemoryUsage,
+        "setValue", &nu::ColumnarTableModel::SetValue);
+  }
+  static nu::ColumnarTableModel* Create(
+      std::vector<nu::ColumnarTableModel::ValueType> types) {
+    return new nu::ColumnarTableModel(std::move(types));
+  }
+  static double GetMemoryUsage(nu::ColumnarTableModel* model) {
+    return static_cast<double>(model->GetMemoryUsage());
+  }
+};
+
+template<>
+struct Type<nu::FileTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.FileTableModel";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "create", &Create);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "open", &nu::FileTableModel::Open,
+        "close", &nu::FileTableModel::Close,
+        "isIndexing", &nu::FileTableModel::IsIndexing,
+        "getHeader", &nu::FileTableModel::GetHeader,
+        "getIndexMemoryUsage", &GetIndexMemoryUsage,
+        "setValue", &nu::FileTableModel::SetValue);
+    SetProperty(context, templ,
+                "onIndexProgress", &nu::FileTableModel::on_index_progress);
+  }
+  static nu::FileTableModel* Create(const std::string& delimiter,
+                                    bool has_header) {
+    return new nu::FileTableModel(delimiter.empty() ? ',' : delimiter[0],
+                                  has_header);
+  }
+  static double GetIndexMemoryUsage(nu::FileTableModel* model) {
+    return static_cast<double>(model->GetIndexMemoryUsage());
+  }
+};
+
+template<>
+struct Type<nu::SortFilterTableModel> {
+  using base = nu::TableModel;
+  static constexpr const char* name = "yue.SortFilterTableModel";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "create", &CreateOnHeap<nu::SortFilterTableModel, nu::TableModel*>);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "getSource", &nu::SortFilterTableModel::GetSource,
+        "sortByColumn", &nu::SortFilterTableModel::SortByColumn,
+        "getSortColumn", &nu::SortFilterTableModel::GetSortColumn,
+        "isSortAscending", &nu::SortFilterTableModel::IsSortAscending,
+        "isSorting", &nu::SortFilterTableModel::IsSorting,
+        "setFilter", &nu::SortFilterTableModel::SetFilter,
+        "mapToSource", &nu::SortFilterTableModel::MapToSource,
+        "mapFromSource", &nu::SortFilterTableModel::MapFromSource,
+        "setValue", &nu::SortFilterTableModel::SetValue);
+  }
+};
+
 template<>
 struct Type<nu::Table::ColumnType> {
   static constexpr const char* name = "yue.Table.ColumnType";
@@ -2271,6 +2476,7 @@ struct Type<nu::Table::ColumnOptions> {
       WeakFunctionFromV8(context, on_draw_val, &out->on_draw);
     Get(context, obj, "column", &out->column);
     Get(context, obj, "width", &out->width);
+    Get(context, obj, "cacheDrawing", &out->cache_drawing);
     return true;
   }
 };
@@ -2301,6 +2507,126 @@ struct Type<nu::Table> {
   }
 };
 
+template<>
+struct Type<nu::TreeModel::Item> {
+  static constexpr const char* name = "yue.TreeModel.Item";
+  static bool FromV8(v8::Local<v8::Context> context,
+                     v8::Local<v8::Value> value,
+                     nu::TreeModel::Item* out) {
+    if (!value->IsObject())
+      return false;
+    auto obj = value.As<v8::Object>();
+    Get(context, obj, "values", &out->values);
+    Get(context, obj, "expandable", &out->expandable);
+    return true;
+  }
+};
+
+template<>
+struct Type<nu::TreeModel> {
+  static constexpr const char* name = "yue.TreeModel";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor,
+        "create", &CreateOnHeap<nu::TreeModel, uint32_t>);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "addNodes", &nu::TreeModel::AddNodes,
+        "addNode", &nu::TreeModel::AddNode,
+        "removeNode", &nu::TreeModel::RemoveNode,
+        "unloadChildren", &nu::TreeModel::UnloadChildren,
+        "clear", &nu::TreeModel::Clear,
+        "loadChildren", &nu::TreeModel::LoadChildren,
+        "isLoaded", &nu::TreeModel::IsLoaded,
+        "isLoading", &nu::TreeModel::IsLoading,
+        "isExpandable", &nu::TreeModel::IsExpandable,
+        "hasNode", &nu::TreeModel::HasNode,
+        "getParent", &nu::TreeModel::GetParent,
+        "getChildCount", &nu::TreeModel::GetChildCount,
+        "getChildAt", &nu::TreeModel::GetChildAt,
+        "getIndex", &nu::TreeModel::GetIndex,
+        "getNodeCount", &GetNodeCount,
+        "getColumnCount", &nu::TreeModel::GetColumnCount,
+        "getValue", &nu::TreeModel::GetValue,
+        "setValue", &nu::TreeModel::SetValue);
+    SetProperty(context, templ,
+                "fetchChildren", &nu::TreeModel::fetch_children);
+  }
+  static double GetNodeCount(nu::TreeModel* model) {
+    return static_cast<double>(model->GetNodeCount());
+  }
+};
+
+#if defined(OS_LINUX)
+template<>
+struct Type<nu::TreeView> {
+  using base = nu::View;
+  static constexpr const char* name = "yue.TreeView";
+  static void BuildConstructor(v8::Local<v8::Context> context,
+                               v8::Local<v8::Object> constructor) {
+    Set(context, constructor, "create", &CreateOnHeap<nu::TreeView>);
+  }
+  static void BuildPrototype(v8::Local<v8::Context> context,
+                             v8::Local<v8::ObjectTemplate> templ) {
+    Set(context, templ,
+        "setModel",
+        RefMethod(&nu::TreeView::SetModel, RefType::Reset, "model"),
+        "getModel", &nu::TreeView::GetModel,
+        "addColumn", &nu::TreeView::AddColumn,
+        "getColumnCount", &nu::TreeView::GetColumnCount,
+        "setColumnsVisible", &nu::TreeView::SetColumnsVisible,
+        "isColumnsVisible", &nu::TreeView::IsColumnsVisible,
+        "setLoadingText", &nu::TreeView::SetLoadingText,
+        "expandNode", &nu::TreeView::ExpandNode,
+        "collapseNode", &nu::TreeView::CollapseNode,
+        "isNodeExpanded", &nu::TreeView::IsNodeExpanded,
+        "selectNode", &nu::TreeView::SelectNode,
+        "getSelectedNode", &nu::TreeView::GetSelectedNode);
+  }
+};
+#endif
+
+#if defined(OS_LINUX)
+template<>
+struct Type<nu::TextEdit::TextChange> {
+  static constexpr const char* name = "yue.TextEdit.TextChange";
+  static v8::Local<v8::Value> ToV8(v8::Local<v8::Context> context,
+                                   const nu::TextEdit::TextChange& change) {
+    v8::Local<v8::Object> obj = v8::Object::New(context->GetIsolate());
+    Set(context, obj,
+        "offset", change.offset,
+        "deletedLength", change.deleted_length,
+        "insertedText", change.inserted_text);
+    return obj;
+  }
+};
+
+template<>
+struct Type<nu::TextEdit::StyledRange> {
+  static constexpr const char* name = "yue.TextEdit.StyledRange";
+  static bool FromV8(v8::Local<v8::Context> context,
+                     v8::Local<v8::Value> value,
+                     nu::TextEdit::StyledRange* out) {
+    if (!value->IsObject())
+      return false;
+    v8::Local<v8::Object> obj = value.As<v8::Object>();
+    Get(context, obj, "start", &out->start);
+    Get(context, obj, "end", &out->end);
+    nu::Font* font;
+    if (Get(context, obj, "font", &font))
+      out->font = font;
+    nu::Color color;
+    if (Get(context, obj, "color", &color))
+      out->color = color;
+    if (Get(context, obj, "background", &color))
+      out->background = color;
+    return true;
+  }
+};
+#endif
+
 template<>
 struct Type<nu::TextEdit> {
   using base = nu::View;
@@ -2318,6 +2644,14 @@ struct Type<nu::TextEdit> {
         "canRedo", &nu::TextEdit::CanRedo,
         "undo", &nu::TextEdit::Undo,
         "canUndo", &nu::TextEdit::CanUndo,
+#if !defined(OS_WIN)
+        "beginUndoGroup", &nu::TextEdit::BeginUndoGroup,
+        "endUndoGroup", &nu::TextEdit::EndUndoGroup,
+#endif
+#if defined(OS_LINUX)
+        "setUndoMemoryLimit", &nu::TextEdit::SetUndoMemoryLimit,
+        "getUndoMemoryUsage", &nu::TextEdit::GetUndoMemoryUsage,
+#endif
         "cut", &nu::TextEdit::Cut,
         "copy", &nu::TextEdit::Copy,
         "paste", &nu::TextEdit::Paste,
@@ -2329,6 +2663,21 @@ struct Type<nu::TextEdit> {
         "insertTextAt", &nu::TextEdit::InsertTextAt,
         "delete", &nu::TextEdit::Delete,
         "deleteRange", &nu::TextEdit::DeleteRange,
+#if defined(OS_LINUX)
+        "getTextLength", &nu::TextEdit::GetTextLength,
+        "getLineCount", &nu::TextEdit::GetLineCount,
+        "getLine", &nu::TextEdit::GetLine,
+        "getLineAtOffset", &nu::TextEdit::GetLineAtOffset,
+        "getLineStartOffset", &nu::TextEdit::GetLineStartOffset,
+        "loadFromFile", &nu::TextEdit::LoadFromFile,
+        "appendChunks", &nu::TextEdit::AppendChunks,
+        "isLoading", &nu::TextEdit::IsLoading,
+        "cancelLoading", &nu::TextEdit::CancelLoading,
+        "getVisibleRange", &nu::TextEdit::GetVisibleRange,
+        "getRevision", &nu::TextEdit::GetRevision,
+        "setStyledRanges", &nu::TextEdit::SetStyledRanges,
+        "setStyledRangesInRange", &nu::TextEdit::SetStyledRangesInRange,
+#endif
 #if !defined(OS_WIN)
         "setOverlayScrollbar", &nu::TextEdit::SetOverlayScrollbar,
 #endif
@@ -2337,6 +2686,11 @@ struct Type<nu::TextEdit> {
     SetProperty(context, templ,
                 "onTextChange", &nu::TextEdit::on_text_change,
                 "shouldInsertNewLine", &nu::TextEdit::should_insert_new_line);
+#if defined(OS_LINUX)
+    SetProperty(context, templ,
+                "onTextEdit", &nu::TextEdit::on_text_edit,
+                "onLoadProgress", &nu::TextEdit::on_load_progress);
+#endif
   }
 };
 
@@ -2516,6 +2870,7 @@ void Initialize(v8::Local<v8::Object> exports) {
           "Container",         vb::Constructor<nu::Container>(),
           "Button",            vb::Constructor<nu::Button>(),
           "ProtocolStringJob", vb::Constructor<nu::ProtocolStringJob>(),
+          "ProtocolStreamJob", vb::Constructor<nu::ProtocolStreamJob>(),
           "ProtocolFileJob",   vb::Constructor<nu::ProtocolFileJob>(),
           "ProtocolAsarJob",   vb::Constructor<nu::ProtocolAsarJob>(),
           "Browser",           vb::Constructor<nu::Browser>(),
@@ -2531,10 +2886,18 @@ void Initialize(v8::Local<v8::Object> exports) {
           "TableModel",        vb::Constructor<nu::TableModel>(),
           "AbstractTableModel", vb::Constructor<nu::AbstractTableModel>(),
           "SimpleTableModel",  vb::Constructor<nu::SimpleTableModel>(),
+          "ColumnarTableModel", vb::Constructor<nu::ColumnarTableModel>(),
+          "FileTableModel",    vb::Constructor<nu::FileTableModel>(),
+          "SortFilterTableModel", vb::Constructor<nu::SortFilterTableModel>(),
           "Tab",               vb::Constructor<nu::Tab>(),
           "Table",             vb::Constructor<nu::Table>(),
           "TextEdit",          vb::Constructor<nu::TextEdit>(),
+          "TextMeasurer",      vb::Constructor<nu::TextMeasurer>(),
           "Tray",              vb::Constructor<nu::Tray>(),
+          "TreeModel",         vb::Constructor<nu::TreeModel>(),
+#if defined(OS_LINUX)
+          "TreeView",          vb::Constructor<nu::TreeView>(),
+#endif
 #if defined(OS_MACOSX)
           "Toolbar",           vb::Constructor<nu::Toolbar>(),
           "Vibrant",           vb::Constructor<nu::Vibrant>(),
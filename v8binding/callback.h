@@ -65,6 +65,13 @@ bool WeakFunctionFromV8(v8::Local<v8::Context> context,
 template<typename ReturnType, typename... ArgTypes>
 struct Type<std::function<ReturnType(ArgTypes...)>> {
   static constexpr const char* name = "Function";
+  static inline v8::Local<v8::Value> ToV8(
+      v8::Local<v8::Context> context,
+      const std::function<ReturnType(ArgTypes...)>& callback) {
+    if (!callback)
+      return v8::Null(context->GetIsolate());
+    return CreateFunctionTemplate(context, callback)->GetFunction();
+  }
   static bool FromV8(v8::Local<v8::Context> context,
                      v8::Local<v8::Value> val,
                      std::function<ReturnType(ArgTypes...)>* out) {